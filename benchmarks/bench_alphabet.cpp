@@ -0,0 +1,40 @@
+#include "benchmark/benchmark.h"
+#include "data/alphabet.hpp"
+
+namespace turing {
+
+static void BM_SplitSingleCharSymbols(benchmark::State& state) {
+  Alphabet alphabet;
+  alphabet.setSymbols({"a", "b", "c"});
+  std::string input;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    input += "abc"[i % 3];
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(alphabet.splitInSymbols(input));
+  }
+
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_SplitSingleCharSymbols)->Arg(1 << 6)->Arg(1 << 14);
+
+// Symbols sharing prefixes, so the longest match must be found
+static void BM_SplitMultiCharSymbols(benchmark::State& state) {
+  Alphabet alphabet;
+  alphabet.setSymbols({"a", "ab", "abc", "X1", "X10", "X100"});
+  const std::vector<std::string> words{"abc", "a", "X100", "ab", "X1", "X10"};
+  std::string input;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    input += words[i % words.size()];
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(alphabet.splitInIds(input));
+  }
+
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_SplitMultiCharSymbols)->Arg(1 << 6)->Arg(1 << 14);
+
+}  // namespace turing
@@ -0,0 +1,124 @@
+#include "benchmark/benchmark.h"
+#include "core/turingbuilder.hpp"
+
+namespace turing {
+
+namespace {
+
+Turing loadMachine(const std::string& file) {
+  Turing machine = TuringBuilder::fromFile(std::string(TURING_SOURCE_DIR) + "/" + file);
+  machine.toggleDebugMode(false);
+
+  return machine;
+}
+
+// Repeat the pattern until the string has "length" characters
+std::string repeat(const std::string& pattern, size_t length) {
+  std::string result;
+  while (result.size() < length) {
+    result += pattern;
+  }
+  result.resize(length);
+
+  return result;
+}
+
+// Run the machine over the input on each iteration. Report the steps of a run.
+void runMachine(benchmark::State& state, const Turing& machine, const std::string& input) {
+  RunResult result;
+  for (auto _ : state) {
+    result = machine.simulate(input);
+    benchmark::DoNotOptimize(result);
+  }
+
+  state.counters["steps"] = result.steps;
+  state.counters["steps_per_second"] =
+      benchmark::Counter(result.steps * state.iterations(), benchmark::Counter::kIsRate);
+  state.SetLabel(to_string(result.verdict));
+}
+
+}  // namespace
+
+// Machines of examples/, on inputs of growing length
+static void BM_Example(benchmark::State& state,
+                       const std::string& file,
+                       const std::string& pattern) {
+  Turing machine = loadMachine(file);
+  runMachine(state, machine, repeat(pattern, state.range(0)));
+}
+BENCHMARK_CAPTURE(BM_Example, Ejemplo_MT, "examples/Ejemplo_MT.txt", "0101")
+    ->Range(1 << 6, 1 << 16);
+BENCHMARK_CAPTURE(BM_Example, problem_1, "examples/problem_1.txt", "abcab")
+    ->Range(1 << 6, 1 << 16);
+BENCHMARK_CAPTURE(BM_Example, problem_2, "examples/problem_2.txt", "0110")
+    ->Range(1 << 6, 1 << 16);
+
+// Busy beavers, starting on a blank tape
+static void BM_BusyBeaver(benchmark::State& state, const std::string& file) {
+  Turing machine = loadMachine(file);
+  runMachine(state, machine, "");
+}
+BENCHMARK_CAPTURE(BM_BusyBeaver, 4_states, "benchmarks/machines/busy_beaver_4.txt");
+BENCHMARK_CAPTURE(BM_BusyBeaver, 5_states, "benchmarks/machines/busy_beaver_5.txt")
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+
+// 5-state busy beaver run on blocks of N cells
+static void BM_BusyBeaverMacro(benchmark::State& state) {
+  Turing machine = loadMachine("benchmarks/machines/busy_beaver_5.txt");
+  machine.setBlockSize(state.range(0));
+  runMachine(state, machine, "");
+}
+BENCHMARK(BM_BusyBeaverMacro)->RangeMultiplier(2)->Range(2, 32)->Unit(benchmark::kMillisecond);
+
+// 5-state busy beaver run on a run-length encoded tape
+static void BM_BusyBeaverRunLength(benchmark::State& state) {
+  Turing machine = loadMachine("benchmarks/machines/busy_beaver_5.txt");
+  machine.toggleRunLengthTape(true);
+  runMachine(state, machine, "");
+}
+BENCHMARK(BM_BusyBeaverRunLength)->Unit(benchmark::kMillisecond);
+
+// Sum of two unary numbers of N digits, step by step and on a run-length encoded tape
+static void BM_UnaryAdder(benchmark::State& state, bool run_length_tape) {
+  Turing machine = loadMachine("benchmarks/machines/unary_adder.txt");
+  machine.toggleRunLengthTape(run_length_tape);
+  std::string digits(state.range(0), '1');
+  runMachine(state, machine, digits + "+" + digits);
+}
+BENCHMARK_CAPTURE(BM_UnaryAdder, cells, false)->Range(1 << 6, 1 << 18);
+BENCHMARK_CAPTURE(BM_UnaryAdder, runs, true)->Range(1 << 6, 1 << 18);
+
+// Sum of two numbers of N bits
+static void BM_BinaryAdder(benchmark::State& state) {
+  Turing machine = loadMachine("benchmarks/machines/binary_adder.txt");
+  std::string input = repeat("1101", state.range(0)) + "+" + repeat("1011", state.range(0));
+  runMachine(state, machine, input);
+}
+BENCHMARK(BM_BinaryAdder)->Range(1 << 6, 1 << 18);
+
+// Copy of N bits to a second track. All the heads move together (See TrackMachine).
+static void BM_TrackCopy(benchmark::State& state) {
+  Turing machine = loadMachine("benchmarks/machines/track_copy.txt");
+  runMachine(state, machine, repeat("0110", state.range(0)));
+}
+BENCHMARK(BM_TrackCopy)->Range(1 << 6, 1 << 18);
+
+// Exploring the whole computation tree of a machine with 2^N branches
+static void BM_Branching(benchmark::State& state, SearchMode mode) {
+  Turing machine = loadMachine("benchmarks/machines/branching.txt");
+  machine.setSearchMode(mode);
+  runMachine(state, machine, std::string(state.range(0), '1'));
+}
+BENCHMARK_CAPTURE(BM_Branching, dfs, SearchMode::DepthFirst)
+    ->DenseRange(8, 16, 4)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Branching, bfs, SearchMode::BreadthFirst)
+    ->DenseRange(8, 16, 4)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Branching, parallel, SearchMode::Parallel)
+    ->DenseRange(8, 16, 4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace turing
@@ -0,0 +1,103 @@
+#include "benchmark/benchmark.h"
+#include "data/tape.hpp"
+
+namespace turing {
+
+namespace {
+
+Alphabet binaryAlphabet() {
+  Alphabet alphabet;
+  alphabet.setSymbols({"0", "1"});
+
+  return alphabet;
+}
+
+}  // namespace
+
+static void BM_TapePeek(benchmark::State& state) {
+  Alphabet alphabet = binaryAlphabet();
+  Tape tape(alphabet);
+  tape.setInputString(std::string(state.range(0), '1'), alphabet);
+
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      benchmark::DoNotOptimize(tape.peekId());
+      tape.move(Move::Right);
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      tape.move(Move::Left);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TapePeek)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_TapeWrite(benchmark::State& state) {
+  Alphabet alphabet = binaryAlphabet();
+  Tape tape(alphabet);
+  SymbolId one = alphabet.id("1");
+
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      tape.writeId(one);
+      tape.move(Move::Right);
+    }
+    tape.reset();
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TapeWrite)->Arg(1 << 10)->Arg(1 << 16);
+
+// Back and forth over a region, like most machines do
+static void BM_TapeSweep(benchmark::State& state) {
+  Alphabet alphabet = binaryAlphabet();
+  Tape tape(alphabet);
+  tape.setInputString(std::string(state.range(0), '0'), alphabet);
+  SymbolId one = alphabet.id("1");
+
+  for (auto _ : state) {
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      tape.writeId(one);
+      tape.move(Move::Right);
+    }
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      tape.move(Move::Left);
+      benchmark::DoNotOptimize(tape.peekId());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_TapeSweep)->Arg(1 << 10)->Arg(1 << 16);
+
+// Copies are shared until written, as done on every branch of a NTM
+static void BM_TapeCopy(benchmark::State& state) {
+  Alphabet alphabet = binaryAlphabet();
+  Tape tape(alphabet);
+  tape.setInputString(std::string(state.range(0), '1'), alphabet);
+  SymbolId zero = alphabet.id("0");
+
+  for (auto _ : state) {
+    Tape copy(tape);
+    copy.writeId(zero);
+    benchmark::DoNotOptimize(copy);
+  }
+}
+BENCHMARK(BM_TapeCopy)->Arg(1 << 10)->Arg(1 << 16);
+
+static void BM_TapeSetInput(benchmark::State& state) {
+  Alphabet alphabet = binaryAlphabet();
+  Tape tape(alphabet);
+  std::string input(state.range(0), '1');
+
+  for (auto _ : state) {
+    tape.setInputString(input, alphabet);
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TapeSetInput)->Arg(1 << 10)->Arg(1 << 16);
+
+}  // namespace turing
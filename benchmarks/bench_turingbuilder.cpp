@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <fstream>
+
+#include "benchmark/benchmark.h"
+#include "core/turingbuilder.hpp"
+
+namespace turing {
+
+static void BM_FromFileExample(benchmark::State& state, const std::string& file) {
+  const std::string path = std::string(TURING_SOURCE_DIR) + "/" + file;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TuringBuilder::fromFile(path));
+  }
+}
+BENCHMARK_CAPTURE(BM_FromFileExample, Ejemplo_MT, "examples/Ejemplo_MT.txt");
+BENCHMARK_CAPTURE(BM_FromFileExample, problem_1, "examples/problem_1.txt");
+BENCHMARK_CAPTURE(BM_FromFileExample, problem_2, "examples/problem_2.txt");
+BENCHMARK_CAPTURE(BM_FromFileExample, binary_adder, "benchmarks/machines/binary_adder.txt");
+
+// Machine with N states and two transitions per state
+static void BM_FromFileGenerated(benchmark::State& state) {
+  const std::string path = "turing_bench_generated.txt";
+  {
+    std::ofstream file(path);
+    file << "1\n";
+    for (int64_t i = 0; i <= state.range(0); ++i) {
+      file << "q" << i << " ";
+    }
+    file << "\n0 1\n0 1 .\nq0\n.\nq" << state.range(0) << "\n";
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      file << "q" << i << " 0 q" << i + 1 << " 1 R\n";
+      file << "q" << i << " 1 q" << i + 1 << " 0 L\n";
+    }
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TuringBuilder::fromFile(path));
+  }
+
+  std::remove(path.c_str());
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_FromFileGenerated)->Arg(1 << 6)->Arg(1 << 12);
+
+}  // namespace turing
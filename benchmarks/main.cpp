@@ -0,0 +1,33 @@
+#include <cstring>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+/*!
+ *  Run the benchmarks. Results are printed as JSON, so they can be stored and compared
+ *  between builds, unless another format is requested with --benchmark_format.
+ */
+int main(int argc, char* argv[]) {
+  std::vector<char*> args(argv, argv + argc);
+
+  char json_format[] = "--benchmark_format=json";
+  bool format_given = false;
+  for (int i = 1; i < argc; ++i) {
+    format_given |= std::strncmp(argv[i], "--benchmark_format", 18) == 0;
+  }
+
+  if (!format_given) {
+    args.insert(args.begin() + 1, json_format);
+  }
+
+  int num_args = args.size();
+  benchmark::Initialize(&num_args, args.data());
+  if (benchmark::ReportUnrecognizedArguments(num_args, args.data())) {
+    return 1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
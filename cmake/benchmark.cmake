@@ -0,0 +1,39 @@
+# use the installed Google Benchmark if found. If not, download and unpack it at
+# configure time, like googletest (see googletest.cmake)
+
+macro(fetch_benchmark _download_module_path _download_root)
+    find_package(benchmark QUIET)
+
+    if(NOT benchmark_FOUND)
+        set(BENCHMARK_DOWNLOAD_ROOT ${_download_root})
+        configure_file(
+            ${_download_module_path}/benchmark-download.cmake
+            ${_download_root}/CMakeLists.txt
+            @ONLY
+            )
+        unset(BENCHMARK_DOWNLOAD_ROOT)
+
+        execute_process(
+            COMMAND
+                "${CMAKE_COMMAND}" -G "${CMAKE_GENERATOR}" .
+            WORKING_DIRECTORY
+                ${_download_root}
+            )
+        execute_process(
+            COMMAND
+                "${CMAKE_COMMAND}" --build .
+            WORKING_DIRECTORY
+                ${_download_root}
+            )
+
+        set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+        set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+        set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+
+        # adds the targets: benchmark, benchmark_main (and the benchmark:: aliases)
+        add_subdirectory(
+            ${_download_root}/benchmark-src
+            ${_download_root}/benchmark-build
+            )
+    endif()
+endmacro()
@@ -0,0 +1,368 @@
+#include "checkpoint.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "core/compiledmachine.hpp"
+#include "data/tapestore.hpp"
+
+namespace turing {
+
+/*!
+ *  \class Checkpoint
+ *  \brief Snapshots of a long search, saved to a file to resume it later.
+ *
+ *  While a run is checkpointed, the search saves a snapshot of its state every
+ *  "interval": the number of steps, the time spent, and the frontier of configurations
+ *  pending to explore (With their states, tapes and heads). The breadth-first search
+ *  also saves the configurations already visited. The snapshot replaces the previous
+ *  one atomically, so the file is always valid even if the process is killed while
+ *  writing it, and it's removed when the run ends.
+ *
+ *  A snapshot belongs to a run: the fingerprint of the machine, the search mode and
+ *  the input. After "load", the run with the same key continues from the snapshot
+ *  instead of from the initial configuration. The budgets can be changed on resume.
+ *  Until that run begins, the loaded snapshot stays on the file: the runs before it
+ *  aren't saved (They start again on the next resume).
+ *
+ *  A checkpoint follows a single run at a time: the machine can't simulate several
+ *  inputs at the same time while it's set.
+ */
+
+std::atomic<bool> Checkpoint::interrupted_{false};
+
+namespace {
+
+// Identifies the checkpoint files (And their version)
+constexpr char file_magic[] = "TURCKPT1";
+
+template <typename T>
+void writeValue(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T readValue(std::istream& is) {
+  T value{};
+  is.read(reinterpret_cast<char*>(&value), sizeof(value));
+  if (!is) {
+    throw std::runtime_error("Truncated checkpoint file.");
+  }
+
+  return value;
+}
+
+template <typename T>
+void writeVector(std::ostream& os, const std::vector<T>& values) {
+  writeValue<std::uint64_t>(os, values.size());
+  os.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+// Number of bytes left to read on the stream
+std::uint64_t bytesLeft(std::istream& is) {
+  const auto position = is.tellg();
+  is.seekg(0, std::ios::end);
+  const auto end = is.tellg();
+  is.seekg(position);
+
+  return (position < 0 || end < position) ? 0 : end - position;
+}
+
+template <typename T>
+std::vector<T> readVector(std::istream& is) {
+  // The size is checked before allocating, so a corrupt one doesn't exhaust the memory
+  auto size = readValue<std::uint64_t>(is);
+  if (size > bytesLeft(is) / sizeof(T)) {
+    throw std::runtime_error("Truncated checkpoint file.");
+  }
+
+  std::vector<T> values(size);
+  is.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+  if (!is) {
+    throw std::runtime_error("Truncated checkpoint file.");
+  }
+
+  return values;
+}
+
+// The pages shared by the tapes of the configurations are stored once (See TapeStore)
+void writeConfiguration(std::ostream& os,
+                        TapeStore& store,
+                        const Configuration& configuration) {
+  writeValue(os, configuration.state);
+  writeValue(os, configuration.depth);
+
+  writeValue<std::uint32_t>(os, configuration.tapes.size());
+  for (const auto& tape : configuration.tapes) {
+    store.write(os, tape);
+  }
+}
+
+// The ids are checked against the machine, so the search can index its tables
+Configuration readConfiguration(std::istream& is,
+                                TapeStore& store,
+                                const CompiledMachine& machine) {
+  Configuration configuration;
+  configuration.state = readValue<StateId>(is);
+  configuration.depth = readValue<std::uint64_t>(is);
+
+  auto num_tapes = readValue<std::uint32_t>(is);
+  if (configuration.state >= machine.numStates() ||
+      num_tapes != static_cast<std::uint32_t>(machine.numTapes())) {
+    throw std::runtime_error("Corrupt checkpoint file: invalid configuration.");
+  }
+
+  for (std::uint32_t i = 0; i < num_tapes; ++i) {
+    configuration.tapes.push_back(store.read(is));
+  }
+
+  return configuration;
+}
+
+}  // namespace
+
+/*!
+ *  Create a checkpoint on the file, saving a snapshot of the run every "interval".
+ */
+Checkpoint::Checkpoint(const std::string& file_path, std::chrono::milliseconds interval)
+    : file_path_(file_path), interval_(interval) {}
+
+/*!
+ *  Return the path of the checkpoint file.
+ */
+const std::string& Checkpoint::path() const {
+  return file_path_;
+}
+
+/*!
+ *  Return the time between snapshots.
+ */
+std::chrono::milliseconds Checkpoint::interval() const {
+  return interval_;
+}
+
+/*!
+ *  Read the snapshot saved on the file, to resume its run on the machine. Does nothing
+ *  if the file doesn't exist. The tapes are built with the alphabet of the machine.
+ *
+ *  !WARNING: Throw if the file isn't a valid checkpoint file, or if its states,
+ *  transitions or symbols aren't on the machine.
+ */
+void Checkpoint::load(const CompiledMachine& machine) {
+  std::ifstream file(file_path_, std::ios::binary);
+  if (!file.is_open()) {
+    return;
+  }
+
+  char magic[sizeof(file_magic)] = {};
+  file.read(magic, sizeof(magic));
+  if (!file || std::memcmp(magic, file_magic, sizeof(magic)) != 0) {
+    throw std::runtime_error("Not a checkpoint file: " + file_path_);
+  }
+
+  RunKey run;
+  run.machine = readValue<std::uint64_t>(file);
+  run.search_mode = static_cast<SearchMode>(readValue<std::uint8_t>(file));
+  run.input = readVector<SymbolId>(file);
+  for (SymbolId id : run.input) {
+    if (id >= machine.numSymbols()) {
+      throw std::runtime_error("Corrupt checkpoint file: invalid symbol.");
+    }
+  }
+
+  Snapshot snapshot;
+  snapshot.steps = readValue<std::uint64_t>(file);
+  snapshot.elapsed = std::chrono::milliseconds(readValue<std::uint64_t>(file));
+  snapshot.pruned = readValue<std::uint8_t>(file);
+
+  TapeStore store(machine.tapeAlphabet());
+
+  auto num_frames = readValue<std::uint64_t>(file);
+  for (std::uint64_t i = 0; i < num_frames; ++i) {
+    Frame frame;
+    frame.configuration = readConfiguration(file, store, machine);
+    frame.first = readValue<TransitionId>(file);
+    frame.next = readValue<TransitionId>(file);
+    frame.last = readValue<TransitionId>(file);
+
+    if (frame.first > frame.next || frame.next > frame.last ||
+        frame.last > machine.numTransitions()) {
+      throw std::runtime_error("Corrupt checkpoint file: invalid transitions.");
+    }
+
+    snapshot.frontier.push_back(std::move(frame));
+  }
+
+  auto num_visited = readValue<std::uint64_t>(file);
+  for (std::uint64_t i = 0; i < num_visited; ++i) {
+    snapshot.visited.push_back(readConfiguration(file, store, machine));
+  }
+
+  resume_run_ = std::move(run);
+  resume_ = std::move(snapshot);
+}
+
+/*!
+ *  Check if a loaded snapshot is waiting for its run.
+ */
+bool Checkpoint::pending() const {
+  return resume_.has_value();
+}
+
+/*!
+ *  Start checkpointing the run of the machine from the tapes. Return the snapshot to
+ *  resume it from, if one was loaded for the same run.
+ */
+std::optional<Checkpoint::Snapshot> Checkpoint::begin(const CompiledMachine& machine,
+                                                      SearchMode search_mode,
+                                                      const std::vector<Tape>& tapes) {
+  run_.machine = machine.fingerprint();
+  run_.search_mode = search_mode;
+  run_.input.clear();
+  for (int i = 0; !tapes[0].empty() && i <= tapes[0].lastWritten(); ++i) {
+    run_.input.push_back(tapes[0].peekId(i));
+  }
+
+  last_save_ = std::chrono::steady_clock::now();
+
+  std::optional<Snapshot> snapshot;
+  if (resume_ && resume_run_ == run_) {
+    snapshot = std::move(resume_);
+    resume_.reset();
+  }
+
+  return snapshot;
+}
+
+/*!
+ *  Check if a snapshot should be saved: the interval has passed since the last one,
+ *  or the process was interrupted.
+ */
+bool Checkpoint::due() const {
+  return interrupted_ || std::chrono::steady_clock::now() - last_save_ >= interval_;
+}
+
+/*!
+ *  Save the snapshot of the current run, replacing the previous one. Nothing is saved
+ *  while a loaded snapshot waits for its run.
+ *
+ *  !WARNING: Throw if the file can't be written. Throw if the process was interrupted,
+ *  once the snapshot is saved, to stop the run.
+ */
+void Checkpoint::save(const Snapshot& snapshot) {
+  // The file keeps the loaded snapshot until its run begins
+  if (resume_) {
+    last_save_ = std::chrono::steady_clock::now();
+
+    if (interrupted_) {
+      throw std::runtime_error("Interrupted. Run kept on checkpoint: " + file_path_);
+    }
+    return;
+  }
+
+  // Written to a temporary file first, so the previous snapshot is kept if it fails
+  const std::string tmp_path = file_path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      throw std::runtime_error("Can't write checkpoint file: " + tmp_path);
+    }
+
+    file.write(file_magic, sizeof(file_magic));
+
+    writeValue(file, run_.machine);
+    writeValue(file, static_cast<std::uint8_t>(run_.search_mode));
+    writeVector(file, run_.input);
+
+    writeValue(file, snapshot.steps);
+    writeValue<std::uint64_t>(file, snapshot.elapsed.count());
+    writeValue<std::uint8_t>(file, snapshot.pruned);
+
+    TapeStore store;
+
+    writeValue<std::uint64_t>(file, snapshot.frontier.size());
+    for (const auto& frame : snapshot.frontier) {
+      writeConfiguration(file, store, frame.configuration);
+      writeValue(file, frame.first);
+      writeValue(file, frame.next);
+      writeValue(file, frame.last);
+    }
+
+    writeValue<std::uint64_t>(file, snapshot.visited.size());
+    for (const auto& configuration : snapshot.visited) {
+      writeConfiguration(file, store, configuration);
+    }
+
+    if (!file.flush()) {
+      throw std::runtime_error("Can't write checkpoint file: " + tmp_path);
+    }
+  }
+
+  if (std::rename(tmp_path.c_str(), file_path_.c_str()) != 0) {
+    throw std::runtime_error("Can't write checkpoint file: " + file_path_);
+  }
+
+  last_save_ = std::chrono::steady_clock::now();
+
+  if (interrupted_) {
+    throw std::runtime_error("Interrupted. Run saved on checkpoint: " + file_path_);
+  }
+}
+
+/*!
+ *  Finish the current run, removing its snapshot. The loaded snapshot of a run that
+ *  didn't begin yet is kept.
+ */
+void Checkpoint::end() {
+  if (!resume_) {
+    std::remove(file_path_.c_str());
+  }
+}
+
+/*!
+ *  Stop between two runs if the process was interrupted. The runs don't check it
+ *  before their first snapshot, so short runs would never stop otherwise.
+ *
+ *  !WARNING: Throw if the process was interrupted.
+ */
+void Checkpoint::stopIfInterrupted() const {
+  if (!interrupted_) {
+    return;
+  }
+
+  if (resume_) {
+    throw std::runtime_error("Interrupted. Run kept on checkpoint: " + file_path_);
+  }
+  throw std::runtime_error("Interrupted.");
+}
+
+/*!
+ *  Request the runs to stop, saving a snapshot on the next check (Runs that end before
+ *  it aren't stopped). Can be called from a signal handler.
+ */
+void Checkpoint::interrupt() {
+  interrupted_ = true;
+}
+
+/*!
+ *  Let the runs continue after "interrupt".
+ */
+void Checkpoint::clearInterrupt() {
+  interrupted_ = false;
+}
+
+/*!
+ *  Check if the runs were requested to stop.
+ */
+bool Checkpoint::interrupted() {
+  return interrupted_;
+}
+
+bool Checkpoint::RunKey::operator==(const RunKey& other) const {
+  return machine == other.machine && search_mode == other.search_mode &&
+         input == other.input;
+}
+
+}  // namespace turing
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/configuration.hpp"
+#include "core/result.hpp"
+#include "data/alphabet.hpp"
+
+namespace turing {
+
+class CompiledMachine;
+
+class Checkpoint {
+public:
+  // Configuration pending to explore, with the range of its transitions
+  struct Frame {
+    Configuration configuration;
+    TransitionId first{0};
+    TransitionId next{0};
+    TransitionId last{0};
+  };
+
+  // State of a search, enough to continue it
+  struct Snapshot {
+    std::uint64_t steps{0};
+    std::chrono::milliseconds elapsed{0};
+    bool pruned{false};
+
+    std::vector<Frame> frontier;
+    std::vector<Configuration> visited;
+  };
+
+public:
+  explicit Checkpoint(const std::string& file_path,
+                      std::chrono::milliseconds interval = std::chrono::minutes(1));
+
+  Checkpoint(const Checkpoint&) = delete;
+  Checkpoint& operator=(const Checkpoint&) = delete;
+
+  const std::string& path() const;
+  std::chrono::milliseconds interval() const;
+
+  void load(const CompiledMachine& machine);
+  bool pending() const;
+
+  std::optional<Snapshot> begin(const CompiledMachine& machine,
+                                SearchMode search_mode,
+                                const std::vector<Tape>& tapes);
+  bool due() const;
+  void save(const Snapshot& snapshot);
+  void end();
+  void stopIfInterrupted() const;
+
+  static void interrupt();
+  static void clearInterrupt();
+  static bool interrupted();
+
+private:
+  // Run the snapshots belong to
+  struct RunKey {
+    std::uint64_t machine{0};
+    SearchMode search_mode{SearchMode::DepthFirst};
+    std::vector<SymbolId> input;
+
+    bool operator==(const RunKey& other) const;
+  };
+
+private:
+  const std::string file_path_;
+  const std::chrono::milliseconds interval_;
+
+  // Run being checkpointed, and time of its last snapshot
+  RunKey run_;
+  std::chrono::steady_clock::time_point last_save_;
+
+  // Snapshot loaded to resume, and the run it belongs to
+  RunKey resume_run_;
+  std::optional<Snapshot> resume_;
+
+  static std::atomic<bool> interrupted_;
+};
+
+}  // namespace turing
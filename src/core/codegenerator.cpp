@@ -0,0 +1,377 @@
+#include "codegenerator.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "core/compiledmachine.hpp"
+#include "core/turing.hpp"
+
+namespace turing {
+
+/*!
+ *  \class CodeGenerator
+ *  \brief Translates a deterministic machine to a standalone C++ source file.
+ *
+ *  Each state becomes a labeled block with a "switch" on the symbols under the heads,
+ *  whose cases write, move and jump to the label of the next state. The tapes are
+ *  contiguous arrays of symbol ids that grow on demand, so a step is a few loads,
+ *  stores and a jump, without looking up any table.
+ *
+ *  The source only depends on the standard library. It exposes:
+ *      extern "C" int turing_run(const char* input,
+ *                                unsigned long long max_steps,
+ *                                unsigned long long* steps);
+ *  which returns 0 (Accepted), 1 (Rejected) or 2 (Undecided, the budget of steps ran
+ *  out), as turing::Verdict. Unless TURING_NO_MAIN is defined, it also has a "main"
+ *  that runs each input and prints its verdict:
+ *      c++ -O2 -o machine machine.cpp
+ *      c++ -O2 -shared -fPIC -DTURING_NO_MAIN -o machine.so machine.cpp
+ *
+ *  Only deterministic machines can be generated, as there's a single computation path
+ *  to follow.
+ */
+
+namespace {
+
+// Code that doesn't depend on the machine: the tapes and the input
+constexpr char prelude[] = R"cpp(#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using SymbolId = std::uint16_t;
+
+// Contiguous tape of symbol ids. Grows on demand in both directions.
+struct Tape {
+  std::vector<SymbolId> cells = std::vector<SymbolId>(64, 0);
+  std::size_t head = 0;
+
+  SymbolId read() const { return cells[head]; }
+  void write(SymbolId symbol) { cells[head] = symbol; }
+
+  void left() {
+    if (head == 0) {
+      std::size_t size = cells.size();
+      cells.insert(cells.begin(), size, 0);
+      head = size;
+    }
+    --head;
+  }
+
+  void right() {
+    if (++head == cells.size()) {
+      cells.resize(cells.size() * 2, 0);
+    }
+  }
+};
+
+struct InputSymbol {
+  const char* symbol;
+  SymbolId id;
+};
+
+)cpp";
+
+constexpr char epilogue[] = R"cpp(
+#ifndef TURING_NO_MAIN
+int main(int argc, char* argv[]) {
+  std::ios::sync_with_stdio(false);
+
+  unsigned long long max_steps = 0;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--max-steps") == 0 && i + 1 < argc) {
+      max_steps = std::stoull(argv[++i]);
+    } else {
+      inputs.push_back(argv[i]);
+    }
+  }
+
+  // Without inputs on the command line, run each line of the standard input
+  if (inputs.empty()) {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+      inputs.push_back(line);
+    }
+  }
+
+  for (const auto& input : inputs) {
+    unsigned long long steps = 0;
+    int verdict = turing_run(input.c_str(), max_steps, &steps);
+
+    std::cout << "Input: " << input << "\n";
+    std::cout << "Recognized: "
+              << ((verdict == 0)   ? "true"
+                  : (verdict == 1) ? "false"
+                                   : "undecided (budget exhausted)")
+              << "\n";
+    std::cout << "Steps: " << steps << "\n\n";
+  }
+
+  return 0;
+}
+#endif
+)cpp";
+
+// Quote the string as a C++ literal
+std::string quote(const std::string& str) {
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+
+  return quoted + "\"";
+}
+
+std::string label(StateId state) {
+  return "state_" + std::to_string(state);
+}
+
+// Text for a comment of the source, without control characters nor backslashes (A
+// backslash at the end of the line would continue the comment on the next one)
+std::string comment(const std::string& str) {
+  std::string result;
+  for (char c : str) {
+    if (static_cast<unsigned char>(c) >= 0x20 && c != '\\') {
+      result += c;
+    }
+  }
+
+  return result;
+}
+
+}  // namespace
+
+/*!
+ *  Prepare the generation of the machine.
+ *
+ *  !WARNING: Throw if the machine isn't deterministic.
+ */
+CodeGenerator::CodeGenerator(const Turing& machine)
+    : machine_(machine), compiled_(machine.compiled()) {
+  if (!compiled_->deterministic()) {
+    throw std::runtime_error(
+        "Only deterministic machines can be translated to C++: there's a "
+        "configuration with more than one transition.");
+  }
+}
+
+/*!
+ *  Write the C++ source of the machine.
+ */
+void CodeGenerator::write(std::ostream& os) const {
+  const CompiledMachine& m = *compiled_;
+
+  os << "// Turing machine translated to C++ by \"turing generate\".\n";
+  os << "// States: " << m.numStates() << ". Transitions: " << m.numTransitions()
+     << ". Tapes: " << m.numTapes() << ".\n\n";
+  os << prelude;
+
+  os << "constexpr int num_tapes = " << m.numTapes() << ";\n\n";
+
+  // Longest symbols first, as the input is split on the longest match
+  std::vector<std::pair<Symbol, SymbolId>> input_symbols;
+  const Alphabet& input_alphabet = machine_.inputAlphabet();
+  for (SymbolId id = 1; id < input_alphabet.numIds(); ++id) {
+    const Symbol& symbol = input_alphabet.symbol(id);
+    if (m.tapeAlphabet().contains(symbol) || symbol == m.tapeAlphabet().blank()) {
+      input_symbols.emplace_back(symbol, m.tapeAlphabet().id(symbol));
+    }
+  }
+  std::stable_sort(input_symbols.begin(),
+                   input_symbols.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.first.size() > b.first.size();
+                   });
+
+  os << "// Symbols of the input alphabet, and their ids on the tape\n";
+  os << "const InputSymbol input_symbols[] = {\n";
+  for (const auto& symbol : input_symbols) {
+    os << "    {" << quote(symbol.first) << ", " << symbol.second << "},\n";
+  }
+  os << "    {nullptr, 0}};\n\n";
+
+  os << R"cpp(// Write the input on the tape, split on symbols. Skip unknown characters.
+void setInput(Tape& tape, const char* input) {
+  while (*input) {
+    const InputSymbol* match = nullptr;
+    for (const InputSymbol* s = input_symbols; s->symbol; ++s) {
+      if (std::strncmp(input, s->symbol, std::strlen(s->symbol)) == 0) {
+        match = s;
+        break;
+      }
+    }
+
+    if (!match) {
+      ++input;
+      continue;
+    }
+
+    tape.write(match->id);
+    tape.right();
+    input += std::strlen(match->symbol);
+  }
+
+  tape.head = 0;
+}
+
+}  // namespace
+
+)cpp";
+
+  writeRun(os);
+  os << epilogue;
+}
+
+/*!
+ *  Write the C++ source of the machine to a file.
+ *
+ *  !WARNING: Throw if the file can't be written.
+ */
+void CodeGenerator::write(const std::string& file_path) const {
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Can't write source file: " + file_path);
+  }
+
+  write(file);
+}
+
+/*!
+ *  Write the function that runs the machine, with a block for each state.
+ */
+void CodeGenerator::writeRun(std::ostream& os) const {
+  const CompiledMachine& m = *compiled_;
+
+  os << R"cpp(extern "C" int turing_run(const char* input,
+                           unsigned long long max_steps,
+                           unsigned long long* steps_done) {
+  Tape tapes[num_tapes];
+  setInput(tapes[0], input);
+
+  const std::uint64_t limit = (max_steps) ? max_steps : UINT64_MAX;
+  std::uint64_t steps = 0;
+  int verdict = 1;
+
+)cpp";
+
+  for (int i = 0; i < m.numTapes(); ++i) {
+    os << "  Tape& t" << i << " = tapes[" << i << "];\n";
+  }
+  os << "\n";
+
+  if (m.initialState() == CompiledMachine::no_state) {
+    os << "  goto reject;\n\n";
+  } else {
+    os << "  goto " << label(m.initialState()) << ";\n\n";
+  }
+
+  // The transitions are laid out by state, so the ones of each state are contiguous
+  TransitionId first = 0;
+  for (StateId state = 0; state < m.numStates(); ++state) {
+    TransitionId last = first;
+    while (last < m.numTransitions() && m.sourceState(last) == state) {
+      ++last;
+    }
+
+    writeState(os, state, first, last);
+    first = last;
+  }
+
+  os << R"cpp(accept:
+  verdict = 0;
+  goto done;
+
+reject:
+  verdict = 1;
+  goto done;
+
+undecided:
+  verdict = 2;
+
+done:
+  if (steps_done) {
+    *steps_done = steps;
+  }
+  return verdict;
+}
+)cpp";
+}
+
+/*!
+ *  Write the block of a state: a switch on the symbols under the heads, with a case
+ *  for each of its transitions [first, last).
+ */
+void CodeGenerator::writeState(std::ostream& os,
+                               StateId state,
+                               TransitionId first,
+                               TransitionId last) const {
+  const CompiledMachine& m = *compiled_;
+
+  os << label(state) << ":  // " << comment(m.stateName(state)) << "\n";
+
+  if (m.isFinal(state)) {
+    os << "  goto accept;\n\n";
+    return;
+  }
+
+  if (first == last) {
+    os << "  goto reject;\n\n";
+    return;
+  }
+
+  // Number the symbols under the heads as the compiled machine does
+  os << "  switch (";
+  for (int i = 1; i < m.numTapes(); ++i) {
+    os << "(";
+  }
+  os << "std::uint64_t(t0.read())";
+  for (int i = 1; i < m.numTapes(); ++i) {
+    os << " * " << m.numSymbols() << " + t" << i << ".read())";
+  }
+  os << ") {\n";
+
+  for (TransitionId t = first; t < last; ++t) {
+    std::vector<SymbolId> read = m.readSymbols(t);
+    const CompiledMachine::Action* actions = m.actions(t);
+
+    std::uint64_t key = 0;
+    for (SymbolId symbol : read) {
+      key = key * m.numSymbols() + symbol;
+    }
+
+    os << "    case " << key << ":  // " << comment(m.transitionName(t)) << "\n";
+    os << "      if (steps == limit) goto undecided;\n";
+    os << "      ++steps;\n";
+
+    for (int i = 0; i < m.numTapes(); ++i) {
+      if (actions[i].write != read[i]) {
+        os << "      t" << i << ".write(" << actions[i].write << ");\n";
+      }
+
+      if (actions[i].move == Move::Left) {
+        os << "      t" << i << ".left();\n";
+      } else if (actions[i].move == Move::Right) {
+        os << "      t" << i << ".right();\n";
+      }
+    }
+
+    os << "      goto " << label(actions[0].next_state) << ";\n";
+  }
+
+  os << "    default:\n";
+  os << "      goto reject;\n";
+  os << "  }\n\n";
+}
+
+}  // namespace turing
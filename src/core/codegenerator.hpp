@@ -0,0 +1,33 @@
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "utils/utils.hpp"
+
+namespace turing {
+
+class CompiledMachine;
+class Turing;
+
+class CodeGenerator {
+public:
+  explicit CodeGenerator(const Turing& machine);
+
+  void write(std::ostream& os) const;
+  void write(const std::string& file_path) const;
+
+private:
+  void writeRun(std::ostream& os) const;
+  void writeState(std::ostream& os,
+                  StateId state,
+                  TransitionId first,
+                  TransitionId last) const;
+
+private:
+  const Turing& machine_;
+  std::shared_ptr<const CompiledMachine> compiled_;
+};
+
+}  // namespace turing
@@ -0,0 +1,472 @@
+#include "compiledmachine.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+#include "core/machineimage.hpp"
+#include "core/turing.hpp"
+#include "state/transition.hpp"
+
+namespace turing {
+
+/*!
+ *  \class CompiledMachine
+ *  \brief Turing machine compiled to flat arrays, used to run it.
+ *
+ *  States are numbered (StateId) and the transitions are laid out contiguously,
+ *  grouped by the configuration that fires them. A configuration (state, symbols
+ *  under each head) is numbered as:
+ *      key = ((state * S + symbol_0) * S + symbol_1) * S + ...
+ *  with S the number of tape symbols. The transitions of the configuration are found
+ *  with an indexed load on a table of offsets, without hashing nor comparing symbols.
+ *
+ *  Each transition is stored as one packed Action (next state, symbol to write and
+ *  move) per Tape.
+ *
+ *  If the table of offsets would be too big (Many states, symbols or tapes), a hash
+ *  table indexed by the same key is used instead.
+ *
+ *  A compiled machine can also be loaded from a MachineImage, without building it
+ *  again. Then, the tables are the ones mapped from the image.
+ *
+ *  !WARNING: The compiled machine must be rebuilt if the Turing machine changes, and
+ *  it's only valid while the Turing machine alive.
+ */
+
+namespace {
+
+// Max number of entries of the dense table of offsets
+constexpr std::uint64_t max_dense_keys = 1 << 22;
+
+// 64-bit FNV-1a hash, fed value by value
+class Fnv1a {
+public:
+  void add(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash_ = (hash_ ^ bytes[i]) * 0x100000001b3ULL;
+    }
+  }
+
+  void add(std::uint64_t value) { add(&value, sizeof(value)); }
+  void add(const std::string& str) {
+    add(str.size());
+    add(str.data(), str.size());
+  }
+
+  std::uint64_t hash() const { return hash_; }
+
+private:
+  std::uint64_t hash_{0xcbf29ce484222325ULL};
+};
+
+}  // namespace
+
+/*!
+ *  Compile the Turing machine.
+ *
+ *  !WARNING: Throw if a transition doesn't have a symbol for each Tape, or if there're
+ *  too many tapes and symbols to number the configurations.
+ */
+CompiledMachine::CompiledMachine(const Turing& machine)
+    : num_tapes_(machine.numTapes()),
+      num_symbols_(machine.tapeAlphabet().numIds()),
+      tape_alphabet_(&machine.tapeAlphabet()) {
+
+  // The states keep the ids given by the machine
+  for (StateId state = 0; state < machine.numStates(); ++state) {
+    state_names_.push_back(machine.stateName(state));
+    final_.push_back(machine.state(state).isFinal());
+  }
+
+  initial_state_ = machine.initialState();
+
+  // Check that all the keys fit on 64 bits
+  std::uint64_t num_keys = std::max<size_t>(state_names_.size(), 1);
+  for (int i = 0; i < num_tapes_; ++i) {
+    if (num_keys > std::numeric_limits<std::uint64_t>::max() / num_symbols_) {
+      throw std::runtime_error("Too many tapes and symbols to compile the machine.");
+    }
+    num_keys *= num_symbols_;
+  }
+
+  // Group the transitions by key, keeping the order in which the states return them.
+  std::map<std::uint64_t, std::vector<const Transition*>> grouped;
+  for (StateId state = 0; state < machine.numStates(); ++state) {
+    for (const auto& t_pair : machine.state(state).transitions()) {
+      const auto& input_symbols = t_pair.first;
+
+      if (input_symbols.size() != static_cast<size_t>(num_tapes_)) {
+        throw std::runtime_error("Transition from " + state_names_[state] + " needs " +
+                                 std::to_string(num_tapes_) + " symbols.");
+      }
+
+      std::uint64_t key = state;
+      for (const auto& id : input_symbols) {
+        key = key * num_symbols_ + id;
+      }
+
+      auto& group = grouped[key];
+      for (const auto& transition : t_pair.second) {
+        group.push_back(&transition);
+      }
+    }
+  }
+
+  // The fingerprint identifies the machine by its structure: symbols, states and
+  // compiled transitions (Not by the names of the states).
+  Fnv1a fingerprint;
+  fingerprint.add(num_tapes_);
+  for (SymbolId id = 0; id < num_symbols_; ++id) {
+    fingerprint.add(tape_alphabet_->symbol(id));
+  }
+  fingerprint.add(state_names_.size());
+  fingerprint.add(initial_state_);
+  for (char final : final_) {
+    fingerprint.add(final);
+  }
+
+  // Lay out the transitions
+  keys_per_state_ = num_keys / std::max<size_t>(state_names_.size(), 1);
+  bool dense = num_keys <= max_dense_keys;
+  if (dense) {
+    offsets_storage_.assign(num_keys + 1, 0);
+  }
+
+  for (const auto& g_pair : grouped) {
+    TransitionId first = sources_.size();
+
+    for (const auto* transition : g_pair.second) {
+      const auto& output_symbols = transition->outputSymbols();
+      const auto& moves = transition->moves();
+
+      if (output_symbols.size() != static_cast<size_t>(num_tapes_)) {
+        throw std::runtime_error("Transition " + to_string(*transition, state_names_) +
+                                 " needs " +
+                                 std::to_string(num_tapes_) + " symbols to write.");
+      }
+
+      for (int i = 0; i < num_tapes_; ++i) {
+        // A single move is done by all the tapes. Missing moves are Stop.
+        Move move = Move::Stop;
+        if (moves.size() == 1) {
+          move = moves[0];
+        } else if (static_cast<size_t>(i) < moves.size()) {
+          move = moves[i];
+        }
+
+        actions_storage_.push_back(
+            {transition->target(), output_symbols[i], move});
+      }
+
+      sources_.push_back(transition);
+      source_states_storage_.push_back(g_pair.first / keys_per_state_);
+    }
+
+    TransitionId last = sources_.size();
+    deterministic_ = deterministic_ && last - first <= 1;
+
+    fingerprint.add(g_pair.first);
+    for (size_t i = first * num_tapes_; i < last * num_tapes_; ++i) {
+      fingerprint.add(actions_storage_[i].next_state);
+      fingerprint.add(actions_storage_[i].write);
+      fingerprint.add(static_cast<std::uint64_t>(actions_storage_[i].move));
+    }
+
+    if (dense) {
+      offsets_storage_[g_pair.first] = first;
+      offsets_storage_[g_pair.first + 1] = last;
+    } else {
+      sparse_[g_pair.first] = {first, last};
+    }
+  }
+
+  // Keys without transitions get an empty range, as the groups are laid out in order
+  for (size_t k = 1; k < offsets_storage_.size(); ++k) {
+    offsets_storage_[k] = std::max(offsets_storage_[k], offsets_storage_[k - 1]);
+  }
+
+  fingerprint_ = fingerprint.hash();
+
+  offsets_ = (dense) ? offsets_storage_.data() : nullptr;
+  num_offsets_ = offsets_storage_.size();
+  actions_ = actions_storage_.data();
+  source_states_ = source_states_storage_.data();
+  num_transitions_ = sources_.size();
+
+  checkMoves();
+}
+
+/*!
+ *  Load the compiled machine from an image. The tables aren't copied: they point to
+ *  the image, which is kept alive while the machine is.
+ */
+CompiledMachine::CompiledMachine(std::shared_ptr<const MachineImage> image)
+    : image_(std::move(image)) {
+  const MachineImage::Header& header = image_->header();
+
+  num_tapes_ = header.num_tapes;
+  num_symbols_ = header.num_symbols;
+  deterministic_ = header.deterministic;
+  fingerprint_ = header.fingerprint;
+  initial_state_ = header.initial_state;
+
+  // The blank symbol is always the first one
+  std::vector<Symbol> symbols = image_->tapeSymbols();
+  if (symbols.size() != num_symbols_ || symbols.empty()) {
+    throw std::runtime_error("Corrupt machine image.");
+  }
+  image_alphabet_.setBlank(symbols[0]);
+  image_alphabet_.setSymbols(std::vector<Symbol>(symbols.begin() + 1, symbols.end()));
+  tape_alphabet_ = &image_alphabet_;
+
+  state_names_ = image_->stateNames();
+  const std::uint8_t* finals = image_->finals();
+  final_.assign(finals, finals + header.num_states);
+
+  for (int i = 0; i < num_tapes_; ++i) {
+    keys_per_state_ *= num_symbols_;
+  }
+
+  offsets_ = image_->offsets();
+  num_offsets_ = header.num_offsets;
+
+  // (The groups were checked by the image)
+  for (std::uint64_t i = 0; i < header.num_groups; ++i) {
+    const MachineImage::Group& group = image_->groups()[i];
+    sparse_[group.key] = {group.first, group.last};
+  }
+
+  actions_ = image_->actions();
+  source_states_ = image_->sourceStates();
+  num_transitions_ = header.num_transitions;
+
+  checkMoves();
+}
+
+/*!
+ *  Return the number of Tapes of the machine.
+ */
+int CompiledMachine::numTapes() const {
+  return num_tapes_;
+}
+
+/*!
+ *  Return the number of states of the machine. StateIds are in [0, numStates()).
+ */
+size_t CompiledMachine::numStates() const {
+  return state_names_.size();
+}
+
+/*!
+ *  Return the number of symbols of the tape alphabet (Including blank).
+ */
+size_t CompiledMachine::numSymbols() const {
+  return num_symbols_;
+}
+
+/*!
+ *  Return the number of transitions. TransitionIds are in [0, numTransitions()).
+ */
+size_t CompiledMachine::numTransitions() const {
+  return num_transitions_;
+}
+
+/*!
+ *  Check if there's at most one transition for each configuration.
+ */
+bool CompiledMachine::deterministic() const {
+  return deterministic_;
+}
+
+/*!
+ *  Check if every transition moves all the heads in the same direction, as
+ *  multi-track machines do (See TrackTape).
+ */
+bool CompiledMachine::uniformMoves() const {
+  return uniform_moves_;
+}
+
+/*!
+ *  Return a hash of the structure of the machine. Machines with the same symbols,
+ *  states and transitions have the same fingerprint, even between executions.
+ */
+std::uint64_t CompiledMachine::fingerprint() const {
+  return fingerprint_;
+}
+
+/*!
+ *  Return the alphabet of the Tapes.
+ */
+const Alphabet& CompiledMachine::tapeAlphabet() const {
+  return *tape_alphabet_;
+}
+
+/*!
+ *  Return the initial state, or "no_state" if the machine doesn't have one.
+ */
+StateId CompiledMachine::initialState() const {
+  return initial_state_;
+}
+
+/*!
+ *  Check if the state is final.
+ */
+bool CompiledMachine::isFinal(StateId state) const {
+  return final_[state];
+}
+
+/*!
+ *  Return the name of the state.
+ */
+const std::string& CompiledMachine::stateName(StateId state) const {
+  return state_names_[state];
+}
+
+/*!
+ *  Return the transitions that can be done from "state" with the symbols under the
+ *  heads of the tapes.
+ */
+CompiledMachine::Range CompiledMachine::transitions(
+    StateId state,
+    const std::vector<Tape>& tapes) const {
+  return transitions(key(state, tapes));
+}
+
+/*!
+ *  Return the transitions that can be done from "state" reading "symbol", for
+ *  single-tape machines.
+ */
+CompiledMachine::Range CompiledMachine::transitions(StateId state, SymbolId symbol) const {
+  return transitions(std::uint64_t(state) * num_symbols_ + symbol);
+}
+
+/*!
+ *  Return the transitions of the configuration numbered "key" (See the description
+ *  of the class). The key of a state and the symbols under the heads is:
+ *      state * keysPerState() + key of the symbols
+ */
+CompiledMachine::Range CompiledMachine::transitions(std::uint64_t key) const {
+  if (offsets_) {
+    return {offsets_[key], offsets_[key + 1]};
+  }
+
+  auto it = sparse_.find(key);
+  return (it != sparse_.end()) ? it->second : Range{0, 0};
+}
+
+/*!
+ *  Return the number of keys of each state: the number of combinations of symbols
+ *  under the heads.
+ */
+std::uint64_t CompiledMachine::keysPerState() const {
+  return keys_per_state_;
+}
+
+/*!
+ *  Return the actions done by the transition (One for each Tape).
+ */
+const CompiledMachine::Action* CompiledMachine::actions(TransitionId transition) const {
+  return &actions_[transition * num_tapes_];
+}
+
+/*!
+ *  Return the Transition from which the compiled transition was built.
+ *
+ *  !WARNING: Throw if the machine was loaded from an image (Use transitionName).
+ */
+const Transition& CompiledMachine::transition(TransitionId transition) const {
+  if (image_) {
+    throw std::runtime_error("The transitions of a machine image aren't available.");
+  }
+
+  return *sources_[transition];
+}
+
+/*!
+ *  Return the description of the transition, as it's printed.
+ */
+std::string CompiledMachine::transitionName(TransitionId transition) const {
+  if (image_) {
+    return std::string(image_->transitionName(transition));
+  }
+
+  return to_string(*sources_[transition], state_names_);
+}
+
+/*!
+ *  Return the state from which the transition is done.
+ */
+StateId CompiledMachine::sourceState(TransitionId transition) const {
+  return source_states_[transition];
+}
+
+/*!
+ *  Return the symbols that must be under the heads to do the transition (One for
+ *  each Tape). Not meant to be used while running: it searches the tables.
+ */
+std::vector<SymbolId> CompiledMachine::readSymbols(TransitionId transition) const {
+  std::uint64_t k = 0;
+
+  if (offsets_) {
+    // The last key whose transitions start at or before this one
+    k = std::upper_bound(offsets_, offsets_ + num_offsets_, transition) - offsets_ - 1;
+  } else {
+    for (const auto& k_pair : sparse_) {
+      if (k_pair.second.first <= transition && transition < k_pair.second.last) {
+        k = k_pair.first;
+        break;
+      }
+    }
+  }
+
+  std::vector<SymbolId> symbols(num_tapes_);
+  for (int i = num_tapes_ - 1; i >= 0; --i) {
+    symbols[i] = k % num_symbols_;
+    k /= num_symbols_;
+  }
+
+  return symbols;
+}
+
+/*!
+ *  Write and move the tapes with the transition, and return the next state.
+ *  The transition must be one of the returned by "transitions" for the tapes.
+ */
+StateId CompiledMachine::apply(TransitionId transition, std::vector<Tape>& tapes) const {
+  const Action* action = actions(transition);
+
+  for (int i = 0; i < num_tapes_; ++i) {
+    tapes[i].writeId(action[i].write);
+    tapes[i].move(action[i].move);
+  }
+
+  return action[0].next_state;
+}
+
+/*!
+ *  Number the configuration formed by the state and the symbols under each head.
+ */
+std::uint64_t CompiledMachine::key(StateId state, const std::vector<Tape>& tapes) const {
+  std::uint64_t k = state;
+  for (const auto& tape : tapes) {
+    k = k * num_symbols_ + tape.peekId();
+  }
+
+  return k;
+}
+
+/*!
+ *  Check if the transitions move all the heads in the same direction.
+ */
+void CompiledMachine::checkMoves() {
+  for (size_t t = 0; t < num_transitions_ && uniform_moves_; ++t) {
+    const Action* action = actions(t);
+    for (int i = 1; i < num_tapes_; ++i) {
+      uniform_moves_ = uniform_moves_ && action[i].move == action[0].move;
+    }
+  }
+}
+
+}  // namespace turing
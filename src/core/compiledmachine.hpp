@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "data/alphabet.hpp"
+#include "data/tape.hpp"
+#include "utils/utils.hpp"
+
+namespace turing {
+
+class MachineImage;
+class Transition;
+class Turing;
+
+class CompiledMachine {
+public:
+  static constexpr StateId no_state = std::numeric_limits<StateId>::max();
+
+  // Symbol written and move done on a single Tape, and state reached
+  struct Action {
+    StateId next_state;
+    SymbolId write;
+    Move move;
+  };
+
+  // Transitions [first, last) available from a configuration
+  struct Range {
+    TransitionId first;
+    TransitionId last;
+
+    bool empty() const { return first == last; }
+    TransitionId size() const { return last - first; }
+  };
+
+public:
+  explicit CompiledMachine(const Turing& machine);
+  explicit CompiledMachine(std::shared_ptr<const MachineImage> image);
+
+  int numTapes() const;
+  size_t numStates() const;
+  size_t numSymbols() const;
+  size_t numTransitions() const;
+  bool deterministic() const;
+  bool uniformMoves() const;
+  std::uint64_t fingerprint() const;
+
+  const Alphabet& tapeAlphabet() const;
+
+  StateId initialState() const;
+  bool isFinal(StateId state) const;
+  const std::string& stateName(StateId state) const;
+
+  Range transitions(StateId state, const std::vector<Tape>& tapes) const;
+  Range transitions(StateId state, SymbolId symbol) const;
+  Range transitions(std::uint64_t key) const;
+  std::uint64_t keysPerState() const;
+  const Action* actions(TransitionId transition) const;
+  const Transition& transition(TransitionId transition) const;
+  std::string transitionName(TransitionId transition) const;
+  StateId sourceState(TransitionId transition) const;
+  std::vector<SymbolId> readSymbols(TransitionId transition) const;
+
+  StateId apply(TransitionId transition, std::vector<Tape>& tapes) const;
+
+private:
+  std::uint64_t key(StateId state, const std::vector<Tape>& tapes) const;
+  void checkMoves();
+
+  friend class MachineImage;
+
+private:
+  int num_tapes_{1};
+  size_t num_symbols_{1};
+  bool deterministic_{true};
+  bool uniform_moves_{true};
+  std::uint64_t fingerprint_{0};
+  std::uint64_t keys_per_state_{1};
+
+  const Alphabet* tape_alphabet_{nullptr};
+  Alphabet image_alphabet_;
+
+  StateId initial_state_{no_state};
+  std::vector<std::string> state_names_;
+  std::vector<char> final_;
+
+  // The transitions of a configuration with key "k" are [offsets_[k], offsets_[k+1]).
+  // If the table would be too big, sparse_ is used instead (And offsets_ is null).
+  const TransitionId* offsets_{nullptr};
+  size_t num_offsets_{0};
+  std::unordered_map<std::uint64_t, Range> sparse_;
+
+  // The transition "t" does actions_[t * num_tapes_ + i] on the Tape i
+  const Action* actions_{nullptr};
+  const StateId* source_states_{nullptr};
+  size_t num_transitions_{0};
+
+  // Storage of the tables when compiled from a Turing machine. When loaded from an
+  // image, the tables point to it instead (And there aren't source Transitions).
+  std::vector<TransitionId> offsets_storage_;
+  std::vector<Action> actions_storage_;
+  std::vector<StateId> source_states_storage_;
+  std::vector<const Transition*> sources_;
+
+  std::shared_ptr<const MachineImage> image_;
+};
+
+}  // namespace turing
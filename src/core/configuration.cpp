@@ -0,0 +1,47 @@
+#include "configuration.hpp"
+
+namespace turing {
+
+/*!
+ *  \class Configuration
+ *  \brief Snapshot of a computation: current state, tapes and heads.
+ *
+ *  "depth" is the number of steps done to reach the configuration. It isn't part of
+ *  the configuration identity.
+ */
+
+/*!
+ *  Hash of the state and the tapes.
+ *  Equal configurations have the same hash.
+ */
+size_t Configuration::hash() const {
+  size_t seed = std::hash<StateId>()(state);
+
+  for (const auto& tape : tapes) {
+    seed ^= tape.hash() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+
+  return seed;
+}
+
+/*!
+ *  Check if two configurations are equal.
+ *  Note: For two configurations to be equal, they must be on the same state and their
+ *  tapes must have the same symbols around each head. From there, the Turing machine
+ *  behaves exactly the same.
+ */
+bool Configuration::operator==(const Configuration& other) const {
+  if (state != other.state || tapes.size() != other.tapes.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < tapes.size(); ++i) {
+    if (!tapes[i].equivalent(other.tapes[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace turing
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "data/tape.hpp"
+#include "utils/utils.hpp"
+
+namespace turing {
+
+struct Configuration {
+  StateId state{0};
+  std::vector<Tape> tapes;
+  std::uint64_t depth{0};
+
+  size_t hash() const;
+  bool operator==(const Configuration& other) const;
+};
+
+}  // namespace turing
+
+/*!
+ *  Hash function. Used to insert Configuration elements on an "unordered_set"
+ */
+namespace std {
+template <>
+struct hash<turing::Configuration> {
+  size_t operator()(const turing::Configuration& obj) const { return obj.hash(); }
+};
+
+}  // namespace std
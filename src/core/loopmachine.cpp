@@ -0,0 +1,242 @@
+#include "loopmachine.hpp"
+
+#include <chrono>
+
+namespace turing {
+
+/*!
+ *  \class LoopMachine
+ *  \brief Run a deterministic machine, proving when it loops forever.
+ *
+ *  The configuration (State, heads and cells) has a Zobrist hash: the XOR of a random
+ *  key for the state, for the position of each head, and for each symbol on each
+ *  cell (Blank cells have the key 0). A step only changes the state, one cell and
+ *  one head of each tape, so the hash is updated in O(1).
+ *
+ *  Brent's algorithm looks for a repeated configuration: the run keeps a saved
+ *  configuration, moved to the current one after 1, 2, 4, 8... steps, and compares
+ *  each new configuration to it. The hashes are compared first, and the whole
+ *  configurations only if they match, so a repetition is exact. A deterministic
+ *  machine that repeats a configuration repeats it forever, so the run is Rejected
+ *  with its cycle: the first step of the cycle, and its length. The first step is
+ *  found running the machine again from the start.
+ *
+ *  Runs that never repeat a configuration (p.e. moving right forever) run until a
+ *  budget is exhausted.
+ *
+ *  Only deterministic machines are supported (See "supports").
+ */
+
+namespace {
+
+// Salts of the keys of each part of the configuration
+constexpr std::uint64_t cell_salt = 0x243f6a8885a308d3ULL;
+constexpr std::uint64_t head_salt = 0x13198a2e03707344ULL;
+constexpr std::uint64_t state_salt = 0xa4093822299f31d0ULL;
+
+/*!
+ *  Mix the bits of the value (Finalizer of splitmix64). Used to compute the Zobrist
+ *  keys on demand, as the tapes are unbounded.
+ */
+std::uint64_t mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+std::uint64_t cellKey(int tape, int position, SymbolId id) {
+  if (id == Alphabet::blank_id) {
+    return 0;
+  }
+
+  return mix(cell_salt ^ (std::uint64_t(tape) << 48) ^
+             (std::uint64_t(std::uint32_t(position)) << 16) ^ id);
+}
+
+std::uint64_t headKey(int tape, int position) {
+  return mix(head_salt ^ (std::uint64_t(tape) << 32) ^ std::uint32_t(position));
+}
+
+std::uint64_t stateKey(StateId state) {
+  return mix(state_salt ^ state);
+}
+
+// Configuration of a deterministic run, with its Zobrist hash
+class Run {
+public:
+  Run(const CompiledMachine& machine, const std::vector<Tape>& tapes)
+      : machine_(&machine), state_(machine.initialState()), tapes_(tapes) {
+    hash_ = stateKey(state_);
+
+    for (int i = 0; i < static_cast<int>(tapes_.size()); ++i) {
+      const Tape& tape = tapes_[i];
+      hash_ ^= headKey(i, tape.head());
+
+      for (int pos = tape.firstWritten(); !tape.empty() && pos <= tape.lastWritten();
+           ++pos) {
+        hash_ ^= cellKey(i, pos, tape.peekId(pos));
+      }
+    }
+  }
+
+  StateId state() const { return state_; }
+  const std::vector<Tape>& tapes() const { return tapes_; }
+  std::vector<Tape>& tapes() { return tapes_; }
+
+  // Transitions from the configuration
+  CompiledMachine::Range transitions() const {
+    return machine_->transitions(state_, tapes_);
+  }
+
+  // Apply the transition, as CompiledMachine::apply, updating the hash
+  void step(TransitionId transition) {
+    const CompiledMachine::Action* actions = machine_->actions(transition);
+
+    for (int i = 0; i < static_cast<int>(tapes_.size()); ++i) {
+      Tape& tape = tapes_[i];
+      const int pos = tape.head();
+
+      hash_ ^= cellKey(i, pos, tape.peekId()) ^ cellKey(i, pos, actions[i].write) ^
+               headKey(i, pos);
+
+      tape.writeId(actions[i].write);
+      tape.move(actions[i].move);
+
+      hash_ ^= headKey(i, tape.head());
+    }
+
+    hash_ ^= stateKey(state_) ^ stateKey(actions[0].next_state);
+    state_ = actions[0].next_state;
+  }
+
+  // Check if both configurations are the same: same hash, state, heads and cells
+  bool same(const Run& other) const {
+    if (hash_ != other.hash_ || state_ != other.state_) {
+      return false;
+    }
+
+    for (size_t i = 0; i < tapes_.size(); ++i) {
+      if (tapes_[i].head() != other.tapes_[i].head() ||
+          !tapes_[i].equivalent(other.tapes_[i])) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  const CompiledMachine* machine_;
+
+  StateId state_;
+  std::vector<Tape> tapes_;
+  std::uint64_t hash_{0};
+};
+
+}  // namespace
+
+/*!
+ *  Prepare to run the machine.
+ */
+LoopMachine::LoopMachine(const CompiledMachine& machine) : machine_(machine) {}
+
+/*!
+ *  Check if the machine loops can be detected.
+ */
+bool LoopMachine::supports(const CompiledMachine& machine) {
+  return machine.deterministic();
+}
+
+/*!
+ *  Run the machine from the initial state and the given tapes.
+ */
+RunResult LoopMachine::run(const std::vector<Tape>& tapes, const Limits& limits) const {
+  RunResult result;
+  result.tapes = tapes;
+
+  if (machine_.initialState() == CompiledMachine::no_state) {
+    return result;
+  }
+
+  const std::uint64_t max_steps = limits.deterministicSteps();
+
+  const auto start_time = std::chrono::steady_clock::now();
+
+  Run current(machine_, tapes);
+  Run saved = current;
+
+  // Steps since the configuration was saved, and steps until it's saved again
+  std::uint64_t length = 0;
+  std::uint64_t power = 1;
+
+  while (!machine_.isFinal(current.state())) {
+    auto range = current.transitions();
+    if (range.empty()) {
+      result.verdict = Verdict::Rejected;
+      return result;
+    }
+
+    if (result.steps == max_steps) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    if (limits.max_time.count() && (result.steps % 1024) == 0 &&
+        std::chrono::steady_clock::now() - start_time >= limits.max_time) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    current.step(range.first);
+    ++result.steps;
+    ++length;
+
+    if (current.same(saved)) {
+      result.verdict = Verdict::Rejected;
+      result.cycle = Cycle{cycleStart(tapes, length), length};
+      return result;
+    }
+
+    if (length == power) {
+      saved = current;
+      power *= 2;
+      length = 0;
+    }
+  }
+
+  result.tapes = std::move(current.tapes());
+
+  result.verdict = Verdict::Accepted;
+  result.depth = result.steps;
+  return result;
+}
+
+/*!
+ *  Return the first step of the cycle of the given length, running the machine from
+ *  the start twice: the second run "length" steps ahead of the first one, until both
+ *  are on the same configuration.
+ */
+std::uint64_t LoopMachine::cycleStart(const std::vector<Tape>& tapes,
+                                      std::uint64_t length) const {
+  Run first(machine_, tapes);
+  Run second(machine_, tapes);
+
+  // The run doesn't halt, so there is always a transition
+  for (std::uint64_t i = 0; i < length; ++i) {
+    second.step(second.transitions().first);
+  }
+
+  std::uint64_t start = 0;
+  while (!first.same(second)) {
+    first.step(first.transitions().first);
+    second.step(second.transitions().first);
+    ++start;
+  }
+
+  return start;
+}
+
+}  // namespace turing
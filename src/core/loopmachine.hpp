@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/compiledmachine.hpp"
+#include "core/result.hpp"
+
+namespace turing {
+
+class LoopMachine {
+public:
+  explicit LoopMachine(const CompiledMachine& machine);
+
+  static bool supports(const CompiledMachine& machine);
+
+  RunResult run(const std::vector<Tape>& tapes, const Limits& limits) const;
+
+private:
+  std::uint64_t cycleStart(const std::vector<Tape>& tapes, std::uint64_t length) const;
+
+private:
+  const CompiledMachine& machine_;
+};
+
+}  // namespace turing
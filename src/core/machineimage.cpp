@@ -0,0 +1,460 @@
+#include "machineimage.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <fstream>
+#include <stdexcept>
+
+#include "core/turing.hpp"
+
+namespace turing {
+
+/*!
+ *  \class MachineImage
+ *  \brief Binary image of a compiled machine, mapped on memory to run it.
+ *
+ *  The image stores the tables of the CompiledMachine as they are laid out on memory
+ *  (Interned symbols, numbered states and the flat table of transitions), so loading
+ *  a machine doesn't parse nor build anything: the file is mapped, checked, and the
+ *  CompiledMachine points directly to its tables.
+ *
+ *  The file is a Header followed by its sections, each one aligned to 8 bytes. Lists
+ *  of strings are stored as their number, the end offset of each string, and the
+ *  characters. Images are only valid on machines with the same byte order and layout
+ *  of CompiledMachine::Action, and the version must match the one of the program.
+ */
+
+namespace {
+
+// Identifies the image files
+constexpr char image_magic[8] = {'T', 'U', 'R', 'I', 'N', 'G', 'M', 'I'};
+
+// Written in native byte order. Read back different if the byte order changes.
+constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+constexpr size_t section_alignment = 8;
+
+static_assert(sizeof(MachineImage::Header) % section_alignment == 0,
+              "Sections must start aligned");
+
+// Contents of the image, appended section by section
+class ImageBuffer {
+public:
+  ImageBuffer() : data_(sizeof(MachineImage::Header), '\0') {}
+
+  MachineImage::Section add(const void* data, size_t size) {
+    data_.resize((data_.size() + section_alignment - 1) & ~(section_alignment - 1),
+                 '\0');
+
+    MachineImage::Section section{data_.size(), size};
+    data_.append(static_cast<const char*>(data), size);
+
+    return section;
+  }
+
+  template <typename T>
+  MachineImage::Section add(const std::vector<T>& values) {
+    return add(values.data(), values.size() * sizeof(T));
+  }
+
+  MachineImage::Section addStrings(const std::vector<std::string>& strings) {
+    std::vector<std::uint64_t> table{strings.size()};
+    std::string chars;
+    for (const auto& str : strings) {
+      chars += str;
+      table.push_back(chars.size());
+    }
+
+    MachineImage::Section section = add(table);
+    section.size += add(chars.data(), chars.size()).size;
+
+    return section;
+  }
+
+  void setHeader(const MachineImage::Header& header) {
+    std::memcpy(&data_[0], &header, sizeof(header));
+  }
+
+  const std::string& data() const { return data_; }
+
+private:
+  std::string data_;
+};
+
+}  // namespace
+
+/*!
+ *  Compile the Turing machine, and write its image to a file.
+ *
+ *  !WARNING: Throw if the machine can't be compiled, or the file can't be written.
+ */
+void MachineImage::write(const Turing& machine, const std::string& file_path) {
+  auto compiled = machine.compiled();
+  const CompiledMachine& m = *compiled;
+
+  ImageBuffer buffer;
+
+  Header header{};
+  std::memcpy(header.magic, image_magic, sizeof(image_magic));
+  header.version = version;
+  header.byte_order = byte_order_mark;
+  header.action_size = sizeof(CompiledMachine::Action);
+  header.num_tapes = m.numTapes();
+  header.fingerprint = m.fingerprint();
+  header.num_symbols = m.numSymbols();
+  header.num_states = m.numStates();
+  header.num_transitions = m.numTransitions();
+  header.initial_state = m.initialState();
+  header.deterministic = m.deterministic();
+
+  std::vector<std::string> tape_symbols;
+  for (SymbolId id = 0; id < m.numSymbols(); ++id) {
+    tape_symbols.push_back(m.tapeAlphabet().symbol(id));
+  }
+  header.tape_symbols = buffer.addStrings(tape_symbols);
+
+  // The blank symbol of the input alphabet isn't part of it
+  std::vector<std::string> input_symbols;
+  for (SymbolId id = 1; id < machine.inputAlphabet().numIds(); ++id) {
+    input_symbols.push_back(machine.inputAlphabet().symbol(id));
+  }
+  header.input_symbols = buffer.addStrings(input_symbols);
+
+  header.state_names = buffer.addStrings(m.state_names_);
+
+  std::vector<std::string> transition_names;
+  for (TransitionId t = 0; t < m.numTransitions(); ++t) {
+    transition_names.push_back(m.transitionName(t));
+  }
+  header.transition_names = buffer.addStrings(transition_names);
+
+  header.finals = buffer.add(m.final_);
+
+  if (m.offsets_) {
+    header.num_offsets = m.num_offsets_;
+    header.offsets = buffer.add(m.offsets_, m.num_offsets_ * sizeof(TransitionId));
+  } else {
+    std::vector<Group> groups;
+    for (const auto& k_pair : m.sparse_) {
+      groups.push_back({k_pair.first, k_pair.second.first, k_pair.second.last});
+    }
+
+    header.num_groups = groups.size();
+    header.groups = buffer.add(groups);
+  }
+
+  // Copied field by field, so the padding bytes are always zero
+  std::vector<CompiledMachine::Action> actions(m.numTransitions() * m.numTapes());
+  std::memset(actions.data(), 0, actions.size() * sizeof(CompiledMachine::Action));
+  for (size_t i = 0; i < actions.size(); ++i) {
+    actions[i].next_state = m.actions_[i].next_state;
+    actions[i].write = m.actions_[i].write;
+    actions[i].move = m.actions_[i].move;
+  }
+  header.actions = buffer.add(actions);
+
+  header.source_states =
+      buffer.add(m.source_states_, m.numTransitions() * sizeof(StateId));
+
+  buffer.setHeader(header);
+
+  std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+  file.write(buffer.data().data(), buffer.data().size());
+  if (!file) {
+    throw std::runtime_error("Can't write machine image: " + file_path);
+  }
+}
+
+/*!
+ *  Check if the file is a machine image (By its first bytes).
+ */
+bool MachineImage::isImage(const std::string& file_path) {
+  std::ifstream file(file_path, std::ios::binary);
+
+  char magic[sizeof(image_magic)] = {};
+  file.read(magic, sizeof(magic));
+
+  return file && std::memcmp(magic, image_magic, sizeof(image_magic)) == 0;
+}
+
+/*!
+ *  Map the image on memory, and check that it's valid.
+ *
+ *  !WARNING: Throw if the file can't be mapped, or if it isn't a valid image for this
+ *  version of the program.
+ */
+MachineImage::MachineImage(const std::string& file_path) {
+  int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Can't read machine image: " + file_path);
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) < 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(Header)) {
+    ::close(fd);
+    throw std::runtime_error("Not a machine image: " + file_path);
+  }
+
+  size_ = file_stat.st_size;
+  void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("Can't map machine image: " + file_path);
+  }
+  data_ = static_cast<const char*>(data);
+
+  try {
+    const Header& h = header();
+    if (std::memcmp(h.magic, image_magic, sizeof(image_magic)) != 0) {
+      throw std::runtime_error("Not a machine image: " + file_path);
+    }
+
+    if (h.version != version || h.byte_order != byte_order_mark ||
+        h.action_size != sizeof(CompiledMachine::Action)) {
+      throw std::runtime_error("Machine image built by an incompatible version: " +
+                               file_path + ". Compile the machine again.");
+    }
+
+    if (h.num_tapes < 1) {
+      throw std::runtime_error("Corrupt machine image: " + file_path);
+    }
+
+    // Check that all the sections are inside the file
+    checkStrings(h.tape_symbols);
+    checkStrings(h.input_symbols);
+    checkStrings(h.state_names);
+    checkStrings(h.transition_names);
+    finals();
+    offsets();
+    groups();
+    actions();
+    sourceStates();
+
+    // Check that the sizes agree with each other, so the tables are indexed in bounds
+    auto corrupt = [&file_path] {
+      throw std::runtime_error("Corrupt machine image: " + file_path);
+    };
+    auto count = [this](const Section& strings) {
+      return *reinterpret_cast<const std::uint64_t*>(data_ + strings.offset);
+    };
+
+    if (h.num_symbols < 1 || h.num_symbols > std::numeric_limits<SymbolId>::max() ||
+        h.num_states > std::numeric_limits<StateId>::max() ||
+        h.num_transitions > std::numeric_limits<TransitionId>::max() ||
+        count(h.tape_symbols) != h.num_symbols ||
+        count(h.state_names) != h.num_states ||
+        count(h.transition_names) != h.num_transitions) {
+      corrupt();
+    }
+
+    if (h.initial_state >= h.num_states &&
+        h.initial_state != CompiledMachine::no_state) {
+      corrupt();
+    }
+
+    // All the keys fit on 64 bits (See CompiledMachine)
+    std::uint64_t num_keys = std::max<std::uint64_t>(h.num_states, 1);
+    for (int i = 0; i < h.num_tapes; ++i) {
+      if (num_keys > std::numeric_limits<std::uint64_t>::max() / h.num_symbols) {
+        corrupt();
+      }
+      num_keys *= h.num_symbols;
+    }
+
+    // The dense table has an offset for each key, and the end of the last one
+    if (h.num_offsets && (h.num_offsets - 1 != num_keys || offsets()[0] != 0 ||
+                          offsets()[num_keys] != h.num_transitions)) {
+      corrupt();
+    }
+
+    // Check the tables once here, so the runs can index them without checks
+    for (std::uint64_t k = 0; k < num_keys && h.num_offsets; ++k) {
+      if (offsets()[k] > offsets()[k + 1]) {
+        corrupt();
+      }
+    }
+
+    for (std::uint64_t i = 0; i < h.num_groups; ++i) {
+      const Group& group = groups()[i];
+      if (group.key >= num_keys || group.first > group.last ||
+          group.last > h.num_transitions) {
+        corrupt();
+      }
+    }
+
+    for (std::uint64_t i = 0; i < h.num_transitions * h.num_tapes; ++i) {
+      const CompiledMachine::Action& action = actions()[i];
+      if (action.next_state >= h.num_states || action.write >= h.num_symbols ||
+          static_cast<std::uint8_t>(action.move) >
+              static_cast<std::uint8_t>(Move::Stop)) {
+        corrupt();
+      }
+    }
+
+    for (std::uint64_t t = 0; t < h.num_transitions; ++t) {
+      if (sourceStates()[t] >= h.num_states) {
+        corrupt();
+      }
+    }
+
+  } catch (...) {
+    ::munmap(const_cast<char*>(data_), size_);
+    throw;
+  }
+}
+
+/*!
+ *  Unmap the image.
+ */
+MachineImage::~MachineImage() {
+  ::munmap(const_cast<char*>(data_), size_);
+}
+
+/*!
+ *  Return the header of the image, with the sizes of the machine.
+ */
+const MachineImage::Header& MachineImage::header() const {
+  return *reinterpret_cast<const Header*>(data_);
+}
+
+/*!
+ *  Return the symbols of the tape alphabet, by SymbolId. The first one is blank.
+ */
+std::vector<Symbol> MachineImage::tapeSymbols() const {
+  return strings(header().tape_symbols);
+}
+
+/*!
+ *  Return the symbols of the input alphabet.
+ */
+std::vector<Symbol> MachineImage::inputSymbols() const {
+  return strings(header().input_symbols);
+}
+
+/*!
+ *  Return the names of the states, by StateId.
+ */
+std::vector<std::string> MachineImage::stateNames() const {
+  return strings(header().state_names);
+}
+
+/*!
+ *  Return the description of the transition, without copying it.
+ */
+std::string_view MachineImage::transitionName(TransitionId transition) const {
+  const Section& s = header().transition_names;
+  const auto* table = reinterpret_cast<const std::uint64_t*>(data_ + s.offset);
+  const char* chars = data_ + s.offset + (table[0] + 1) * sizeof(std::uint64_t);
+
+  std::uint64_t first = (transition) ? table[transition] : 0;
+  return {chars + first, table[transition + 1] - first};
+}
+
+/*!
+ *  Return if each state is final, by StateId.
+ */
+const std::uint8_t* MachineImage::finals() const {
+  return section<std::uint8_t>(header().finals, header().num_states);
+}
+
+/*!
+ *  Return the dense table of offsets, or null if the machine uses groups.
+ */
+const TransitionId* MachineImage::offsets() const {
+  return section<TransitionId>(header().offsets, header().num_offsets);
+}
+
+/*!
+ *  Return the configurations with transitions, if the machine doesn't have a dense
+ *  table of offsets.
+ */
+const MachineImage::Group* MachineImage::groups() const {
+  return section<Group>(header().groups, header().num_groups);
+}
+
+/*!
+ *  Return the actions of the transitions (One for each Tape).
+ */
+const CompiledMachine::Action* MachineImage::actions() const {
+  return section<CompiledMachine::Action>(
+      header().actions, header().num_transitions * header().num_tapes);
+}
+
+/*!
+ *  Return the state from which each transition is done.
+ */
+const StateId* MachineImage::sourceStates() const {
+  return section<StateId>(header().source_states, header().num_transitions);
+}
+
+/*!
+ *  Return the section as an array of "count" elements. Null if it's empty.
+ *
+ *  !WARNING: Throw if the section isn't inside the image, or has a different size.
+ */
+template <typename T>
+const T* MachineImage::section(const Section& section, std::uint64_t count) const {
+  if (section.offset % alignof(T) != 0 || section.offset > size_ ||
+      section.size > size_ - section.offset || section.size / sizeof(T) != count ||
+      section.size % sizeof(T) != 0) {
+    throw std::runtime_error("Corrupt machine image.");
+  }
+
+  return (count) ? reinterpret_cast<const T*>(data_ + section.offset) : nullptr;
+}
+
+/*!
+ *  Return a list of strings stored on a section.
+ */
+std::vector<std::string> MachineImage::strings(const Section& section) const {
+  const auto* table = reinterpret_cast<const std::uint64_t*>(data_ + section.offset);
+  const char* chars = data_ + section.offset + (table[0] + 1) * sizeof(std::uint64_t);
+
+  std::vector<std::string> result;
+  result.reserve(table[0]);
+
+  std::uint64_t first = 0;
+  for (std::uint64_t i = 1; i <= table[0]; ++i) {
+    result.emplace_back(chars + first, table[i] - first);
+    first = table[i];
+  }
+
+  return result;
+}
+
+/*!
+ *  Check that a list of strings is inside the image.
+ *
+ *  !WARNING: Throw if it isn't.
+ */
+void MachineImage::checkStrings(const Section& section) const {
+  const std::uint64_t word = sizeof(std::uint64_t);
+  if (section.offset % word != 0 || section.offset > size_ ||
+      section.size > size_ - section.offset || section.size < word) {
+    throw std::runtime_error("Corrupt machine image.");
+  }
+
+  const auto* table = reinterpret_cast<const std::uint64_t*>(data_ + section.offset);
+  if (table[0] >= section.size / word) {
+    throw std::runtime_error("Corrupt machine image.");
+  }
+
+  std::uint64_t chars_size = section.size - (table[0] + 1) * word;
+  std::uint64_t first = 0;
+  for (std::uint64_t i = 1; i <= table[0]; ++i) {
+    if (table[i] < first || table[i] > chars_size) {
+      throw std::runtime_error("Corrupt machine image.");
+    }
+    first = table[i];
+  }
+}
+
+}  // namespace turing
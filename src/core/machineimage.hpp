@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/compiledmachine.hpp"
+#include "utils/utils.hpp"
+
+namespace turing {
+
+class Turing;
+
+class MachineImage {
+public:
+  static constexpr std::uint32_t version = 1;
+
+  // Configuration with transitions, for machines without a dense table of offsets
+  struct Group {
+    std::uint64_t key;
+    TransitionId first;
+    TransitionId last;
+  };
+
+  // Position of a section on the image
+  struct Section {
+    std::uint64_t offset;
+    std::uint64_t size;
+  };
+
+  struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t action_size;
+    std::int32_t num_tapes;
+
+    std::uint64_t fingerprint;
+    std::uint64_t num_symbols;
+    std::uint64_t num_states;
+    std::uint64_t num_transitions;
+    std::uint64_t num_offsets;
+    std::uint64_t num_groups;
+    StateId initial_state;
+    std::uint32_t deterministic;
+
+    Section tape_symbols;
+    Section input_symbols;
+    Section state_names;
+    Section transition_names;
+    Section finals;
+    Section offsets;
+    Section groups;
+    Section actions;
+    Section source_states;
+  };
+
+public:
+  static void write(const Turing& machine, const std::string& file_path);
+  static bool isImage(const std::string& file_path);
+
+  explicit MachineImage(const std::string& file_path);
+  ~MachineImage();
+
+  MachineImage(const MachineImage&) = delete;
+  MachineImage& operator=(const MachineImage&) = delete;
+
+  const Header& header() const;
+
+  std::vector<Symbol> tapeSymbols() const;
+  std::vector<Symbol> inputSymbols() const;
+  std::vector<std::string> stateNames() const;
+  std::string_view transitionName(TransitionId transition) const;
+
+  const std::uint8_t* finals() const;
+  const TransitionId* offsets() const;
+  const Group* groups() const;
+  const CompiledMachine::Action* actions() const;
+  const StateId* sourceStates() const;
+
+private:
+  template <typename T>
+  const T* section(const Section& section, std::uint64_t count) const;
+
+  std::vector<std::string> strings(const Section& section) const;
+  void checkStrings(const Section& section) const;
+
+private:
+  const char* data_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace turing
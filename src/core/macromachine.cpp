@@ -0,0 +1,415 @@
+#include "macromachine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace turing {
+
+/*!
+ *  \class MacroMachine
+ *  \brief Run a deterministic single-tape machine over blocks of cells.
+ *
+ *  The tape is split in blocks of "block_size" cells, and each distinct block is
+ *  numbered as a macro-symbol. A macro step runs the machine from the state and the
+ *  entry cell of the block until the head leaves it (or the machine stops), and its
+ *  outcome (exit state and side, rewritten block and number of steps) is cached.
+ *  Machines that sweep over repetitive regions of the tape reuse the same outcomes,
+ *  so each macro step costs a hash lookup instead of "block_size" transitions.
+ *
+ *  Only deterministic single-tape machines are supported (See "supports").
+ *
+ *  The steps are the ones of the plain run, also when the machine loops inside a
+ *  block: the loop is detected, and its steps are counted up to the budget. Without a
+ *  step budget the plain run never ends, while this one is Rejected with the cycle
+ *  found (As LoopMachine does), after the steps done until the loop was detected.
+ */
+
+namespace {
+
+// Head displacement for each Move (Left, Right, Stop)
+constexpr int move_delta[] = {-1, 1, 0};
+
+// Floor division, for negative tape positions
+int floorDiv(int a, int b) {
+  return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+// a * b, saturated to the max value
+std::uint64_t saturatedMul(std::uint64_t a, std::uint64_t b) {
+  if (a && b > std::numeric_limits<std::uint64_t>::max() / a) {
+    return std::numeric_limits<std::uint64_t>::max();
+  }
+
+  return a * b;
+}
+
+// Configuration of a run that never leaves a block
+struct BlockRun {
+  StateId state;
+  int position;
+  std::vector<SymbolId> cells;
+
+  // Apply the only transition of the configuration
+  void step(const CompiledMachine& machine) {
+    auto range = machine.transitions(state, cells[position]);
+    const CompiledMachine::Action& action = *machine.actions(range.first);
+
+    cells[position] = action.write;
+    state = action.next_state;
+    position += move_delta[static_cast<int>(action.move)];
+  }
+
+  bool operator==(const BlockRun& other) const {
+    return state == other.state && position == other.position && cells == other.cells;
+  }
+};
+
+}  // namespace
+
+/*!
+ *  Prepare to run the machine on blocks of "block_size" cells.
+ */
+MacroMachine::MacroMachine(const CompiledMachine& machine, int block_size)
+    : machine_(machine), block_size_(std::max(block_size, 1)) {
+  // A block has (states * cells * symbols^cells) configurations. Running more steps
+  // than that without leaving it means the machine is looping.
+  max_block_steps_ = saturatedMul(machine_.numStates(), block_size_);
+  for (int i = 0; i < block_size_; ++i) {
+    max_block_steps_ = saturatedMul(max_block_steps_, machine_.numSymbols());
+  }
+
+  // The blank block is the block 0
+  std::vector<SymbolId> blank(block_size_, Alphabet::blank_id);
+  intern(blank.data());
+}
+
+/*!
+ *  Check if the machine can be run on blocks.
+ */
+bool MacroMachine::supports(const CompiledMachine& machine) {
+  return machine.numTapes() == 1 && machine.deterministic();
+}
+
+/*!
+ *  Run the machine from the initial state and the given tapes.
+ */
+RunResult MacroMachine::run(const std::vector<Tape>& tapes, const Limits& limits) {
+  RunResult result;
+  result.tapes = tapes;
+
+  StateId state = machine_.initialState();
+  if (state == CompiledMachine::no_state) {
+    return result;
+  }
+
+  if (machine_.isFinal(state)) {
+    result.verdict = Verdict::Accepted;
+    return result;
+  }
+
+  const Tape& tape = tapes[0];
+
+  // Lay out the tape in blocks. blocks[b + offset] is the block "b".
+  int first_written = tape.firstWritten();
+  int last_written = tape.lastWritten();
+
+  int first_block = floorDiv(std::min(tape.head(), first_written), block_size_);
+  int last_block = floorDiv(std::max(tape.head(), last_written), block_size_);
+  int offset = -first_block;
+
+  std::vector<BlockId> blocks;
+  std::vector<SymbolId> cells(block_size_);
+  for (int b = first_block; b <= last_block; ++b) {
+    for (int i = 0; i < block_size_; ++i) {
+      cells[i] = tape.peekId(b * block_size_ + i);
+    }
+    blocks.push_back(intern(cells.data()));
+  }
+
+  int block = floorDiv(tape.head(), block_size_);
+  int position = tape.head() - block * block_size_;
+
+  const std::uint64_t max_steps = limits.deterministicSteps();
+
+  // Position of the head when the machine accepts
+  int head = 0;
+
+  start_time_ = std::chrono::steady_clock::now();
+  max_time_ = limits.max_time;
+  std::uint64_t macro_steps = 0;
+
+  while (true) {
+    if (max_time_.count() && (++macro_steps % 1024) == 0 &&
+        std::chrono::steady_clock::now() - start_time_ >= max_time_) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    // Steps that can be done before running out of budget
+    std::uint64_t budget = max_steps - result.steps;
+
+    const Outcome& out = outcome(state, blocks[block + offset], position, budget);
+
+    // Without a step budget, a loop never ends
+    if (out.exit == Exit::Loop && max_steps == std::numeric_limits<std::uint64_t>::max()) {
+      Cycle cycle = blockCycle(state, blocks[block + offset], position);
+      cycle.start += result.steps;
+
+      result.steps += out.steps;
+      result.verdict = Verdict::Rejected;
+      result.cycle = cycle;
+      return result;
+    }
+
+    if (out.exit == Exit::Loop || out.exit == Exit::Timeout || out.steps > budget) {
+      // A loop runs until the budget is spent, as on the plain run
+      result.steps += (out.exit == Exit::Loop) ? budget : std::min(out.steps, budget);
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    result.steps += out.steps;
+    state = out.state;
+    blocks[block + offset] = out.block;
+
+    if (out.first_written <= out.last_written) {
+      first_written = std::min(first_written, block * block_size_ + out.first_written);
+      last_written = std::max(last_written, block * block_size_ + out.last_written);
+    }
+
+    if (out.exit == Exit::Halt) {
+      result.verdict = Verdict::Rejected;
+      return result;
+    }
+
+    if (out.exit == Exit::Accept) {
+      head = block * block_size_ + out.position;
+      break;
+    }
+
+    // Move to the next block, growing the tape if needed
+    if (out.exit == Exit::Left) {
+      --block;
+      position = block_size_ - 1;
+
+      if (block + offset < 0) {
+        blocks.insert(blocks.begin(), blocks.size(), 0);
+        offset += blocks.size() / 2;
+      }
+    } else {
+      ++block;
+      position = 0;
+
+      if (block + offset >= static_cast<int>(blocks.size())) {
+        blocks.resize(blocks.size() * 2, 0);
+      }
+    }
+  }
+
+  // Write the blocks back to the tape
+  Tape& result_tape = result.tapes[0];
+  while (result_tape.head() > first_written) {
+    result_tape.move(Move::Left);
+  }
+  while (result_tape.head() < first_written) {
+    result_tape.move(Move::Right);
+  }
+
+  for (int i = first_written; i <= last_written; ++i) {
+    result_tape.writeId(cell(blocks, offset, i));
+    result_tape.move(Move::Right);
+  }
+
+  while (result_tape.head() > head) {
+    result_tape.move(Move::Left);
+  }
+  while (result_tape.head() < head) {
+    result_tape.move(Move::Right);
+  }
+
+  result.verdict = Verdict::Accepted;
+  result.depth = result.steps;
+  return result;
+}
+
+/*!
+ *  Return the outcome of running the machine on the block from "state" and the cell
+ *  "position". It's simulated the first time, and cached.
+ *
+ *  "budget" is the number of steps left. An outcome that runs out of it (or of time)
+ *  isn't cached, as it could be completed with a bigger budget.
+ */
+const MacroMachine::Outcome& MacroMachine::outcome(StateId state,
+                                                   BlockId block,
+                                                   int position,
+                                                   std::uint64_t budget) {
+  auto it = outcomes_.find({state, block, position});
+  if (it != outcomes_.end()) {
+    return it->second;
+  }
+
+  std::uint64_t max_steps = max_block_steps_;
+  bool limited = budget < max_steps;
+  if (limited) {
+    max_steps = budget + 1;
+  }
+
+  Outcome out = simulate(state, block, position, max_steps);
+  if ((limited && out.exit == Exit::Loop) || out.exit == Exit::Timeout) {
+    // Not cached. Kept until the next call, that won't happen as the run ends.
+    uncached_ = out;
+    return uncached_;
+  }
+
+  return outcomes_.emplace(Key{state, block, position}, out).first->second;
+}
+
+/*!
+ *  Run the machine inside the block, starting from "state" and the cell "position",
+ *  until the head leaves the block, the machine stops, "max_steps" are done
+ *  (Exit::Loop), or the time budget of the run ends (Exit::Timeout).
+ */
+MacroMachine::Outcome MacroMachine::simulate(StateId state,
+                                             BlockId block,
+                                             int position,
+                                             std::uint64_t max_steps) {
+  auto first_cell = block_cells_.begin() + size_t(block) * block_size_;
+  std::vector<SymbolId> cells(first_cell, first_cell + block_size_);
+
+  Outcome out{state, block, Exit::Loop, position, block_size_, -1, 0};
+
+  while (out.steps < max_steps) {
+    auto range = machine_.transitions(out.state, cells[out.position]);
+    if (range.empty()) {
+      out.exit = Exit::Halt;
+      break;
+    }
+
+    const CompiledMachine::Action& action = *machine_.actions(range.first);
+    cells[out.position] = action.write;
+    out.first_written = std::min(out.first_written, out.position);
+    out.last_written = std::max(out.last_written, out.position);
+
+    out.state = action.next_state;
+    out.position += move_delta[static_cast<int>(action.move)];
+    ++out.steps;
+
+    if (machine_.isFinal(out.state)) {
+      out.exit = Exit::Accept;
+      break;
+    }
+
+    if (out.position < 0) {
+      out.exit = Exit::Left;
+      break;
+    }
+
+    if (out.position >= block_size_) {
+      out.exit = Exit::Right;
+      break;
+    }
+
+    // Big blocks can take long to leave, so the time is checked inside them too
+    if (max_time_.count() && (out.steps % 1024) == 0 &&
+        std::chrono::steady_clock::now() - start_time_ >= max_time_) {
+      out.exit = Exit::Timeout;
+      break;
+    }
+  }
+
+  out.block = intern(cells.data());
+  return out;
+}
+
+/*!
+ *  Return the cycle of a run that loops inside the block from "state" and the cell
+ *  "position", relative to the entry to the block. Its length is found with Brent's
+ *  algorithm, and its first step running the machine twice, "length" steps apart (As
+ *  LoopMachine does).
+ */
+Cycle MacroMachine::blockCycle(StateId state, BlockId block, int position) const {
+  auto first_cell = block_cells_.begin() + size_t(block) * block_size_;
+  const BlockRun start{state, position, {first_cell, first_cell + block_size_}};
+
+  BlockRun saved = start;
+  BlockRun current = start;
+  current.step(machine_);
+
+  std::uint64_t length = 1;
+  std::uint64_t power = 1;
+  while (!(current == saved)) {
+    if (length == power) {
+      saved = current;
+      power *= 2;
+      length = 0;
+    }
+
+    current.step(machine_);
+    ++length;
+  }
+
+  BlockRun first = start;
+  BlockRun second = start;
+  for (std::uint64_t i = 0; i < length; ++i) {
+    second.step(machine_);
+  }
+
+  std::uint64_t first_step = 0;
+  while (!(first == second)) {
+    first.step(machine_);
+    second.step(machine_);
+    ++first_step;
+  }
+
+  return Cycle{first_step, length};
+}
+
+/*!
+ *  Return the number of the block with the given cells, numbering it if it's new.
+ */
+MacroMachine::BlockId MacroMachine::intern(const SymbolId* cells) {
+  std::string key(reinterpret_cast<const char*>(cells), block_size_ * sizeof(SymbolId));
+
+  auto it = block_ids_.find(key);
+  if (it != block_ids_.end()) {
+    return it->second;
+  }
+
+  BlockId id = block_ids_.size();
+  block_ids_.emplace(std::move(key), id);
+  block_cells_.insert(block_cells_.end(), cells, cells + block_size_);
+
+  return id;
+}
+
+/*!
+ *  Return the symbol on the tape position.
+ */
+SymbolId MacroMachine::cell(const std::vector<BlockId>& blocks,
+                            int offset,
+                            int position) const {
+  int block = floorDiv(position, block_size_);
+  int idx = block + offset;
+  if (idx < 0 || idx >= static_cast<int>(blocks.size())) {
+    return Alphabet::blank_id;
+  }
+
+  return block_cells_[size_t(blocks[idx]) * block_size_ + (position - block * block_size_)];
+}
+
+bool MacroMachine::Key::operator==(const Key& other) const {
+  return state == other.state && block == other.block && position == other.position;
+}
+
+size_t MacroMachine::KeyHash::operator()(const Key& key) const {
+  std::uint64_t k = (std::uint64_t(key.block) << 32) ^ (std::uint64_t(key.state) << 8) ^
+                    std::uint64_t(key.position);
+
+  // Mix the bits (splitmix64 finalizer)
+  k = (k ^ (k >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  k = (k ^ (k >> 27)) * 0x94d049bb133111ebULL;
+  return k ^ (k >> 31);
+}
+
+}  // namespace turing
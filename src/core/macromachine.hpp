@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/compiledmachine.hpp"
+#include "core/result.hpp"
+
+namespace turing {
+
+class MacroMachine {
+public:
+  MacroMachine(const CompiledMachine& machine, int block_size);
+
+  static bool supports(const CompiledMachine& machine);
+
+  RunResult run(const std::vector<Tape>& tapes, const Limits& limits);
+
+private:
+  // Number of a block of cells (macro-symbol)
+  using BlockId = std::uint32_t;
+
+  // How the machine leaves a block (Timeout: the time budget ran out inside it)
+  enum class Exit : std::uint8_t { Left, Right, Accept, Halt, Loop, Timeout };
+
+  // Result of running the machine inside a block, until it leaves it or stops
+  struct Outcome {
+    StateId state;
+    BlockId block;
+    Exit exit;
+
+    // Final position of the head (For Accept and Halt)
+    int position;
+
+    // Cells written, relative to the block
+    int first_written;
+    int last_written;
+
+    std::uint64_t steps;
+  };
+
+  struct Key {
+    StateId state;
+    BlockId block;
+    int position;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+private:
+  const Outcome& outcome(StateId state, BlockId block, int position, std::uint64_t budget);
+  Outcome simulate(StateId state, BlockId block, int position, std::uint64_t max_steps);
+  Cycle blockCycle(StateId state, BlockId block, int position) const;
+
+  BlockId intern(const SymbolId* cells);
+
+  SymbolId cell(const std::vector<BlockId>& blocks, int offset, int position) const;
+
+private:
+  const CompiledMachine& machine_;
+  const int block_size_;
+
+  // Steps after which a machine that hasn't left a block is looping
+  std::uint64_t max_block_steps_;
+
+  // The cells of the block "b" are block_cells_[b * block_size_ + i]
+  std::vector<SymbolId> block_cells_;
+  std::unordered_map<std::string, BlockId> block_ids_;
+
+  std::unordered_map<Key, Outcome, KeyHash> outcomes_;
+
+  // Last outcome that ran out of budget
+  Outcome uncached_;
+
+  // Time budget of the current run
+  std::chrono::steady_clock::time_point start_time_;
+  std::chrono::milliseconds max_time_{0};
+};
+
+}  // namespace turing
@@ -0,0 +1,293 @@
+#include "parallelsearch.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace turing {
+
+/*!
+ *  \class ParallelSearch
+ *  \brief Explore the computation tree of a Non-Deterministic machine with several
+ *  threads.
+ *
+ *  Each worker follows a single computation path. When a configuration has several
+ *  transitions, the worker continues with the first one and pushes the others to the
+ *  back of its own queue. Idle workers first take work from the back of their own
+ *  queue and, if it's empty, steal from the front of the queue of other workers,
+ *  where the oldest (usually biggest) subtrees are. When all the queues are empty,
+ *  idle workers sleep until a configuration is pushed or the search ends.
+ *
+ *  As soon as a worker finds an accepting configuration, all workers are cancelled.
+ *  The accepting computation found isn't necessarily the first one found by the
+ *  depth-first search, nor the shortest.
+ *
+ *  Steps are counted by each worker and added to the shared counter in batches, so
+ *  the step budget may be exceeded by a few steps per worker.
+ */
+
+namespace {
+
+// Steps done by a worker before adding them to the shared counter
+constexpr std::uint64_t step_batch = 256;
+
+}  // namespace
+
+/*!
+ *  Prepare a search over "machine" with "num_threads" workers. If "profiling" is set,
+ *  each worker counts its own visits, merged on the result.
+ */
+ParallelSearch::ParallelSearch(const CompiledMachine& machine,
+                               const Limits& limits,
+                               size_t num_threads,
+                               bool profiling)
+    : machine_(machine), limits_(limits),
+      num_threads_(std::max<size_t>(num_threads, 1)) {
+  for (size_t i = 0; i < num_threads_; ++i) {
+    queues_.push_back(std::make_unique<WorkQueue>());
+  }
+
+  if (profiling) {
+    profiles_.assign(num_threads_, Profile(machine_));
+  }
+}
+
+/*!
+ *  Run the search from the initial state of the machine and the given tapes.
+ */
+RunResult ParallelSearch::run(const std::vector<Tape>& tapes) {
+  result_.tapes = tapes;
+
+  if (machine_.initialState() == CompiledMachine::no_state) {
+    return std::move(result_);
+  }
+
+  start_time_ = std::chrono::steady_clock::now();
+
+  push(0, Configuration{machine_.initialState(), tapes, 0});
+
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < num_threads_; ++i) {
+    workers.emplace_back(&ParallelSearch::work, this, i);
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  if (!profiles_.empty()) {
+    Profile& profile = result_.profile.emplace(machine_);
+    profile.startRun();
+    for (const auto& worker_profile : profiles_) {
+      profile.merge(worker_profile);
+    }
+  }
+
+  result_.steps = steps_;
+  if (result_.verdict != Verdict::Accepted) {
+    result_.verdict = (out_of_budget_ || pruned_) ? Verdict::Undecided : Verdict::Rejected;
+  }
+
+  return std::move(result_);
+}
+
+/*!
+ *  Worker loop: explore configurations until the search ends or is cancelled.
+ */
+void ParallelSearch::work(size_t worker) {
+  Configuration configuration;
+
+  while (!stop_) {
+    if (pop(worker, configuration) || steal(worker, configuration)) {
+      explore(worker, std::move(configuration));
+      if (--pending_ == 0) {
+        wakeAll();
+      }
+    } else if (pending_ == 0) {
+      break;
+    } else {
+      waitForWork();
+    }
+  }
+}
+
+/*!
+ *  Follow the computation path from the configuration, pushing the other branches
+ *  to the worker queue.
+ */
+void ParallelSearch::explore(size_t worker, Configuration current) {
+  Profile* profile = (profiles_.empty()) ? nullptr : &profiles_[worker];
+  std::uint64_t steps = 0;
+
+  while (!stop_) {
+    if (profile) {
+      profile->visit(current.state);
+      profile->track(current.tapes);
+    }
+
+    if (machine_.isFinal(current.state)) {
+      accept(current);
+      break;
+    }
+
+    auto range = machine_.transitions(current.state, current.tapes);
+    if (range.empty()) {
+      break;
+    }
+
+    if (limits_.max_depth && current.depth >= limits_.max_depth) {
+      pruned_ = true;
+      break;
+    }
+
+    if (profile) {
+      if (range.size() > 1) {
+        profile->branch(current.state);
+        profile->backtrack(current.state, range.size() - 1);
+      }
+
+      for (TransitionId transition = range.first; transition < range.last;
+           ++transition) {
+        profile->fire(transition);
+      }
+    }
+
+    // Push the other branches in reverse order, so they're explored in order
+    for (TransitionId transition = range.last - 1; transition > range.first;
+         --transition) {
+      Configuration branch{0, current.tapes, current.depth + 1};
+      branch.state = machine_.apply(transition, branch.tapes);
+      push(worker, std::move(branch));
+    }
+
+    current.state = machine_.apply(range.first, current.tapes);
+    ++current.depth;
+
+    steps += range.size();
+    if (steps >= step_batch) {
+      if (!countSteps(steps)) {
+        return;
+      }
+      steps = 0;
+    }
+  }
+
+  countSteps(steps);
+}
+
+/*!
+ *  Add a configuration to the back of the worker queue.
+ */
+void ParallelSearch::push(size_t worker, Configuration&& configuration) {
+  ++pending_;
+
+  {
+    std::lock_guard<std::mutex> lock(queues_[worker]->mutex);
+    queues_[worker]->configurations.push_back(std::move(configuration));
+  }
+
+  // An idle worker either sees the new configuration before sleeping, or is counted
+  // here and woken up
+  ++queued_;
+  if (idle_ > 0) {
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    idle_condition_.notify_one();
+  }
+}
+
+/*!
+ *  Take the newest configuration of the worker queue.
+ */
+bool ParallelSearch::pop(size_t worker, Configuration& configuration) {
+  std::lock_guard<std::mutex> lock(queues_[worker]->mutex);
+
+  auto& configurations = queues_[worker]->configurations;
+  if (configurations.empty()) {
+    return false;
+  }
+
+  configuration = std::move(configurations.back());
+  configurations.pop_back();
+  --queued_;
+  return true;
+}
+
+/*!
+ *  Take the oldest configuration of the queue of another worker.
+ */
+bool ParallelSearch::steal(size_t worker, Configuration& configuration) {
+  for (size_t i = 1; i < num_threads_; ++i) {
+    auto& victim = *queues_[(worker + i) % num_threads_];
+
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.configurations.empty()) {
+      configuration = std::move(victim.configurations.front());
+      victim.configurations.pop_front();
+      --queued_;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/*!
+ *  Sleep until a configuration can be stolen, or the search ends.
+ */
+void ParallelSearch::waitForWork() {
+  std::unique_lock<std::mutex> lock(idle_mutex_);
+
+  ++idle_;
+  idle_condition_.wait(lock, [this] { return queued_ > 0 || pending_ == 0 || stop_; });
+  --idle_;
+}
+
+/*!
+ *  Wake up all the idle workers, as the search ended.
+ */
+void ParallelSearch::wakeAll() {
+  std::lock_guard<std::mutex> lock(idle_mutex_);
+  idle_condition_.notify_all();
+}
+
+/*!
+ *  Store the accepting configuration (If none was found before) and cancel the
+ *  search.
+ */
+void ParallelSearch::accept(Configuration& configuration) {
+  std::lock_guard<std::mutex> lock(result_mutex_);
+
+  if (result_.verdict != Verdict::Accepted) {
+    result_.verdict = Verdict::Accepted;
+    result_.tapes = std::move(configuration.tapes);
+    result_.depth = configuration.depth;
+  }
+
+  stop_ = true;
+  wakeAll();
+}
+
+/*!
+ *  Add the steps done by a worker to the total, and check the step and time budgets.
+ *  Return false (and cancel the search) if a budget ran out.
+ *
+ *  As in the depth-first search, the steps run out when a step past the budget is
+ *  needed: a tree explored in exactly "max_steps" steps is still decided.
+ */
+bool ParallelSearch::countSteps(std::uint64_t steps) {
+  std::uint64_t total = steps_ += steps;
+
+  bool out_of_steps = limits_.max_steps && total > limits_.max_steps;
+  bool out_of_time = limits_.max_time.count() &&
+                     std::chrono::steady_clock::now() - start_time_ >= limits_.max_time;
+
+  if (out_of_steps || out_of_time) {
+    out_of_budget_ = true;
+    stop_ = true;
+    wakeAll();
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace turing
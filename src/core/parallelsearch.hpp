@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/compiledmachine.hpp"
+#include "core/configuration.hpp"
+#include "core/result.hpp"
+
+namespace turing {
+
+class ParallelSearch {
+public:
+  ParallelSearch(const CompiledMachine& machine,
+                 const Limits& limits,
+                 size_t num_threads,
+                 bool profiling = false);
+
+  RunResult run(const std::vector<Tape>& tapes);
+
+private:
+  // Configurations pending to explore by a worker. The owner works on the back, the
+  // other workers steal from the front.
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Configuration> configurations;
+  };
+
+private:
+  void work(size_t worker);
+  void explore(size_t worker, Configuration configuration);
+
+  void push(size_t worker, Configuration&& configuration);
+  bool pop(size_t worker, Configuration& configuration);
+  bool steal(size_t worker, Configuration& configuration);
+  void waitForWork();
+  void wakeAll();
+
+  void accept(Configuration& configuration);
+  bool countSteps(std::uint64_t steps);
+
+private:
+  const CompiledMachine& machine_;
+  const Limits limits_;
+  const size_t num_threads_;
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+
+  // Counters of each worker, merged at the end. Empty if not profiling.
+  std::vector<Profile> profiles_;
+
+  // Configurations pushed and not explored yet. The search ends when it reaches 0.
+  std::atomic<std::uint64_t> pending_{0};
+
+  // Configurations on the queues. Idle workers sleep until there's one to steal.
+  std::atomic<std::uint64_t> queued_{0};
+  std::atomic<size_t> idle_{0};
+  std::mutex idle_mutex_;
+  std::condition_variable idle_condition_;
+
+  // Set to cancel all the workers
+  std::atomic<bool> stop_{false};
+
+  std::atomic<std::uint64_t> steps_{0};
+  std::atomic<bool> pruned_{false};
+  std::atomic<bool> out_of_budget_{false};
+
+  std::chrono::steady_clock::time_point start_time_;
+
+  std::mutex result_mutex_;
+  RunResult result_;
+};
+
+}  // namespace turing
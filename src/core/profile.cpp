@@ -0,0 +1,232 @@
+#include "profile.hpp"
+
+#include "core/compiledmachine.hpp"
+
+namespace turing {
+
+/*!
+ *  \class Profile
+ *  \brief Execution counters of a compiled machine, kept on flat arrays.
+ *
+ *  - Visits: Configurations on each state that have been explored.
+ *  - Firings: Times each transition has been applied.
+ *  - Branch points: Configurations on each state with more than one transition.
+ *  - Backtracks: Alternative branches explored from the branch points of each state.
+ *  - Head range: Leftmost and rightmost positions reached by the head of each Tape.
+ *
+ *  A Profile can accumulate several runs of the same machine (See "merge").
+ */
+
+namespace {
+
+/*!
+ *  Write the string as a JSON string literal. Control characters are written as
+ *  unicode escapes.
+ */
+void writeJsonString(std::ostream& os, const std::string& str) {
+  os << '"';
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+
+      case '\\':
+        os << "\\\\";
+        break;
+
+      case '\n':
+        os << "\\n";
+        break;
+
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          static const char* hex = "0123456789abcdef";
+          os << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+        } else {
+          os << c;
+        }
+    }
+  }
+  os << '"';
+}
+
+/*!
+ *  Write the string as a CSV field, quoted if needed.
+ */
+void writeCsvField(std::ostream& os, const std::string& str) {
+  if (str.find_first_of(",\"\n") == std::string::npos) {
+    os << str;
+    return;
+  }
+
+  os << '"';
+  for (char c : str) {
+    if (c == '"') {
+      os << '"';
+    }
+    os << c;
+  }
+  os << '"';
+}
+
+}  // namespace
+
+/*!
+ *  Create an empty profile with counters for all the states, transitions and tapes of
+ *  the machine.
+ */
+Profile::Profile(const CompiledMachine& machine)
+    : state_visits_(machine.numStates(), 0),
+      branch_points_(machine.numStates(), 0),
+      backtracks_(machine.numStates(), 0),
+      transition_firings_(machine.numTransitions(), 0),
+      min_head_(machine.numTapes(), 0),
+      max_head_(machine.numTapes(), 0) {}
+
+/*!
+ *  Return the number of runs accumulated.
+ */
+std::uint64_t Profile::runs() const {
+  return runs_;
+}
+
+/*!
+ *  Return the number of configurations explored on the state.
+ */
+std::uint64_t Profile::stateVisits(StateId state) const {
+  return state_visits_[state];
+}
+
+/*!
+ *  Return the number of times the transition was applied.
+ */
+std::uint64_t Profile::transitionFirings(TransitionId transition) const {
+  return transition_firings_[transition];
+}
+
+/*!
+ *  Return the number of configurations on the state with more than one transition.
+ */
+std::uint64_t Profile::branchPoints(StateId state) const {
+  return branch_points_[state];
+}
+
+/*!
+ *  Return the number of alternative branches explored from the state.
+ */
+std::uint64_t Profile::backtracks(StateId state) const {
+  return backtracks_[state];
+}
+
+/*!
+ *  Return the leftmost position reached by the head of the Tape.
+ */
+int Profile::minHead(int tape) const {
+  return min_head_[tape];
+}
+
+/*!
+ *  Return the rightmost position reached by the head of the Tape.
+ */
+int Profile::maxHead(int tape) const {
+  return max_head_[tape];
+}
+
+/*!
+ *  Count a new run.
+ */
+void Profile::startRun() {
+  ++runs_;
+}
+
+/*!
+ *  Add the counters of other profile of the same machine.
+ */
+void Profile::merge(const Profile& other) {
+  runs_ += other.runs_;
+
+  auto add = [](std::vector<std::uint64_t>& to, const std::vector<std::uint64_t>& from) {
+    to.resize(std::max(to.size(), from.size()), 0);
+    for (size_t i = 0; i < from.size(); ++i) {
+      to[i] += from[i];
+    }
+  };
+
+  add(state_visits_, other.state_visits_);
+  add(branch_points_, other.branch_points_);
+  add(backtracks_, other.backtracks_);
+  add(transition_firings_, other.transition_firings_);
+
+  min_head_.resize(std::max(min_head_.size(), other.min_head_.size()), 0);
+  max_head_.resize(std::max(max_head_.size(), other.max_head_.size()), 0);
+  for (size_t i = 0; i < other.min_head_.size(); ++i) {
+    min_head_[i] = std::min(min_head_[i], other.min_head_[i]);
+    max_head_[i] = std::max(max_head_[i], other.max_head_[i]);
+  }
+}
+
+/*!
+ *  Write the profile as a JSON object.
+ */
+void Profile::writeJson(std::ostream& os, const CompiledMachine& machine) const {
+  os << "{\n  \"runs\": " << runs_ << ",\n";
+
+  os << "  \"states\": [";
+  for (StateId s = 0; s < state_visits_.size(); ++s) {
+    os << ((s) ? ",\n" : "\n") << "    {\"id\": " << s << ", \"name\": ";
+    writeJsonString(os, machine.stateName(s));
+    os << ", \"visits\": " << state_visits_[s]
+       << ", \"branch_points\": " << branch_points_[s]
+       << ", \"backtracks\": " << backtracks_[s] << "}";
+  }
+  os << "\n  ],\n";
+
+  os << "  \"transitions\": [";
+  for (TransitionId t = 0; t < transition_firings_.size(); ++t) {
+    os << ((t) ? ",\n" : "\n") << "    {\"id\": " << t << ", \"state\": ";
+    writeJsonString(os, machine.stateName(machine.sourceState(t)));
+    os << ", \"transition\": ";
+    writeJsonString(os, machine.transitionName(t));
+    os << ", \"firings\": " << transition_firings_[t] << "}";
+  }
+  os << "\n  ],\n";
+
+  os << "  \"tapes\": [";
+  for (size_t i = 0; i < min_head_.size(); ++i) {
+    os << ((i) ? ",\n" : "\n") << "    {\"id\": " << i
+       << ", \"min_head\": " << min_head_[i] << ", \"max_head\": " << max_head_[i]
+       << ", \"extent\": " << max_head_[i] - min_head_[i] + 1 << "}";
+  }
+  os << "\n  ]\n}\n";
+}
+
+/*!
+ *  Write the profile as CSV, with a row for each state, transition and tape:
+ *      kind,id,name,visits,branch_points,backtracks,firings,min_head,max_head
+ *  Columns that don't apply to the kind are left empty.
+ */
+void Profile::writeCsv(std::ostream& os, const CompiledMachine& machine) const {
+  os << "kind,id,name,visits,branch_points,backtracks,firings,min_head,max_head\n";
+
+  for (StateId s = 0; s < state_visits_.size(); ++s) {
+    os << "state," << s << ",";
+    writeCsvField(os, machine.stateName(s));
+    os << "," << state_visits_[s] << "," << branch_points_[s] << ","
+       << backtracks_[s] << ",,,\n";
+  }
+
+  for (TransitionId t = 0; t < transition_firings_.size(); ++t) {
+    os << "transition," << t << ",";
+    writeCsvField(os, machine.stateName(machine.sourceState(t)) + " " +
+                          machine.transitionName(t));
+    os << ",,,," << transition_firings_[t] << ",,\n";
+  }
+
+  for (size_t i = 0; i < min_head_.size(); ++i) {
+    os << "tape," << i << ",Tape " << i << ",,,,," << min_head_[i] << ","
+       << max_head_[i] << "\n";
+  }
+}
+
+}  // namespace turing
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "data/tape.hpp"
+#include "utils/utils.hpp"
+
+namespace turing {
+
+class CompiledMachine;
+
+class Profile {
+public:
+  Profile() = default;
+  explicit Profile(const CompiledMachine& machine);
+
+  std::uint64_t runs() const;
+  std::uint64_t stateVisits(StateId state) const;
+  std::uint64_t transitionFirings(TransitionId transition) const;
+  std::uint64_t branchPoints(StateId state) const;
+  std::uint64_t backtracks(StateId state) const;
+  int minHead(int tape) const;
+  int maxHead(int tape) const;
+
+  // Counters updated while running. Inline, as they are called on every step.
+  void visit(StateId state) { ++state_visits_[state]; }
+  void fire(TransitionId transition) { ++transition_firings_[transition]; }
+  void branch(StateId state) { ++branch_points_[state]; }
+  void backtrack(StateId state, std::uint64_t branches = 1) {
+    backtracks_[state] += branches;
+  }
+  void track(const std::vector<Tape>& tapes) {
+    for (size_t i = 0; i < tapes.size(); ++i) {
+      min_head_[i] = std::min(min_head_[i], tapes[i].head());
+      max_head_[i] = std::max(max_head_[i], tapes[i].head());
+    }
+  }
+
+  void startRun();
+  void merge(const Profile& other);
+
+  void writeJson(std::ostream& os, const CompiledMachine& machine) const;
+  void writeCsv(std::ostream& os, const CompiledMachine& machine) const;
+
+private:
+  std::uint64_t runs_{0};
+
+  // Indexed by StateId
+  std::vector<std::uint64_t> state_visits_;
+  std::vector<std::uint64_t> branch_points_;
+  std::vector<std::uint64_t> backtracks_;
+
+  // Indexed by TransitionId
+  std::vector<std::uint64_t> transition_firings_;
+
+  // Indexed by Tape
+  std::vector<int> min_head_;
+  std::vector<int> max_head_;
+};
+
+}  // namespace turing
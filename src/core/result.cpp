@@ -0,0 +1,135 @@
+#include "result.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace turing {
+
+/*!
+ *  Return the corresponding string for a Verdict enum
+ */
+std::string to_string(const Verdict& verdict) {
+  switch (verdict) {
+    case Verdict::Accepted:
+      return "Accepted";
+      break;
+
+    case Verdict::Rejected:
+      return "Rejected";
+      break;
+
+    case Verdict::Undecided:
+      return "Undecided";
+      break;
+
+    default:
+      return std::to_string(int(verdict));
+  }
+}
+
+/*!
+ *  Print the Verdict.
+ */
+std::ostream& operator<<(std::ostream& os, const Verdict& verdict) {
+  return os << to_string(verdict);
+}
+
+/*!
+ *  Return the corresponding string for a SearchMode enum
+ */
+std::string to_string(const SearchMode& mode) {
+  switch (mode) {
+    case SearchMode::DepthFirst:
+      return "DepthFirst";
+      break;
+
+    case SearchMode::BreadthFirst:
+      return "BreadthFirst";
+      break;
+
+    case SearchMode::Parallel:
+      return "Parallel";
+      break;
+
+    default:
+      return std::to_string(int(mode));
+  }
+}
+
+/*!
+ *  Transform the string to a SearchMode enum.
+ *  Case insensitive.
+ *
+ *  !WARNING: Throw if the string isn't a search mode.
+ */
+SearchMode to_SearchMode(std::string mode_str) {
+  std::transform(mode_str.begin(), mode_str.end(), mode_str.begin(), ::tolower);
+  if (mode_str == "depthfirst" || mode_str == "dfs") {
+    return SearchMode::DepthFirst;
+  }
+
+  if (mode_str == "breadthfirst" || mode_str == "bfs") {
+    return SearchMode::BreadthFirst;
+  }
+
+  if (mode_str == "parallel") {
+    return SearchMode::Parallel;
+  }
+
+  throw std::runtime_error("Unknown search mode: " + mode_str);
+}
+
+/*!
+ *  \class Limits
+ *  \brief Step, depth and time budgets for a run.
+ *
+ *  When a budget runs out, the run ends as Undecided instead of Rejected.
+ *  - max_steps: Number of transitions applied (on all the explored branches).
+ *  - max_depth: Length of a single computation path. Deeper branches are pruned.
+ *  - max_time: Wall-clock time of the run.
+ */
+
+/*!
+ *  Check if no budget was set.
+ */
+bool Limits::unlimited() const {
+  return max_steps == 0 && max_depth == 0 && max_time.count() == 0;
+}
+
+/*!
+ *  Return the number of steps a deterministic run can do. Its only branch is as deep
+ *  as its steps, so it's the lowest of both budgets (The max value if unlimited).
+ */
+std::uint64_t Limits::deterministicSteps() const {
+  std::uint64_t steps = std::numeric_limits<std::uint64_t>::max();
+  if (max_steps) {
+    steps = max_steps;
+  }
+  if (max_depth) {
+    steps = std::min(steps, max_depth);
+  }
+
+  return steps;
+}
+
+/*!
+ *  \class RunResult
+ *  \brief Verdict, number of steps and tapes of a run.
+ *
+ *  "steps" counts all the transitions applied, on every explored branch. "depth" is
+ *  the number of steps of the accepting computation.
+ *  If the input was accepted, "tapes" are the tapes of the accepting configuration.
+ *  Otherwise, they are the initial tapes.
+ *  "profile" has the execution counters of the run, if the machine was profiled.
+ *  "cycle" is set if the run was Rejected because it loops forever.
+ */
+
+/*!
+ *  Check if the input was accepted.
+ */
+bool RunResult::accepted() const {
+  return verdict == Verdict::Accepted;
+}
+
+}  // namespace turing
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/profile.hpp"
+#include "data/tape.hpp"
+#include "utils/diagnostics.hpp"
+
+namespace turing {
+
+enum class Verdict { Accepted, Rejected, Undecided };
+std::string to_string(const Verdict& verdict);
+
+std::ostream& operator<<(std::ostream& os, const Verdict& verdict);
+
+enum class SearchMode { DepthFirst, BreadthFirst, Parallel };
+std::string to_string(const SearchMode& mode);
+SearchMode to_SearchMode(std::string mode_str);
+
+/*!
+ *  Budgets for a run. A value of 0 means "unlimited".
+ */
+struct Limits {
+  std::uint64_t max_steps{0};
+  std::uint64_t max_depth{0};
+  std::chrono::milliseconds max_time{0};
+
+  bool unlimited() const;
+  std::uint64_t deterministicSteps() const;
+};
+
+/*!
+ *  Cycle of a run that loops forever: the configuration reached after "start" steps
+ *  repeats every "length" steps.
+ */
+struct Cycle {
+  std::uint64_t start{0};
+  std::uint64_t length{0};
+};
+
+/*!
+ *  Outcome of running a Turing machine over an input.
+ */
+struct RunResult {
+  Verdict verdict{Verdict::Rejected};
+  std::uint64_t steps{0};
+  std::uint64_t depth{0};
+  std::vector<Tape> tapes;
+
+  // Warnings found while reading the input
+  Diagnostics diagnostics;
+
+  // Execution counters. Only filled if profiling is enabled.
+  std::optional<Profile> profile;
+
+  // Set if the run was proven to loop forever (Then it's Rejected)
+  std::optional<Cycle> cycle;
+
+  bool accepted() const;
+};
+
+}  // namespace turing
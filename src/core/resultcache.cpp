@@ -0,0 +1,314 @@
+#include "resultcache.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace turing {
+
+/*!
+ *  \class ResultCache
+ *  \brief Results of previous runs, keyed by the machine and the input.
+ *
+ *  The machine is identified by a 64-bit key (The fingerprint of the compiled machine,
+ *  combined with the settings that change the result), and the input by the symbol
+ *  ids written on the first tape. Each entry stores the verdict and the number of
+ *  steps, and optionally the final tapes. Without them, a cached result has the
+ *  initial tapes.
+ *
+ *  The cache can be shared by several threads, and saved to / loaded from a binary
+ *  file to reuse it between executions.
+ */
+
+namespace {
+
+// Identifies the files of the cache (And its version)
+constexpr char file_magic[] = "TURCACHE1";
+
+template <typename T>
+void writeValue(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T readValue(std::istream& is) {
+  T value{};
+  is.read(reinterpret_cast<char*>(&value), sizeof(value));
+  if (!is) {
+    throw std::runtime_error("Truncated cache file.");
+  }
+
+  return value;
+}
+
+template <typename T>
+void writeVector(std::ostream& os, const std::vector<T>& values) {
+  writeValue<std::uint64_t>(os, values.size());
+  os.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+// Number of bytes left to read on the stream
+std::uint64_t bytesLeft(std::istream& is) {
+  const auto position = is.tellg();
+  is.seekg(0, std::ios::end);
+  const auto end = is.tellg();
+  is.seekg(position);
+
+  return (position < 0 || end < position) ? 0 : end - position;
+}
+
+template <typename T>
+std::vector<T> readVector(std::istream& is) {
+  // The size is checked before allocating, so a corrupt one doesn't exhaust the memory
+  auto size = readValue<std::uint64_t>(is);
+  if (size > bytesLeft(is) / sizeof(T)) {
+    throw std::runtime_error("Truncated cache file.");
+  }
+
+  std::vector<T> values(size);
+  is.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+  if (!is) {
+    throw std::runtime_error("Truncated cache file.");
+  }
+
+  return values;
+}
+
+}  // namespace
+
+/*!
+ *  Create an empty cache. If "store_tapes" is false, only the verdicts are stored.
+ */
+ResultCache::ResultCache(bool store_tapes) : store_tapes_(store_tapes) {}
+
+/*!
+ *  Check if the final tapes are stored.
+ */
+bool ResultCache::storesTapes() const {
+  return store_tapes_;
+}
+
+/*!
+ *  Return the number of results stored.
+ */
+size_t ResultCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+/*!
+ *  Return the number of lookups that found a result.
+ */
+std::uint64_t ResultCache::hits() const {
+  return hits_;
+}
+
+/*!
+ *  Return the number of lookups that didn't find a result.
+ */
+std::uint64_t ResultCache::misses() const {
+  return misses_;
+}
+
+/*!
+ *  Return the result of the machine for the input, if it's cached. The tapes are
+ *  built with the given alphabet (A result with symbols that aren't on it isn't
+ *  returned).
+ */
+std::optional<RunResult> ResultCache::find(std::uint64_t machine,
+                                           const std::vector<SymbolId>& input,
+                                           const Alphabet& tape_alphabet) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  auto it = entries_.find({machine, input});
+  if (it == entries_.end()) {
+    ++misses_;
+    return std::nullopt;
+  }
+
+  Entry entry = it->second;
+  lock.unlock();
+
+  // Results loaded from a file could have been stored by another machine
+  for (const auto& tape_cells : entry.tapes) {
+    for (SymbolId id : tape_cells.cells) {
+      if (id >= tape_alphabet.numIds()) {
+        ++misses_;
+        return std::nullopt;
+      }
+    }
+  }
+
+  ++hits_;
+
+  RunResult result;
+  result.verdict = entry.verdict;
+  result.steps = entry.steps;
+  result.depth = entry.depth;
+
+  for (const auto& tape_cells : entry.tapes) {
+    Tape tape(tape_alphabet);
+
+    for (int i = 0; i < tape_cells.first; ++i) {
+      tape.move(Move::Right);
+    }
+    for (int i = 0; i > tape_cells.first; --i) {
+      tape.move(Move::Left);
+    }
+
+    for (SymbolId id : tape_cells.cells) {
+      tape.writeId(id);
+      tape.move(Move::Right);
+    }
+
+    while (tape.head() > tape_cells.head) {
+      tape.move(Move::Left);
+    }
+    while (tape.head() < tape_cells.head) {
+      tape.move(Move::Right);
+    }
+
+    result.tapes.push_back(std::move(tape));
+  }
+
+  return result;
+}
+
+/*!
+ *  Store the result of the machine for the input.
+ */
+void ResultCache::insert(std::uint64_t machine,
+                         const std::vector<SymbolId>& input,
+                         const RunResult& result) {
+  Entry entry{result.verdict, result.steps, result.depth, {}};
+
+  if (store_tapes_) {
+    for (const auto& tape : result.tapes) {
+      TapeCells tape_cells{tape.head(), (tape.empty()) ? 0 : tape.firstWritten(), {}};
+      for (int i = tape.firstWritten(); i <= tape.lastWritten(); ++i) {
+        tape_cells.cells.push_back(tape.peekId(i));
+      }
+
+      entry.tapes.push_back(std::move(tape_cells));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[{machine, input}] = std::move(entry);
+}
+
+/*!
+ *  Remove all the results.
+ */
+void ResultCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+}
+
+/*!
+ *  Add the results stored on a file. Does nothing if the file doesn't exist.
+ *
+ *  !WARNING: Throw if the file isn't a valid cache file.
+ */
+void ResultCache::load(const std::string& file_path) {
+  std::ifstream file(file_path, std::ios::binary);
+  if (!file.is_open()) {
+    return;
+  }
+
+  char magic[sizeof(file_magic)] = {};
+  file.read(magic, sizeof(magic));
+  if (!file || std::memcmp(magic, file_magic, sizeof(magic)) != 0) {
+    throw std::runtime_error("Not a result cache file: " + file_path);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto num_entries = readValue<std::uint64_t>(file);
+  for (std::uint64_t i = 0; i < num_entries; ++i) {
+    Key key;
+    key.machine = readValue<std::uint64_t>(file);
+    key.input = readVector<SymbolId>(file);
+
+    Entry entry;
+    auto verdict = readValue<std::uint8_t>(file);
+    if (verdict > static_cast<std::uint8_t>(Verdict::Undecided)) {
+      throw std::runtime_error("Corrupt cache file: " + file_path);
+    }
+    entry.verdict = static_cast<Verdict>(verdict);
+    entry.steps = readValue<std::uint64_t>(file);
+    entry.depth = readValue<std::uint64_t>(file);
+
+    // Each tape takes its head, first cell and number of cells at least
+    auto num_tapes = readValue<std::uint32_t>(file);
+    if (num_tapes > bytesLeft(file) / (2 * sizeof(std::int32_t) + sizeof(std::uint64_t))) {
+      throw std::runtime_error("Truncated cache file.");
+    }
+
+    for (std::uint32_t t = 0; t < num_tapes; ++t) {
+      TapeCells tape_cells;
+      tape_cells.head = readValue<std::int32_t>(file);
+      tape_cells.first = readValue<std::int32_t>(file);
+      tape_cells.cells = readVector<SymbolId>(file);
+
+      entry.tapes.push_back(std::move(tape_cells));
+    }
+
+    entries_[std::move(key)] = std::move(entry);
+  }
+}
+
+/*!
+ *  Write all the results to a file.
+ *
+ *  !WARNING: Throw if the file can't be written.
+ */
+void ResultCache::save(const std::string& file_path) const {
+  std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("Can't write cache file: " + file_path);
+  }
+
+  file.write(file_magic, sizeof(file_magic));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  writeValue<std::uint64_t>(file, entries_.size());
+  for (const auto& e_pair : entries_) {
+    const Key& key = e_pair.first;
+    const Entry& entry = e_pair.second;
+
+    writeValue(file, key.machine);
+    writeVector(file, key.input);
+
+    writeValue(file, static_cast<std::uint8_t>(entry.verdict));
+    writeValue(file, entry.steps);
+    writeValue(file, entry.depth);
+
+    writeValue<std::uint32_t>(file, entry.tapes.size());
+    for (const auto& tape_cells : entry.tapes) {
+      writeValue(file, tape_cells.head);
+      writeValue(file, tape_cells.first);
+      writeVector(file, tape_cells.cells);
+    }
+  }
+
+  if (!file) {
+    throw std::runtime_error("Can't write cache file: " + file_path);
+  }
+}
+
+bool ResultCache::Key::operator==(const Key& other) const {
+  return machine == other.machine && input == other.input;
+}
+
+size_t ResultCache::KeyHash::operator()(const Key& key) const {
+  size_t seed = std::hash<std::uint64_t>()(key.machine);
+  for (SymbolId id : key.input) {
+    seed ^= id + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+
+  return seed;
+}
+
+}  // namespace turing
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/result.hpp"
+
+namespace turing {
+
+class ResultCache {
+public:
+  explicit ResultCache(bool store_tapes = true);
+
+  ResultCache(const ResultCache&) = delete;
+  ResultCache& operator=(const ResultCache&) = delete;
+
+  bool storesTapes() const;
+
+  size_t size() const;
+  std::uint64_t hits() const;
+  std::uint64_t misses() const;
+
+  std::optional<RunResult> find(std::uint64_t machine,
+                                const std::vector<SymbolId>& input,
+                                const Alphabet& tape_alphabet);
+  void insert(std::uint64_t machine,
+              const std::vector<SymbolId>& input,
+              const RunResult& result);
+
+  void clear();
+
+  void load(const std::string& file_path);
+  void save(const std::string& file_path) const;
+
+private:
+  struct Key {
+    std::uint64_t machine;
+    std::vector<SymbolId> input;
+
+    bool operator==(const Key& other) const;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  // Written cells and head of a Tape
+  struct TapeCells {
+    std::int32_t head;
+    std::int32_t first;
+    std::vector<SymbolId> cells;
+  };
+
+  struct Entry {
+    Verdict verdict;
+    std::uint64_t steps;
+    std::uint64_t depth;
+    std::vector<TapeCells> tapes;
+  };
+
+private:
+  const bool store_tapes_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+
+  std::atomic<std::uint64_t> hits_{0};
+  std::atomic<std::uint64_t> misses_{0};
+};
+
+}  // namespace turing
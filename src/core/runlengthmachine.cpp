@@ -0,0 +1,111 @@
+#include "runlengthmachine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "data/runtape.hpp"
+
+namespace turing {
+
+/*!
+ *  \class RunLengthMachine
+ *  \brief Run a deterministic single-tape machine on a run-length encoded tape.
+ *
+ *  A transition that goes back to its own state and moves the head (p.e. "q0 1 q0 1 R")
+ *  keeps firing while the head reads the same symbol. It's applied to the whole run of
+ *  that symbol at once, counting a step for each cell crossed.
+ *
+ *  A sweep over the blanks at the end of the tape never ends. With a budget of steps,
+ *  it's done up to the budget at once. Without one, the blanks are crossed step by
+ *  step, as the search does, until the time budget is exhausted (Or forever).
+ *
+ *  Only deterministic single-tape machines are supported (See "supports").
+ */
+
+/*!
+ *  Prepare to run the machine.
+ */
+RunLengthMachine::RunLengthMachine(const CompiledMachine& machine) : machine_(machine) {}
+
+/*!
+ *  Check if the machine can be run on a run-length encoded tape.
+ */
+bool RunLengthMachine::supports(const CompiledMachine& machine) {
+  return machine.numTapes() == 1 && machine.deterministic();
+}
+
+/*!
+ *  Run the machine from the initial state and the given tapes.
+ */
+RunResult RunLengthMachine::run(const std::vector<Tape>& tapes, const Limits& limits) const {
+  RunResult result;
+  result.tapes = tapes;
+
+  StateId state = machine_.initialState();
+  if (state == CompiledMachine::no_state) {
+    return result;
+  }
+
+  RunTape tape(tapes[0]);
+
+  const std::uint64_t max_steps = limits.deterministicSteps();
+
+  const auto start_time = std::chrono::steady_clock::now();
+  std::uint64_t iterations = 0;
+
+  while (!machine_.isFinal(state)) {
+    if (limits.max_time.count() && (++iterations % 1024) == 0 &&
+        std::chrono::steady_clock::now() - start_time >= limits.max_time) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    auto range = machine_.transitions(state, tape.peekId());
+    if (range.empty()) {
+      result.verdict = Verdict::Rejected;
+      return result;
+    }
+
+    // Steps that can be done before running out of budget
+    std::uint64_t budget = max_steps - result.steps;
+
+    const CompiledMachine::Action& action = *machine_.actions(range.first);
+
+    // Loops on the same state: cross the whole run
+    std::uint64_t cells = 1;
+    if (action.next_state == state && action.move != Move::Stop) {
+      cells = tape.runLength(action.move);
+    }
+
+    // Without a budget of steps, the blanks are crossed one by one
+    if (cells == RunTape::unbounded &&
+        max_steps == std::numeric_limits<std::uint64_t>::max()) {
+      cells = 1;
+    }
+
+    if (cells > budget || cells == RunTape::unbounded) {
+      result.steps += std::min(cells, budget);
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    if (cells == 1) {
+      tape.writeId(action.write);
+      tape.move(action.move);
+    } else {
+      tape.sweep(action.write, action.move, cells);
+    }
+
+    state = action.next_state;
+    result.steps += cells;
+  }
+
+  tape.writeTo(result.tapes[0]);
+
+  result.verdict = Verdict::Accepted;
+  result.depth = result.steps;
+  return result;
+}
+
+}  // namespace turing
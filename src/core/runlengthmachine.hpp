@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+
+#include "core/compiledmachine.hpp"
+#include "core/result.hpp"
+
+namespace turing {
+
+class RunLengthMachine {
+public:
+  explicit RunLengthMachine(const CompiledMachine& machine);
+
+  static bool supports(const CompiledMachine& machine);
+
+  RunResult run(const std::vector<Tape>& tapes, const Limits& limits) const;
+
+private:
+  const CompiledMachine& machine_;
+};
+
+}  // namespace turing
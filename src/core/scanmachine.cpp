@@ -0,0 +1,198 @@
+#include "scanmachine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "data/tracktape.hpp"
+
+namespace turing {
+
+/*!
+ *  \class ScanMachine
+ *  \brief Run a deterministic single-tape machine, crossing its scan loops at once.
+ *
+ *  A scan loop is a set of transitions of a state that go back to the state without
+ *  changing the symbol read, all moving in the same direction (p.e. "q0 0 q0 0 R" and
+ *  "q0 1 q0 1 R"). The state keeps crossing cells until it reads a symbol out of the
+ *  set, so the cells crossed are found with a SymbolScanner over the contiguous cells
+ *  of the tape (A TrackTape of a single track), counting a step for each one.
+ *
+ *  A scan over the blanks at the end of the tape never ends. With a budget of steps,
+ *  it's crossed up to the budget at once. Without one, the blanks are crossed step by
+ *  step, as the search does, until the time budget is exhausted (Or forever).
+ *
+ *  Only deterministic single-tape machines with scan loops are supported (See
+ *  "supports").
+ */
+
+namespace {
+
+/*!
+ *  Return the direction of the transition from "state" reading "symbol" if it's part
+ *  of a scan loop, or Stop if it isn't.
+ */
+Move scanMove(const CompiledMachine& machine, StateId state, SymbolId symbol) {
+  auto range = machine.transitions(state, symbol);
+  if (range.size() != 1) {
+    return Move::Stop;
+  }
+
+  const CompiledMachine::Action& action = *machine.actions(range.first);
+  if (action.next_state != state || action.write != symbol) {
+    return Move::Stop;
+  }
+
+  return action.move;
+}
+
+}  // namespace
+
+/*!
+ *  Prepare to run the machine, finding the scan loop of each state. If a state has
+ *  loops in both directions, the one with more symbols is used (The other one is run
+ *  step by step).
+ */
+ScanMachine::ScanMachine(const CompiledMachine& machine)
+    : machine_(machine), scans_(machine.numStates()) {
+  for (StateId state = 0; state < machine.numStates(); ++state) {
+    std::vector<SymbolId> right, left;
+    for (SymbolId symbol = 0; symbol < machine.numSymbols(); ++symbol) {
+      Move move = scanMove(machine, state, symbol);
+      if (move == Move::Right) {
+        right.push_back(symbol);
+      } else if (move == Move::Left) {
+        left.push_back(symbol);
+      }
+    }
+
+    if (right.empty() && left.empty()) {
+      continue;
+    }
+
+    if (right.size() >= left.size()) {
+      scans_[state] = {Move::Right, SymbolScanner(right)};
+    } else {
+      scans_[state] = {Move::Left, SymbolScanner(left)};
+    }
+  }
+}
+
+/*!
+ *  Check if the machine can be run crossing its scan loops.
+ */
+bool ScanMachine::supports(const CompiledMachine& machine) {
+  if (machine.numTapes() != 1 || !machine.deterministic()) {
+    return false;
+  }
+
+  for (StateId state = 0; state < machine.numStates(); ++state) {
+    for (SymbolId symbol = 0; symbol < machine.numSymbols(); ++symbol) {
+      if (scanMove(machine, state, symbol) != Move::Stop) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+/*!
+ *  Return the number of states with a scan loop.
+ */
+size_t ScanMachine::numScans() const {
+  return std::count_if(scans_.begin(), scans_.end(), [](const Scan& scan) {
+    return scan.move != Move::Stop;
+  });
+}
+
+/*!
+ *  Run the machine from the initial state and the given tapes.
+ */
+RunResult ScanMachine::run(const std::vector<Tape>& tapes, const Limits& limits) const {
+  RunResult result;
+  result.tapes = tapes;
+
+  StateId state = machine_.initialState();
+  if (state == CompiledMachine::no_state) {
+    return result;
+  }
+
+  TrackTape tape(tapes, machine_.numSymbols());
+
+  const std::uint64_t max_steps = limits.deterministicSteps();
+  const std::uint64_t unlimited = std::numeric_limits<std::uint64_t>::max();
+
+  const auto start_time = std::chrono::steady_clock::now();
+  std::uint64_t iterations = 0;
+
+  while (!machine_.isFinal(state)) {
+    if (limits.max_time.count() && (++iterations % 1024) == 0 &&
+        std::chrono::steady_clock::now() - start_time >= limits.max_time) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    const SymbolId symbol = tape.peekId(0);
+    const Scan& scan = scans_[state];
+
+    if (scan.move != Move::Stop && scan.symbols.contains(symbol)) {
+      std::uint64_t budget = max_steps - result.steps;
+      size_t cells = tape.span(scan.move, scan.symbols);
+
+      // Blanks up to the end of the tape
+      bool endless = cells == tape.available(scan.move) &&
+                     scan.symbols.contains(Alphabet::blank_id);
+
+      if (cells > budget || (endless && max_steps != unlimited)) {
+        result.steps = max_steps;
+        result.verdict = Verdict::Undecided;
+        return result;
+      }
+
+      // Without a budget of steps, the blanks are crossed one by one
+      if (endless) {
+        for (;;) {
+          tape.move(scan.move);
+          ++result.steps;
+
+          if (limits.max_time.count() && (result.steps % 1024) == 0 &&
+              std::chrono::steady_clock::now() - start_time >= limits.max_time) {
+            result.verdict = Verdict::Undecided;
+            return result;
+          }
+        }
+      }
+
+      tape.cross(scan.move, cells);
+      result.steps += cells;
+      continue;
+    }
+
+    auto range = machine_.transitions(state, symbol);
+    if (range.empty()) {
+      result.verdict = Verdict::Rejected;
+      return result;
+    }
+
+    if (result.steps == max_steps) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    const CompiledMachine::Action& action = *machine_.actions(range.first);
+    tape.write(tape.key(&action.write), &action.write);
+    tape.move(action.move);
+
+    state = action.next_state;
+    ++result.steps;
+  }
+
+  tape.writeTo(result.tapes);
+
+  result.verdict = Verdict::Accepted;
+  result.depth = result.steps;
+  return result;
+}
+
+}  // namespace turing
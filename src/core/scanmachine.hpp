@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include "core/compiledmachine.hpp"
+#include "core/result.hpp"
+#include "data/symbolscanner.hpp"
+
+namespace turing {
+
+class ScanMachine {
+public:
+  explicit ScanMachine(const CompiledMachine& machine);
+
+  static bool supports(const CompiledMachine& machine);
+
+  size_t numScans() const;
+
+  RunResult run(const std::vector<Tape>& tapes, const Limits& limits) const;
+
+private:
+  // Cells crossed by the state while it reads one of "symbols" (See SymbolScanner)
+  struct Scan {
+    Move move{Move::Stop};
+    SymbolScanner symbols;
+  };
+
+private:
+  const CompiledMachine& machine_;
+
+  // Scan loop of each state. The move is Stop if the state doesn't have one.
+  std::vector<Scan> scans_;
+};
+
+}  // namespace turing
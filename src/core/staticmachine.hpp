@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "core/result.hpp"
+#include "utils/utils.hpp"
+
+namespace turing {
+
+/*!
+ *  Transition of a StaticMachine: from "state" reading "read", go to "next_state"
+ *  writing "write" and moving the head.
+ */
+struct StaticTransition {
+  StateId state;
+  SymbolId read;
+  StateId next_state;
+  SymbolId write;
+  Move move;
+};
+
+/*!
+ *  Result of a run of a StaticMachine. The tape holds (at least) the cells visited by
+ *  the head, starting at position "first" (The input starts at position 0).
+ */
+struct StaticResult {
+  Verdict verdict{Verdict::Rejected};
+  std::uint64_t steps{0};
+
+  std::vector<SymbolId> cells;
+  std::int64_t first{0};
+  std::int64_t head{0};
+
+  bool accepted() const { return verdict == Verdict::Accepted; }
+
+  SymbolId at(std::int64_t position) const {
+    position -= first;
+    return (position >= 0 && position < static_cast<std::int64_t>(cells.size()))
+               ? cells[position]
+               : SymbolId{0};
+  }
+};
+
+/*!
+ *  \class StaticMachine
+ *  \brief Deterministic single-tape machine defined at compile time.
+ *
+ *  States and symbols are plain ids (The blank symbol is 0), and the transitions are
+ *  laid out on a dense table indexed by (state, symbol) when the machine is
+ *  constructed. Declared "constexpr", the table is built by the compiler: there's
+ *  nothing to parse nor allocate at startup, and the optimizer sees the table.
+ *
+ *      constexpr StaticMachine<2, 2> machine(
+ *          0,         // Initial state
+ *          {1},       // Final states
+ *          {{0, 1, 0, 1, Move::Right},    // (state, read, next state, write, move)
+ *           {0, 0, 1, 0, Move::Stop}});
+ *
+ *      StaticResult result = machine.run({1, 1, 1});
+ *
+ *  A run gives the same verdict and steps as Turing::run on the same machine. An
+ *  invalid definition (Ids out of range, or two transitions for the same state and
+ *  symbol) doesn't compile when the machine is constexpr, and throws otherwise.
+ */
+template <StateId NumStates, SymbolId NumSymbols>
+class StaticMachine {
+public:
+  static_assert(NumStates > 0 && NumSymbols > 0,
+                "The machine needs states and symbols");
+
+  constexpr StaticMachine(StateId initial_state,
+                          std::initializer_list<StateId> final_states,
+                          std::initializer_list<StaticTransition> transitions)
+      : initial_state_(initial_state) {
+    if (initial_state >= NumStates) {
+      throw std::out_of_range("Initial state out of range.");
+    }
+
+    for (StateId state : final_states) {
+      if (state >= NumStates) {
+        throw std::out_of_range("Final state out of range.");
+      }
+      final_[state] = true;
+    }
+
+    for (const StaticTransition& t : transitions) {
+      if (t.state >= NumStates || t.next_state >= NumStates || t.read >= NumSymbols ||
+          t.write >= NumSymbols) {
+        throw std::out_of_range("Transition out of range.");
+      }
+
+      Entry& entry = table_[t.state * NumSymbols + t.read];
+      if (entry.defined) {
+        throw std::logic_error("Two transitions for the same state and symbol.");
+      }
+
+      entry = {t.next_state, t.write, t.move, true};
+      ++num_transitions_;
+    }
+  }
+
+  static constexpr StateId numStates() { return NumStates; }
+  static constexpr SymbolId numSymbols() { return NumSymbols; }
+  constexpr size_t numTransitions() const { return num_transitions_; }
+
+  constexpr StateId initialState() const { return initial_state_; }
+  constexpr bool isFinal(StateId state) const { return final_[state]; }
+
+  /*!
+   *  Run the machine on the input (Ids of the tape symbols), doing at most
+   *  "max_steps" steps (0 = unlimited).
+   *
+   *  !WARNING: Throw if an id of the input is out of range.
+   */
+  StaticResult run(std::initializer_list<SymbolId> input,
+                   std::uint64_t max_steps = 0) const {
+    return run(input.begin(), input.size(), max_steps);
+  }
+
+  StaticResult run(const std::vector<SymbolId>& input,
+                   std::uint64_t max_steps = 0) const {
+    return run(input.data(), input.size(), max_steps);
+  }
+
+  StaticResult run(const SymbolId* input,
+                   size_t size,
+                   std::uint64_t max_steps = 0) const {
+    for (size_t i = 0; i < size; ++i) {
+      if (input[i] >= NumSymbols) {
+        throw std::out_of_range("Input symbol out of range.");
+      }
+    }
+
+    StaticResult result;
+    result.cells.assign(input, input + size);
+    if (result.cells.empty()) {
+      result.cells.push_back(0);
+    }
+
+    const std::uint64_t limit =
+        (max_steps) ? max_steps : std::numeric_limits<std::uint64_t>::max();
+
+    // Index of the head on the cells
+    size_t head = 0;
+    StateId state = initial_state_;
+
+    while (true) {
+      if (final_[state]) {
+        result.verdict = Verdict::Accepted;
+        break;
+      }
+
+      const Entry& entry = table_[state * NumSymbols + result.cells[head]];
+      if (!entry.defined) {
+        result.verdict = Verdict::Rejected;
+        break;
+      }
+
+      if (result.steps == limit) {
+        result.verdict = Verdict::Undecided;
+        break;
+      }
+
+      ++result.steps;
+      result.cells[head] = entry.write;
+      state = entry.next_state;
+
+      if (entry.move == Move::Right) {
+        if (++head == result.cells.size()) {
+          result.cells.resize(result.cells.size() * 2, 0);
+        }
+      } else if (entry.move == Move::Left) {
+        // Grow to the left doubling the cells, so it's amortized as to the right
+        if (head == 0) {
+          size_t grow = result.cells.size();
+          result.cells.insert(result.cells.begin(), grow, 0);
+          result.first -= grow;
+          head = grow;
+        }
+        --head;
+      }
+    }
+
+    result.head = result.first + static_cast<std::int64_t>(head);
+    return result;
+  }
+
+private:
+  struct Entry {
+    StateId next_state{0};
+    SymbolId write{0};
+    Move move{Move::Stop};
+    bool defined{false};
+  };
+
+private:
+  StateId initial_state_;
+  size_t num_transitions_{0};
+
+  std::array<bool, NumStates> final_{};
+  std::array<Entry, size_t(NumStates) * NumSymbols> table_{};
+};
+
+}  // namespace turing
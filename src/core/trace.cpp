@@ -0,0 +1,587 @@
+#include "trace.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "core/compiledmachine.hpp"
+
+namespace turing {
+
+/*!
+ *  \class TraceWriter
+ *  \brief Binary trace of the runs of a machine.
+ *
+ *  Instead of printing the whole configuration on every step (As the debug mode does),
+ *  only the changes are written: the transition taken, the state reached, and the
+ *  symbol read, the symbol written and the move done on each tape. Numbers are
+ *  written as variable-length integers, so a step of a single tape machine usually
+ *  takes 5 bytes. The records are buffered, and written to the file in large blocks.
+ *
+ *  The file starts with a header describing the machine (Symbols, states and
+ *  transitions), so it can be replayed without the machine definition. Then, for each
+ *  run: a Run record with the initial tapes, the Step records, and an End record with
+ *  the verdict. When the depth-first search goes back to a previous configuration, a
+ *  Backtrack record with its depth is written before the next Step.
+ *
+ *  A trace is written by a single run at a time. It isn't thread-safe.
+ */
+
+/*!
+ *  \class TraceReader
+ *  \brief Replays a trace written by a TraceWriter.
+ *
+ *  The configuration of each run is rebuilt step by step from the initial tapes. To go
+ *  back on Backtrack records, the changes of the steps on the current path are kept
+ *  on an undo log (Only for non-deterministic machines).
+ *
+ *  Undoing a step writes back the symbol overwritten, so the range of written cells
+ *  shown can be wider than the one of the original run.
+ *
+ *  The file isn't trusted: the counts are bounded by the bytes left on it, and the
+ *  ids, moves and positions are checked before they are used. The heads are placed on
+ *  their positions at once (See Tape::seek), however far they are.
+ */
+
+namespace {
+
+// Identifies the trace files (And its version)
+constexpr char file_magic[] = "TURTRACE1";
+
+Move opposite(Move move) {
+  switch (move) {
+    case Move::Left:
+      return Move::Right;
+    case Move::Right:
+      return Move::Left;
+    default:
+      return Move::Stop;
+  }
+}
+
+}  // namespace
+
+/*!
+ *  Create the trace file, and write the description of the machine.
+ *
+ *  !WARNING: Throw if the file can't be written.
+ */
+TraceWriter::TraceWriter(const std::string& file_path, const CompiledMachine& machine)
+    : file_(file_path, std::ios::binary | std::ios::trunc) {
+  if (!file_.is_open()) {
+    throw std::runtime_error("Can't write trace file: " + file_path);
+  }
+
+  buffer_.reserve(buffer_size);
+
+  file_.write(file_magic, sizeof(file_magic));
+
+  std::uint64_t fingerprint = machine.fingerprint();
+  file_.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+
+  putVarint(machine.numTapes());
+  put(machine.deterministic());
+
+  putVarint(machine.numSymbols());
+  for (SymbolId id = 0; id < machine.numSymbols(); ++id) {
+    putString(machine.tapeAlphabet().symbol(id));
+  }
+
+  putVarint(machine.numStates());
+  for (StateId state = 0; state < machine.numStates(); ++state) {
+    putString(machine.stateName(state));
+  }
+
+  putVarint(machine.numTransitions());
+  for (TransitionId transition = 0; transition < machine.numTransitions();
+       ++transition) {
+    putString(machine.transitionName(transition));
+  }
+}
+
+/*!
+ *  Write the records that are still buffered.
+ */
+TraceWriter::~TraceWriter() {
+  flush();
+}
+
+/*!
+ *  Start a new run from the initial configuration of the machine.
+ */
+void TraceWriter::beginRun(const CompiledMachine& machine,
+                           const std::vector<Tape>& tapes) {
+  put(static_cast<std::uint8_t>(TraceRecord::Run));
+
+  for (const auto& tape : tapes) {
+    int first = (tape.empty()) ? 0 : tape.firstWritten();
+
+    putSigned(tape.head());
+    putSigned(first);
+    putVarint((tape.empty()) ? 0 : tape.lastWritten() - first + 1);
+    for (int i = first; !tape.empty() && i <= tape.lastWritten(); ++i) {
+      putVarint(tape.peekId(i));
+    }
+  }
+
+  putVarint(machine.initialState());
+  depth_ = 0;
+}
+
+/*!
+ *  Write the step done by the transition on the tapes (Before applying it). "depth" is
+ *  the depth of the configuration the transition is taken from.
+ */
+void TraceWriter::step(const CompiledMachine& machine,
+                       TransitionId transition,
+                       const std::vector<Tape>& tapes,
+                       std::uint64_t depth) {
+  if (depth < depth_) {
+    put(static_cast<std::uint8_t>(TraceRecord::Backtrack));
+    putVarint(depth);
+  }
+
+  const CompiledMachine::Action* actions = machine.actions(transition);
+
+  put(static_cast<std::uint8_t>(TraceRecord::Step));
+  putVarint(transition);
+  putVarint(actions[0].next_state);
+  for (size_t i = 0; i < tapes.size(); ++i) {
+    putVarint(tapes[i].peekId());
+    putVarint(actions[i].write);
+    put(static_cast<std::uint8_t>(actions[i].move));
+  }
+
+  depth_ = depth + 1;
+}
+
+/*!
+ *  End the current run with its result.
+ */
+void TraceWriter::endRun(const RunResult& result) {
+  put(static_cast<std::uint8_t>(TraceRecord::End));
+  put(static_cast<std::uint8_t>(result.verdict));
+  putVarint(result.steps);
+}
+
+/*!
+ *  Write the buffered records to the file.
+ */
+void TraceWriter::flush() {
+  file_.write(buffer_.data(), buffer_.size());
+  file_.flush();
+  buffer_.clear();
+}
+
+void TraceWriter::put(std::uint8_t byte) {
+  buffer_.push_back(static_cast<char>(byte));
+  if (buffer_.size() >= buffer_size) {
+    file_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+}
+
+/*!
+ *  Write the value on groups of 7 bits, lowest first. The highest bit of each byte is
+ *  set if more bytes follow.
+ */
+void TraceWriter::putVarint(std::uint64_t value) {
+  while (value >= 0x80) {
+    put(static_cast<std::uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  put(static_cast<std::uint8_t>(value));
+}
+
+/*!
+ *  Write a signed value, zig-zag encoded so small negative values are short too.
+ */
+void TraceWriter::putSigned(std::int64_t value) {
+  putVarint((static_cast<std::uint64_t>(value) << 1) ^
+            static_cast<std::uint64_t>(value >> 63));
+}
+
+void TraceWriter::putString(const std::string& str) {
+  putVarint(str.size());
+  for (char c : str) {
+    put(static_cast<std::uint8_t>(c));
+  }
+}
+
+/*!
+ *  Open a trace file, and read the description of the machine.
+ *
+ *  !WARNING: Throw if the file can't be read or isn't a trace file.
+ */
+TraceReader::TraceReader(const std::string& file_path)
+    : file_(file_path, std::ios::binary) {
+  if (!file_.is_open()) {
+    throw std::runtime_error("Can't read trace file: " + file_path);
+  }
+
+  char magic[sizeof(file_magic)] = {};
+  file_.read(magic, sizeof(magic));
+  if (!file_ || std::memcmp(magic, file_magic, sizeof(magic)) != 0) {
+    throw std::runtime_error("Not a trace file: " + file_path);
+  }
+
+  file_size_ = file_.rdbuf()->pubseekoff(0, std::ios::end, std::ios::in);
+  file_.rdbuf()->pubseekpos(sizeof(file_magic), std::ios::in);
+
+  file_.read(reinterpret_cast<char*>(&fingerprint_), sizeof(fingerprint_));
+
+  std::uint64_t num_tapes = getVarint();
+  if (num_tapes == 0 || num_tapes > std::numeric_limits<int>::max()) {
+    throw std::runtime_error("Corrupt trace file: invalid number of tapes.");
+  }
+  num_tapes_ = static_cast<int>(num_tapes);
+  deterministic_ = get();
+
+  // The blank symbol is always the first one
+  std::vector<Symbol> symbols(getCount());
+  for (auto& symbol : symbols) {
+    symbol = getString();
+  }
+  if (symbols.empty()) {
+    throw std::runtime_error("Invalid trace file: " + file_path);
+  }
+
+  tape_alphabet_.setBlank(symbols[0]);
+  tape_alphabet_.setSymbols(std::vector<Symbol>(symbols.begin() + 1, symbols.end()));
+
+  state_names_.resize(getCount());
+  for (auto& name : state_names_) {
+    name = getString();
+  }
+
+  transition_names_.resize(getCount());
+  for (auto& name : transition_names_) {
+    name = getString();
+  }
+}
+
+/*!
+ *  Return the fingerprint of the machine that made the trace.
+ */
+std::uint64_t TraceReader::fingerprint() const {
+  return fingerprint_;
+}
+
+/*!
+ *  Return the number of tapes of the machine.
+ */
+int TraceReader::numTapes() const {
+  return num_tapes_;
+}
+
+/*!
+ *  Return the alphabet of the tapes of the machine.
+ */
+const Alphabet& TraceReader::tapeAlphabet() const {
+  return tape_alphabet_;
+}
+
+/*!
+ *  Return the name of a state of the machine.
+ */
+const std::string& TraceReader::stateName(StateId state) const {
+  return state_names_.at(state);
+}
+
+/*!
+ *  Return the description of a transition of the machine.
+ */
+const std::string& TraceReader::transitionName(TransitionId transition) const {
+  return transition_names_.at(transition);
+}
+
+/*!
+ *  Go to the initial configuration of the next run, skipping the rest of the current
+ *  one. Return false if there aren't more runs.
+ *
+ *  !WARNING: Throw if the file is truncated or corrupt.
+ */
+bool TraceReader::nextRun() {
+  while (!finished_) {
+    nextStep();
+  }
+
+  if (file_.rdbuf()->sgetc() == std::char_traits<char>::eof()) {
+    return false;
+  }
+
+  if (get() != static_cast<std::uint8_t>(TraceRecord::Run)) {
+    throw std::runtime_error("Corrupt trace file: expected the start of a run.");
+  }
+
+  // Each tape takes its head, first cell and number of cells at least
+  if (static_cast<std::uint64_t>(num_tapes_) > bytesLeft() / 3) {
+    throw std::runtime_error("Truncated trace file.");
+  }
+
+  tapes_.assign(num_tapes_, Tape(tape_alphabet_));
+  for (auto& tape : tapes_) {
+    std::int64_t head = getPosition();
+    std::int64_t first = getPosition();
+    std::uint64_t num_cells = getCount();
+    if (first + static_cast<std::int64_t>(num_cells) > std::numeric_limits<int>::max()) {
+      throw std::runtime_error("Corrupt trace file: invalid position.");
+    }
+
+    tape.seek(static_cast<int>(first));
+    for (; num_cells > 0; --num_cells) {
+      tape.writeId(getSymbol());
+      tape.move(Move::Right);
+    }
+
+    tape.seek(static_cast<int>(head));
+  }
+
+  state_ = getState();
+  steps_ = 0;
+  depth_ = 0;
+  finished_ = false;
+  verdict_ = Verdict::Undecided;
+
+  undo_.clear();
+  undo_symbols_.clear();
+  undo_moves_.clear();
+
+  return true;
+}
+
+/*!
+ *  Apply the next step of the current run. Return false if the run has ended.
+ *
+ *  !WARNING: Throw if the file is truncated or corrupt.
+ */
+bool TraceReader::nextStep() {
+  if (finished_) {
+    return false;
+  }
+
+  auto record = static_cast<TraceRecord>(get());
+
+  if (record == TraceRecord::Backtrack) {
+    backtrack(getVarint());
+    record = static_cast<TraceRecord>(get());
+  }
+
+  if (record == TraceRecord::End) {
+    std::uint8_t verdict = get();
+    if (verdict > static_cast<std::uint8_t>(Verdict::Undecided)) {
+      throw std::runtime_error("Corrupt trace file: invalid verdict.");
+    }
+
+    verdict_ = static_cast<Verdict>(verdict);
+    getVarint();
+    finished_ = true;
+    return false;
+  }
+
+  if (record != TraceRecord::Step) {
+    throw std::runtime_error("Corrupt trace file: expected a step.");
+  }
+
+  std::uint64_t transition = getVarint();
+  if (transition >= transition_names_.size()) {
+    throw std::runtime_error("Corrupt trace file: invalid transition.");
+  }
+
+  if (!deterministic_) {
+    undo_.push_back({state_, last_transition_});
+  }
+
+  state_ = getState();
+  for (auto& tape : tapes_) {
+    SymbolId read = getSymbol();
+    SymbolId write = getSymbol();
+
+    std::uint8_t move_byte = get();
+    if (move_byte > static_cast<std::uint8_t>(Move::Stop)) {
+      throw std::runtime_error("Corrupt trace file: invalid move.");
+    }
+    auto move = static_cast<Move>(move_byte);
+
+    tape.writeId(write);
+    tape.move(move);
+
+    if (!deterministic_) {
+      undo_symbols_.push_back(read);
+      undo_moves_.push_back(move);
+    }
+  }
+
+  last_transition_ = static_cast<TransitionId>(transition);
+  ++steps_;
+  ++depth_;
+
+  return true;
+}
+
+/*!
+ *  Return the state of the current configuration.
+ */
+StateId TraceReader::state() const {
+  return state_;
+}
+
+/*!
+ *  Return the tapes of the current configuration.
+ */
+const std::vector<Tape>& TraceReader::tapes() const {
+  return tapes_;
+}
+
+/*!
+ *  Return the number of steps replayed on the current run.
+ */
+std::uint64_t TraceReader::steps() const {
+  return steps_;
+}
+
+/*!
+ *  Return the length of the computation path of the current configuration.
+ */
+std::uint64_t TraceReader::depth() const {
+  return depth_;
+}
+
+/*!
+ *  Return the transition of the last step replayed.
+ */
+TransitionId TraceReader::lastTransition() const {
+  return last_transition_;
+}
+
+/*!
+ *  Check if the current run has ended.
+ */
+bool TraceReader::finished() const {
+  return finished_;
+}
+
+/*!
+ *  Return the verdict of the current run. Only valid once it has ended.
+ */
+Verdict TraceReader::verdict() const {
+  return verdict_;
+}
+
+std::uint8_t TraceReader::get() {
+  auto c = file_.rdbuf()->sbumpc();
+  if (c == std::char_traits<char>::eof()) {
+    throw std::runtime_error("Truncated trace file.");
+  }
+
+  return static_cast<std::uint8_t>(c);
+}
+
+std::uint64_t TraceReader::getVarint() {
+  std::uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    std::uint8_t byte = get();
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+
+  throw std::runtime_error("Corrupt trace file: invalid number.");
+}
+
+std::int64_t TraceReader::getSigned() {
+  std::uint64_t value = getVarint();
+  return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+/*!
+ *  Read the number of items that follow, checking that it isn't bigger than the bytes
+ *  left on the file (Each item takes a byte at least).
+ */
+std::uint64_t TraceReader::getCount() {
+  std::uint64_t count = getVarint();
+  if (count > bytesLeft()) {
+    throw std::runtime_error("Truncated trace file.");
+  }
+
+  return count;
+}
+
+/*!
+ *  Read a position of a tape, checking that it fits on a Tape.
+ */
+std::int64_t TraceReader::getPosition() {
+  std::int64_t position = getSigned();
+  if (position < std::numeric_limits<int>::min() ||
+      position > std::numeric_limits<int>::max()) {
+    throw std::runtime_error("Corrupt trace file: invalid position.");
+  }
+
+  return position;
+}
+
+SymbolId TraceReader::getSymbol() {
+  std::uint64_t id = getVarint();
+  if (id >= tape_alphabet_.numIds()) {
+    throw std::runtime_error("Corrupt trace file: invalid symbol.");
+  }
+
+  return static_cast<SymbolId>(id);
+}
+
+StateId TraceReader::getState() {
+  std::uint64_t state = getVarint();
+  if (state >= state_names_.size()) {
+    throw std::runtime_error("Corrupt trace file: invalid state.");
+  }
+
+  return static_cast<StateId>(state);
+}
+
+std::string TraceReader::getString() {
+  std::string str(getCount(), '\0');
+  for (char& c : str) {
+    c = static_cast<char>(get());
+  }
+
+  return str;
+}
+
+/*!
+ *  Return the number of bytes left to read on the file.
+ */
+std::uint64_t TraceReader::bytesLeft() {
+  std::streamoff position = file_.rdbuf()->pubseekoff(0, std::ios::cur, std::ios::in);
+  if (position < 0 || position > file_size_) {
+    return 0;
+  }
+
+  return static_cast<std::uint64_t>(file_size_ - position);
+}
+
+/*!
+ *  Undo the steps of the current path until the configuration at "depth".
+ */
+void TraceReader::backtrack(std::uint64_t depth) {
+  if (depth > undo_.size()) {
+    throw std::runtime_error("Corrupt trace file: invalid backtrack.");
+  }
+
+  while (undo_.size() > depth) {
+    for (int i = num_tapes_ - 1; i >= 0; --i) {
+      tapes_[i].move(opposite(undo_moves_.back()));
+      tapes_[i].writeId(undo_symbols_.back());
+      undo_moves_.pop_back();
+      undo_symbols_.pop_back();
+    }
+
+    state_ = undo_.back().state;
+    last_transition_ = undo_.back().transition;
+    undo_.pop_back();
+  }
+
+  depth_ = depth;
+}
+
+}  // namespace turing
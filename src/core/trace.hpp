@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "core/result.hpp"
+#include "data/alphabet.hpp"
+#include "data/tape.hpp"
+#include "utils/utils.hpp"
+
+namespace turing {
+
+class CompiledMachine;
+
+// Kinds of records of a trace file
+enum class TraceRecord : std::uint8_t { Run, Step, Backtrack, End };
+
+class TraceWriter {
+public:
+  TraceWriter(const std::string& file_path, const CompiledMachine& machine);
+  ~TraceWriter();
+
+  TraceWriter(const TraceWriter&) = delete;
+  TraceWriter& operator=(const TraceWriter&) = delete;
+
+  void beginRun(const CompiledMachine& machine, const std::vector<Tape>& tapes);
+  void step(const CompiledMachine& machine,
+            TransitionId transition,
+            const std::vector<Tape>& tapes,
+            std::uint64_t depth);
+  void endRun(const RunResult& result);
+
+  void flush();
+
+private:
+  void put(std::uint8_t byte);
+  void putVarint(std::uint64_t value);
+  void putSigned(std::int64_t value);
+  void putString(const std::string& str);
+
+private:
+  static constexpr size_t buffer_size = 1 << 16;
+
+  std::ofstream file_;
+  std::vector<char> buffer_;
+
+  // Depth of the last configuration written
+  std::uint64_t depth_{0};
+};
+
+class TraceReader {
+public:
+  explicit TraceReader(const std::string& file_path);
+
+  TraceReader(const TraceReader&) = delete;
+  TraceReader& operator=(const TraceReader&) = delete;
+
+  // Machine that made the trace
+  std::uint64_t fingerprint() const;
+  int numTapes() const;
+  const Alphabet& tapeAlphabet() const;
+  const std::string& stateName(StateId state) const;
+  const std::string& transitionName(TransitionId transition) const;
+
+  // Runs
+  bool nextRun();
+  bool nextStep();
+
+  // Configuration of the current run
+  StateId state() const;
+  const std::vector<Tape>& tapes() const;
+  std::uint64_t steps() const;
+  std::uint64_t depth() const;
+  TransitionId lastTransition() const;
+
+  bool finished() const;
+  Verdict verdict() const;
+
+private:
+  // Changes done by a step, to undo it when backtracking
+  struct Undo {
+    StateId state;
+    TransitionId transition;
+  };
+
+  std::uint8_t get();
+  std::uint64_t getVarint();
+  std::int64_t getSigned();
+  std::uint64_t getCount();
+  std::int64_t getPosition();
+  SymbolId getSymbol();
+  StateId getState();
+  std::string getString();
+
+  std::uint64_t bytesLeft();
+
+  void backtrack(std::uint64_t depth);
+
+private:
+  std::ifstream file_;
+  std::streamoff file_size_{0};
+
+  std::uint64_t fingerprint_{0};
+  int num_tapes_{1};
+  bool deterministic_{true};
+  Alphabet tape_alphabet_;
+  std::vector<std::string> state_names_;
+  std::vector<std::string> transition_names_;
+
+  StateId state_{0};
+  std::vector<Tape> tapes_;
+  std::uint64_t steps_{0};
+  std::uint64_t depth_{0};
+  TransitionId last_transition_{0};
+  bool finished_{true};
+  Verdict verdict_{Verdict::Undecided};
+
+  // Undo log of the current path, with the symbol overwritten and the move done on
+  // each tape. Not kept for deterministic machines, as they never backtrack.
+  std::vector<Undo> undo_;
+  std::vector<SymbolId> undo_symbols_;
+  std::vector<Move> undo_moves_;
+};
+
+}  // namespace turing
@@ -0,0 +1,117 @@
+#include "trackmachine.hpp"
+
+#include <chrono>
+
+#include "data/tracktape.hpp"
+
+namespace turing {
+
+/*!
+ *  \class TrackMachine
+ *  \brief Run a deterministic multi-track machine on a TrackTape.
+ *
+ *  When every transition moves all the heads in the same direction, the tapes are
+ *  tracks of a single tape. Each step reads the key of the symbols under the head with
+ *  a single load, looks up the transition by (state, key), and writes the symbols of
+ *  the transition (Whose key is computed beforehand).
+ *
+ *  Only deterministic machines with several tapes and uniform moves, starting with
+ *  all the heads on the same cell, are supported (See "supports").
+ */
+
+/*!
+ *  Prepare to run the machine, numbering the symbols written by each transition.
+ */
+TrackMachine::TrackMachine(const CompiledMachine& machine) : machine_(machine) {
+  const int num_tracks = machine.numTapes();
+
+  writes_.reserve(machine.numTransitions() * num_tracks);
+  write_keys_.reserve(machine.numTransitions());
+
+  for (TransitionId t = 0; t < machine.numTransitions(); ++t) {
+    const CompiledMachine::Action* actions = machine.actions(t);
+
+    std::uint64_t key = 0;
+    for (int i = 0; i < num_tracks; ++i) {
+      writes_.push_back(actions[i].write);
+      key = key * machine.numSymbols() + actions[i].write;
+    }
+    write_keys_.push_back(key);
+  }
+}
+
+/*!
+ *  Check if the machine can be run on a TrackTape from the given tapes.
+ */
+bool TrackMachine::supports(const CompiledMachine& machine,
+                            const std::vector<Tape>& tapes) {
+  if (machine.numTapes() < 2 || !machine.deterministic() || !machine.uniformMoves()) {
+    return false;
+  }
+
+  for (const auto& tape : tapes) {
+    if (tape.head() != tapes[0].head()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*!
+ *  Run the machine from the initial state and the given tapes.
+ */
+RunResult TrackMachine::run(const std::vector<Tape>& tapes, const Limits& limits) const {
+  RunResult result;
+  result.tapes = tapes;
+
+  StateId state = machine_.initialState();
+  if (state == CompiledMachine::no_state) {
+    return result;
+  }
+
+  TrackTape tape(tapes, machine_.numSymbols());
+
+  const int num_tracks = machine_.numTapes();
+  const std::uint64_t keys_per_state = machine_.keysPerState();
+
+  const std::uint64_t max_steps = limits.deterministicSteps();
+
+  const auto start_time = std::chrono::steady_clock::now();
+
+  while (!machine_.isFinal(state)) {
+    auto range = machine_.transitions(state * keys_per_state + tape.peekKey());
+    if (range.empty()) {
+      result.verdict = Verdict::Rejected;
+      return result;
+    }
+
+    if (result.steps == max_steps) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    if (limits.max_time.count() && (result.steps % 1024) == 0 &&
+        std::chrono::steady_clock::now() - start_time >= limits.max_time) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    const TransitionId t = range.first;
+    const CompiledMachine::Action& action = *machine_.actions(t);
+
+    tape.write(write_keys_[t], &writes_[t * num_tracks]);
+    tape.move(action.move);
+
+    state = action.next_state;
+    ++result.steps;
+  }
+
+  tape.writeTo(result.tapes);
+
+  result.verdict = Verdict::Accepted;
+  result.depth = result.steps;
+  return result;
+}
+
+}  // namespace turing
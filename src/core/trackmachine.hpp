@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/compiledmachine.hpp"
+#include "core/result.hpp"
+
+namespace turing {
+
+class TrackMachine {
+public:
+  explicit TrackMachine(const CompiledMachine& machine);
+
+  static bool supports(const CompiledMachine& machine, const std::vector<Tape>& tapes);
+
+  RunResult run(const std::vector<Tape>& tapes, const Limits& limits) const;
+
+private:
+  const CompiledMachine& machine_;
+
+  // Symbols written by the transition "t" on each track: writes_[t * tracks + i].
+  // write_keys_[t] is the key of those symbols on the TrackTape.
+  std::vector<SymbolId> writes_;
+  std::vector<std::uint64_t> write_keys_;
+};
+
+}  // namespace turing
@@ -1,11 +1,40 @@
 #include "turing.hpp"
 
+#include <chrono>
+#include <deque>
+#include <optional>
 #include <sstream>
+#include <unordered_set>
 
+#include "core/checkpoint.hpp"
+#include "core/compiledmachine.hpp"
+#include "core/configuration.hpp"
+#include "core/loopmachine.hpp"
+#include "core/macromachine.hpp"
+#include "core/parallelsearch.hpp"
+#include "core/resultcache.hpp"
+#include "core/runlengthmachine.hpp"
+#include "core/scanmachine.hpp"
+#include "core/trace.hpp"
+#include "core/trackmachine.hpp"
 #include "state/transition.hpp"
 
 namespace turing {
 
+namespace {
+
+/*!
+ *  Print the current state and tapes of the Turing machine.
+ */
+void printConfiguration(const std::string& state_name, const std::vector<Tape>& tapes) {
+  std::cout << "---------------------------" << std::endl;
+  std::cout << "Current state: " << state_name << std::endl;
+  std::cout << tapes;
+  std::cout << "---------------------------" << std::endl;
+}
+
+}  // namespace
+
 /*!
  *  \class Turing
  *  \brief Turing Machine implementation.
@@ -20,19 +49,12 @@ namespace turing {
 /*!
  *  Create a Turing machine with the given number of tapes.
  */
-Turing::Turing(int num_tapes) {
+Turing::Turing(int num_tapes)
+    : input_alphabet_(std::make_unique<Alphabet>()),
+      tape_alphabet_(std::make_unique<Alphabet>()) {
   setNumTapes(num_tapes);
 }
 
-/*!
- *  Delete the Turing machine.
- */
-Turing::~Turing() {
-  for (const auto& s : states_) {
-    delete s.second;
-  }
-}
-
 /*!
  *  Return the number of Tapes of the Turing machine.
  */
@@ -45,7 +67,8 @@ int Turing::numTapes() const {
  *  !WARNING: Content on the previous tapes will be deleted.
  */
 void Turing::setNumTapes(int num_tapes) {
-  tapes_ = std::vector<Tape>(num_tapes, Tape(tape_alphabet_));
+  resetCompiled();
+  tapes_ = std::vector<Tape>(num_tapes, Tape(*tape_alphabet_));
 }
 
 /*!
@@ -59,80 +82,127 @@ std::vector<Tape> Turing::tapes() const {
  *  Return the alphabet accepted by the Tape.
  */
 Alphabet& Turing::tapeAlphabet() {
-  return tape_alphabet_;
+  resetCompiled();
+  return *tape_alphabet_;
 }
 
 /*!
  *  Return the alphabet accepted by the Tape.
  */
 const Alphabet& Turing::tapeAlphabet() const {
-  return tape_alphabet_;
+  return *tape_alphabet_;
 }
 
 /*!
  *  Return the alphabet accepted by the input string.
  */
 Alphabet& Turing::inputAlphabet() {
-  return input_alphabet_;
+  return *input_alphabet_;
 }
 
 /*!
  *  Return the alphabet accepted by the input string.
  */
 const Alphabet& Turing::inputAlphabet() const {
-  return input_alphabet_;
+  return *input_alphabet_;
+}
+
+/*!
+ *  Return the number of States of the Turing machine.
+ */
+size_t Turing::numStates() const {
+  return states_.size();
+}
+
+/*!
+ *  Return all the States of the Turing machine, by id.
+ */
+const std::vector<State>& Turing::states() const {
+  return states_;
+}
+
+/*!
+ *  Return a State by its id.
+ */
+State& Turing::state(StateId id) {
+  // The state could be modified
+  resetCompiled();
+
+  return states_.at(id);
 }
 
 /*!
- *  Return a pointer to a State by its name.
+ *  Return a State by its id.
+ */
+const State& Turing::state(StateId id) const {
+  return states_.at(id);
+}
+
+/*!
+ *  Return the id of the State called "name". Ids are given in the order the States
+ *  are added, starting from 0.
+ *
  *  !WARNING: Throw if couldn't find a State called "name".
  */
-State* Turing::state(const std::string& name) {
-  try {
-    return states_.at(name);
-  } catch (const std::out_of_range& e) {
+StateId Turing::stateId(const std::string& name) const {
+  auto it = state_ids_.find(name);
+  if (it == state_ids_.end()) {
     throw std::runtime_error("> ERROR: State " + name + " is not defined.");
   }
+
+  return it->second;
+}
+
+/*!
+ *  Return the name of a State by its id.
+ */
+const std::string& Turing::stateName(StateId id) const {
+  return state_names_.at(id);
 }
 
 /*!
  *  Check if there's a State named "name" defined on the Turing machine.
  */
 bool Turing::hasState(const std::string& name) const {
-  return states_.count(name);
+  return state_ids_.count(name);
 }
 
 /*!
- *  Return the initial State of the Turing machine.
+ *  Return the id of the initial State of the Turing machine, or State::no_state if
+ *  it doesn't have one.
  */
-const State* Turing::initialState() const {
+StateId Turing::initialState() const {
   return initial_state_;
 }
 
 /*!
  *  Set a new initial State for the Turing machine.
- *  !WARNING: If the name is empty, set the initial state to null.
+ *  !WARNING: If the name is empty, the machine won't have an initial state.
  */
 void Turing::setInitialState(const std::string& name) {
   if (name.empty()) {
-    initial_state_ = nullptr;
+    initial_state_ = State::no_state;
   } else {
-    initial_state_ = state(name);
+    initial_state_ = stateId(name);
   }
+
+  resetCompiled();
 }
 
 /*!
  *  Set the final States for the Turing machine.
  */
 void Turing::setFinalStates(const std::vector<std::string>& state_names) {
+  resetCompiled();
+
   // First, reset all states to non-final.
-  for (const auto& state : states_) {
-    state.second->setFinal(false);
+  for (auto& state : states_) {
+    state.setFinal(false);
   }
 
   // Then, set the new final states.
   for (const auto& name : state_names) {
-    state(name)->setFinal(true);
+    states_[stateId(name)].setFinal(true);
   }
 }
 
@@ -145,11 +215,14 @@ void Turing::addState(const std::string& name) {
     return;
   }
 
-  if (states_.count(name)) {
+  if (state_ids_.count(name)) {
     std::cerr << "> WARNING: A state with name \"" << name
               << "\" already exists. The state WILL NOT be replaced." << std::endl;
   } else {
-    states_[name] = new State(name);
+    state_ids_[name] = states_.size();
+    state_names_.push_back(name);
+    states_.emplace_back();
+    resetCompiled();
   }
 }
 
@@ -216,9 +289,11 @@ void Turing::addTransition(const std::string& initial_state_name,
                            const std::vector<Symbol>& output_symbols,
                            const std::vector<Move>& moves) {
 
-  state(initial_state_name)
-      ->addTransition(
-          Transition(input_symbols, state(end_state_name), output_symbols, moves));
+  StateId end_state = stateId(end_state_name);
+
+  state(stateId(initial_state_name))
+      .addTransition(Transition(
+          *tape_alphabet_, input_symbols, end_state, output_symbols, moves));
 }
 
 /*!
@@ -235,98 +310,843 @@ void Turing::toggleDebugMode(bool toggle) {
   debug_mode_ = toggle;
 }
 
+/*!
+ *  Check if the runs are profiled.
+ */
+bool Turing::profiling() const {
+  return profiling_;
+}
+
+/*!
+ *  Toggle if the runs should count the visits to each state and transition (See
+ *  Profile). The counters are returned on the RunResult.
+ */
+void Turing::toggleProfiling(bool toggle) {
+  profiling_ = toggle;
+}
+
+/*!
+ *  Return the budgets used on each run.
+ */
+const Limits& Turing::limits() const {
+  return limits_;
+}
+
+/*!
+ *  Set the step, depth and time budgets used on each run.
+ */
+void Turing::setLimits(const Limits& limits) {
+  limits_ = limits;
+}
+
+/*!
+ *  Return the strategy used to explore the computation tree.
+ */
+SearchMode Turing::searchMode() const {
+  return search_mode_;
+}
+
+/*!
+ *  Set the strategy used to explore the computation tree.
+ *  - DepthFirst: Explore each branch until it ends. Uses little memory, but may never
+ *  end on machines with infinite branches.
+ *  - BreadthFirst: Explore all the configurations reachable in N steps before the ones
+ *  reachable in N+1, skipping configurations already visited. Finds the shortest
+ *  accepting computation and always ends if there're finitely many configurations.
+ *  - Parallel: Explore the branches depth-first on several threads. Ends as soon as
+ *  any thread accepts. Falls back to DepthFirst in debug mode.
+ */
+void Turing::setSearchMode(SearchMode mode) {
+  search_mode_ = mode;
+}
+
+/*!
+ *  Return the number of threads used by the Parallel search.
+ */
+size_t Turing::searchThreads() const {
+  return search_threads_;
+}
+
+/*!
+ *  Set the number of threads used by the Parallel search.
+ */
+void Turing::setSearchThreads(size_t num_threads) {
+  search_threads_ = std::max<size_t>(num_threads, 1);
+}
+
+/*!
+ *  Return the number of cells of the blocks used to run deterministic machines, or 0
+ *  if they are run step by step.
+ */
+int Turing::blockSize() const {
+  return block_size_;
+}
+
+/*!
+ *  Run deterministic single-tape machines on blocks of "block_size" cells, caching the
+ *  outcome of each block (See MacroMachine). 0 runs them step by step.
+ *
+ *  Not used in debug mode or when profiling, as single steps aren't seen.
+ */
+void Turing::setBlockSize(int block_size) {
+  block_size_ = std::max(block_size, 0);
+}
+
+/*!
+ *  Check if deterministic machines are run on a run-length encoded tape.
+ */
+bool Turing::runLengthTape() const {
+  return run_length_tape_;
+}
+
+/*!
+ *  Toggle if deterministic single-tape machines should be run on a run-length encoded
+ *  tape, crossing whole runs of symbols with a single transition (See
+ *  RunLengthMachine).
+ *
+ *  Not used in debug mode or when profiling, as single steps aren't seen. Blocks (See
+ *  "setBlockSize") take precedence.
+ */
+void Turing::toggleRunLengthTape(bool toggle) {
+  run_length_tape_ = toggle;
+}
+
+/*!
+ *  Check if deterministic machines are checked for loops.
+ */
+bool Turing::loopDetection() const {
+  return loop_detection_;
+}
+
+/*!
+ *  Toggle if the depth-first runs of deterministic machines should look for repeated
+ *  configurations, rejecting the input as soon as the run is proven to loop forever
+ *  (See LoopMachine). Its result has the cycle found.
+ *
+ *  Not used in debug mode or when profiling. Takes precedence over the other ways of
+ *  running deterministic machines.
+ */
+void Turing::toggleLoopDetection(bool toggle) {
+  loop_detection_ = toggle;
+}
+
+/*!
+ *  Return the cache of results used by "simulate", or null if there isn't one.
+ */
+std::shared_ptr<ResultCache> Turing::resultCache() const {
+  return result_cache_;
+}
+
+/*!
+ *  Set a cache of results. "simulate" returns the cached result if the machine was
+ *  already run with the same input (and search mode and budgets), instead of running
+ *  it again. Pass null to disable it.
+ *
+ *  The cache isn't used in debug mode, when profiling or when tracing, as the run must
+ *  be done.
+ */
+void Turing::setResultCache(std::shared_ptr<ResultCache> cache) {
+  result_cache_ = std::move(cache);
+}
+
+/*!
+ *  Return the trace the runs are written to, or null if they aren't traced.
+ */
+std::shared_ptr<TraceWriter> Turing::trace() const {
+  return trace_;
+}
+
+/*!
+ *  Write the steps of the runs to a binary trace. Pass null to stop tracing.
+ *
+ *  Traced runs always use the depth-first search, as the trace follows a single
+ *  computation path at a time, and they aren't checkpointed (The search mode and the
+ *  checkpoint are ignored). The trace isn't thread-safe: the machine can't
+ *  simulate several inputs at the same time while it's set.
+ */
+void Turing::setTrace(std::shared_ptr<TraceWriter> trace) {
+  trace_ = std::move(trace);
+}
+
+/*!
+ *  Return the checkpoint the runs are saved to, or null if they aren't checkpointed.
+ */
+std::shared_ptr<Checkpoint> Turing::checkpoint() const {
+  return checkpoint_;
+}
+
+/*!
+ *  Save snapshots of the runs to a checkpoint, and resume the run of its loaded
+ *  snapshot (See Checkpoint). Pass null to stop checkpointing.
+ *
+ *  Checkpointed runs use the depth-first or breadth-first search step by step (The
+ *  parallel search runs as the depth-first one). They aren't checkpointed in debug
+ *  mode, when profiling or tracing, or for input files mapped on memory. The
+ *  checkpoint isn't thread-safe: the machine can't simulate several inputs at the same
+ *  time while it's set.
+ */
+void Turing::setCheckpoint(std::shared_ptr<Checkpoint> checkpoint) {
+  checkpoint_ = std::move(checkpoint);
+}
+
+/*!
+ *  Check if the runs are saved to the checkpoint: it's set, and the machine isn't in
+ *  debug mode, profiled nor traced. Runs of mapped input files aren't saved either.
+ */
+bool Turing::checkpointed() const {
+  return checkpoint_ && !debug_mode_ && !profiling_ && !trace_;
+}
+
+/*!
+ *  Compile the Turing machine to run it. The compiled machine is kept until the
+ *  Turing machine is modified.
+ *
+ *  Note: "run" compiles the machine if needed. Call this before using "simulate" from
+ *  several threads, so the compiled machine is shared.
+ */
+void Turing::compile() {
+  if (!compiled_) {
+    compiled_ = std::make_shared<const CompiledMachine>(*this);
+  }
+}
+
+/*!
+ *  Return the compiled Turing machine. If it isn't compiled, compile a temporary one.
+ */
+std::shared_ptr<const CompiledMachine> Turing::compiled() const {
+  if (compiled_) {
+    return compiled_;
+  }
+
+  return std::make_shared<const CompiledMachine>(*this);
+}
+
+/*!
+ *  Run the machine with an already compiled one (p.e. loaded from a MachineImage),
+ *  instead of compiling its states. The number of tapes and the alphabets must be set
+ *  first: the compiled machine is kept from then on, even if the machine is modified.
+ */
+void Turing::setCompiled(std::shared_ptr<const CompiledMachine> compiled) {
+  compiled_ = std::move(compiled);
+  keep_compiled_ = true;
+}
+
+/*!
+ *  Drop the compiled machine, as the Turing machine may be modified. A compiled machine
+ *  given with "setCompiled" is kept: the machine doesn't have the States to build
+ *  it again.
+ */
+void Turing::resetCompiled() {
+  if (!keep_compiled_) {
+    compiled_.reset();
+  }
+}
+
 /*!
  *  Test the input_string with the curent Turing machine and return if the string was
- *  accepted or not.
+ *  accepted, rejected or if a budget ran out before deciding it.
+ *  The resulting tapes can be retrieved with "tapes()".
+ */
+Verdict Turing::run(const std::string& input_string) {
+  compile();
+
+  RunResult result = simulate(input_string);
+  tapes_ = std::move(result.tapes);
+
+  return result.verdict;
+}
+
+/*!
+ *  Test the input_string with the current Turing machine without modifying it.
  */
-bool Turing::run(const std::string& input_string) {
+RunResult Turing::simulate(const std::string& input_string) const {
   // Fill initial tape with input string
-  tapes_[0].setInputString(input_string, input_alphabet_);
+  Diagnostics diagnostics;
+  std::vector<Tape> tapes(numTapes(), Tape(*tape_alphabet_));
+  tapes[0].setInputString(input_string, *input_alphabet_, &diagnostics);
+
+  return simulate(std::move(tapes), std::move(diagnostics));
+}
+
+/*!
+ *  Test the contents of the input file with the current Turing machine, without
+ *  reading it to memory (See Tape::setInputFile). The characters out of the input
+ *  alphabet that are read are reported on the diagnostics of the result, or with
+ *  "check_input", the whole file is checked before the run.
+ *
+ *  The results aren't cached, and the input is never decoded to other cells (So
+ *  blocks, runs, scan loops and multi-track machines are run step by step).
+ */
+RunResult Turing::simulate(std::shared_ptr<const InputFile> input_file,
+                           bool check_input) const {
+  std::vector<Tape> tapes(numTapes(), Tape(*tape_alphabet_));
+  tapes[0].setInputFile(std::move(input_file), *input_alphabet_, check_input);
 
-  State* current_state = initial_state_;
+  // Shares the input with the tapes of the run
+  const Tape input = tapes[0];
 
-  return run(current_state, tapes_);
+  RunResult result = simulate(std::move(tapes), Diagnostics());
+  input.reportInput(result.diagnostics);
+
+  return result;
 }
 
 /*!
- *  Recursive version of run.
+ *  Test the initial tapes with the current Turing machine. Look for the result on the
+ *  cache before running it.
  */
-bool Turing::run(State* current_state, std::vector<Tape>& tapes) {
-  // Exit if the current state is null
-  if (!current_state) {
-    return false;
+RunResult Turing::simulate(std::vector<Tape>&& tapes, Diagnostics&& diagnostics) const {
+  auto machine = compiled();
+
+  // Look for the result of a previous run
+  bool use_cache = result_cache_ && !debug_mode_ && !profiling_ && !trace_ &&
+                   !tapes[0].hasInputFile();
+  std::uint64_t cache_key = 0;
+  std::vector<SymbolId> cache_input;
+
+  if (use_cache) {
+    cache_key = cacheKey(*machine);
+    for (int i = 0; !tapes[0].empty() && i <= tapes[0].lastWritten(); ++i) {
+      cache_input.push_back(tapes[0].peekId(i));
+    }
+
+    auto cached = result_cache_->find(cache_key, cache_input, *tape_alphabet_);
+    if (cached) {
+      if (cached->tapes.empty()) {
+        cached->tapes = std::move(tapes);
+      }
+
+      cached->diagnostics = std::move(diagnostics);
+      return std::move(*cached);
+    }
+  }
+
+  RunResult result = search(*machine, tapes);
+
+  // Results that ran out of time depend on the speed of the run. Cycles aren't stored.
+  if (use_cache && !(result.verdict == Verdict::Undecided && limits_.max_time.count()) &&
+      !result.cycle) {
+    result_cache_->insert(cache_key, cache_input, result);
   }
 
-  // Helper function to print the state of the Turing machine
-  auto print_turing = [&current_state, &tapes] {
-    std::cout << "---------------------------" << std::endl;
-    std::cout << "Current state: " << current_state->name() << std::endl;
-    std::cout << tapes;
-    std::cout << "---------------------------" << std::endl;
+  result.diagnostics = std::move(diagnostics);
+
+  return result;
+}
+
+/*!
+ *  Key of the results of the machine on the cache: the fingerprint of the machine,
+ *  combined with the settings that change the result.
+ */
+std::uint64_t Turing::cacheKey(const CompiledMachine& machine) const {
+  std::uint64_t key = machine.fingerprint();
+
+  auto combine = [&key](std::uint64_t value) {
+    key ^= value + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
   };
 
-  // Return true if the Turing machine arrived a Final state
-  if (current_state->isFinal()) {
-    if (debugMode()) {
-      print_turing();
-      std::cout << "> " << current_state->name() << " is a Final state." << std::endl;
-      std::cout << "---------------------------" << std::endl;
+  combine(static_cast<std::uint64_t>(search_mode_));
+  combine(limits_.max_steps);
+  combine(limits_.max_depth);
+
+  // Loops are rejected instead of running out of budget
+  if (loop_detection_) {
+    combine(1);
+  }
+
+  // Blocks and run-length tapes may end the runs that never halt (See "search")
+  combine(static_cast<std::uint64_t>(block_size_));
+  combine(run_length_tape_);
+
+  return key;
+}
+
+/*!
+ *  Explore the computation tree of the compiled machine with the current search mode.
+ *
+ *  Deterministic machines may be run by a specialized runner instead (LoopMachine,
+ *  MacroMachine, RunLengthMachine, TrackMachine or ScanMachine). Every runner has the
+ *  same result as the depth-first search: verdict, steps, depth, and tapes (written
+ *  cells and head positions) of the accepting configuration. Their budget of steps is
+ *  Limits::deterministicSteps. The only exception are the loops found by LoopMachine,
+ *  and the loops inside a block found by MacroMachine without a step budget, which are
+ *  Rejected with their cycle instead of running out of budget.
+ */
+RunResult Turing::search(const CompiledMachine& machine,
+                         const std::vector<Tape>& tapes) const {
+  if (trace_) {
+    trace_->beginRun(machine, tapes);
+    RunResult result = depthFirstSearch(machine, tapes);
+    trace_->endRun(result);
+
+    return result;
+  }
+
+  // Checkpointed runs are done by the searches that can save and resume their state
+  if (checkpointed() && !tapes[0].hasInputFile()) {
+    RunResult result = (search_mode_ == SearchMode::BreadthFirst)
+                           ? breadthFirstSearch(machine, tapes, checkpoint_.get())
+                           : depthFirstSearch(machine, tapes, checkpoint_.get());
+    checkpoint_->end();
+
+    return result;
+  }
+
+  if (!debug_mode_ && !profiling_) {
+    if (loop_detection_ && search_mode_ == SearchMode::DepthFirst &&
+        LoopMachine::supports(machine)) {
+      return LoopMachine(machine).run(tapes, limits_);
     }
 
-    tapes_ = tapes;
+    // The next ones decode the whole tapes to their own cells: input files are left
+    // mapped, and run by the searches
+    bool decoded = !tapes[0].hasInputFile();
 
-    return true;
+    if (decoded && block_size_ > 0 && MacroMachine::supports(machine)) {
+      return MacroMachine(machine, block_size_).run(tapes, limits_);
+    }
+
+    if (decoded && run_length_tape_ && RunLengthMachine::supports(machine)) {
+      return RunLengthMachine(machine).run(tapes, limits_);
+    }
+
+    bool contiguous = decoded && search_mode_ == SearchMode::DepthFirst;
+
+    // Multi-track machines run on a single tape of tuples, as the depth-first search
+    if (contiguous && TrackMachine::supports(machine, tapes)) {
+      return TrackMachine(machine).run(tapes, limits_);
+    }
+
+    // Scan loops of single-tape machines are crossed at once, with the same result
+    if (contiguous && ScanMachine::supports(machine)) {
+      return ScanMachine(machine).run(tapes, limits_);
+    }
   }
 
-  if (debugMode()) {
-    print_turing();
+  switch (search_mode_) {
+    case SearchMode::BreadthFirst:
+      return breadthFirstSearch(machine, tapes);
+
+    case SearchMode::Parallel:
+      if (!debug_mode_) {
+        return ParallelSearch(machine, limits_, search_threads_, profiling_).run(tapes);
+      }
+      return depthFirstSearch(machine, tapes);
+
+    case SearchMode::DepthFirst:
+    default:
+      return depthFirstSearch(machine, tapes);
   }
+}
 
-  // Collect all symbols from all tapes for each current head
-  std::vector<Symbol> input_symbols;
-  for (const auto& tape : tapes) {
-    input_symbols.push_back(tape.peek());
+/*!
+ *  Explore the computation tree depth-first.
+ *
+ *  The branches pending to explore are kept on an explicit stack (frontier) instead of
+ *  the native stack, so long computations can't overflow it. Each frame stores the
+ *  tapes of a configuration and the next transition to explore from it. With a
+ *  checkpoint, the frontier is saved from time to time, and the search can continue
+ *  from a saved one.
+ */
+RunResult Turing::depthFirstSearch(const CompiledMachine& machine,
+                                   const std::vector<Tape>& tapes,
+                                   Checkpoint* checkpoint) const {
+  struct Frame {
+    StateId state;
+    TransitionId first;
+    std::vector<Tape> tapes;
+    std::uint64_t depth;
+
+    TransitionId next;
+    TransitionId last;
+  };
+
+  RunResult result;
+  result.tapes = tapes;
+
+  Profile* profile = nullptr;
+  if (profiling_) {
+    profile = &result.profile.emplace(machine);
+    profile->startRun();
   }
 
-  // Explore transitions for the current tape symbols.
-  for (const auto& transition : current_state->transitions(input_symbols)) {
+  std::vector<Frame> frontier;
+
+  // Set when a branch is pruned by the depth budget
+  bool pruned = false;
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Steps done when the checkpoint was last checked
+  std::uint64_t checked_steps = 0;
+
+  // Save the steps and the frontier to the checkpoint
+  auto save_snapshot = [&] {
+    Checkpoint::Snapshot snapshot;
+    snapshot.steps = result.steps;
+    snapshot.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time);
+    snapshot.pruned = pruned;
+
+    for (const auto& frame : frontier) {
+      snapshot.frontier.push_back(
+          {{frame.state, frame.tapes, frame.depth}, frame.first, frame.next, frame.last});
+    }
+
+    checkpoint->save(snapshot);
+  };
+
+  // Helper function to print that a branch failed
+  auto print_backtrack = [this, &machine, &frontier] {
+    if (debugMode() && !frontier.empty()) {
+      std::cout << ">> Can't continue. Going back to previous state." << std::endl;
+      printConfiguration(machine.stateName(frontier.back().state),
+                         frontier.back().tapes);
+    }
+  };
+
+  // Push a new configuration to the frontier. Return true if it's accepting.
+  auto enter = [&](StateId state, std::vector<Tape>&& tapes, std::uint64_t depth) {
     if (debugMode()) {
-      std::cout << "> Transition: " << transition << std::endl;
+      printConfiguration(machine.stateName(state), tapes);
     }
 
-    // For each transition, clone the tapes and call this run method recursively.
-    std::vector<Tape> new_tapes(tapes);
-    State* new_state = transition.nextState(new_tapes);
+    if (profile) {
+      profile->visit(state);
+      profile->track(tapes);
+    }
 
-    // Check if by exploring this transition the Turing machine can accept the string.
-    bool result = run(new_state, new_tapes);
+    // Accept if the Turing machine arrived a Final state
+    if (machine.isFinal(state)) {
+      if (debugMode()) {
+        std::cout << "> " << machine.stateName(state) << " is a Final state."
+                  << std::endl;
+        std::cout << "---------------------------" << std::endl;
+      }
 
-    // If the string is accepted, return true to stop execution.
-    if (result) {
+      result.tapes = std::move(tapes);
+      result.depth = depth;
       return true;
     }
 
-    // Otherwise, explore the other transitions
+    auto range = machine.transitions(state, tapes);
+    if (profile && range.size() > 1) {
+      profile->branch(state);
+    }
+
+    frontier.push_back(
+        {state, range.first, std::move(tapes), depth, range.first, range.last});
+
+    return false;
+  };
+
+  // Exit if there isn't an initial state
+  if (machine.initialState() == CompiledMachine::no_state) {
+    return result;
+  }
+
+  std::optional<Checkpoint::Snapshot> snapshot;
+  if (checkpoint) {
+    snapshot = checkpoint->begin(machine, SearchMode::DepthFirst, tapes);
+  }
+
+  if (snapshot) {
+    // Continue from the saved frontier
+    result.steps = checked_steps = snapshot->steps;
+    pruned = snapshot->pruned;
+    start_time -= snapshot->elapsed;
+
+    for (auto& frame : snapshot->frontier) {
+      Configuration& configuration = frame.configuration;
+      frontier.push_back({configuration.state,
+                          frame.first,
+                          std::move(configuration.tapes),
+                          configuration.depth,
+                          frame.next,
+                          frame.last});
+    }
+  } else if (enter(machine.initialState(), std::vector<Tape>(tapes), 0)) {
+    result.verdict = Verdict::Accepted;
+    return result;
+  }
+
+  while (!frontier.empty()) {
+    if (checkpoint && result.steps - checked_steps >= 1024) {
+      checked_steps = result.steps;
+      if (checkpoint->due()) {
+        save_snapshot();
+      }
+    }
+
+    Frame& frame = frontier.back();
+
+    // All the transitions were explored. Go back to the previous configuration.
+    if (frame.next == frame.last) {
+      frontier.pop_back();
+      print_backtrack();
+      continue;
+    }
+
+    TransitionId transition = frame.next++;
+
+    // Check the budgets
+    if (limits_.max_steps && result.steps >= limits_.max_steps) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    if (limits_.max_time.count() && (result.steps % 1024) == 0 &&
+        std::chrono::steady_clock::now() - start_time >= limits_.max_time) {
+      result.verdict = Verdict::Undecided;
+      return result;
+    }
+
+    if (limits_.max_depth && frame.depth >= limits_.max_depth) {
+      pruned = true;
+      continue;
+    }
+
     if (debugMode()) {
-      std::cout << ">> Can't continue. Going back to previous state." << std::endl;
-      print_turing();
+      std::cout << "> Transition: " << machine.transitionName(transition) << std::endl;
+    }
+
+    if (profile) {
+      profile->fire(transition);
+      if (transition != frame.first) {
+        profile->backtrack(frame.state);
+      }
+    }
+
+    std::uint64_t depth = frame.depth + 1;
+
+    // Clone the tapes for the new branch. Tapes are copy-on-write, so only the cells
+    // written by the branch are copied.
+    // If this is the last transition of the configuration, it isn't needed anymore:
+    // reuse its tapes and drop it, so deterministic runs don't grow the frontier.
+    // (On debug mode it's kept to print the trace when going back)
+    std::vector<Tape> new_tapes;
+    if (frame.next == frame.last && !debugMode()) {
+      new_tapes = std::move(frame.tapes);
+      frontier.pop_back();
+    } else {
+      new_tapes = frame.tapes;
+    }
+
+    if (trace_) {
+      trace_->step(machine, transition, new_tapes, depth - 1);
+    }
+
+    StateId new_state = machine.apply(transition, new_tapes);
+    ++result.steps;
+
+    if (enter(new_state, std::move(new_tapes), depth)) {
+      result.verdict = Verdict::Accepted;
+      return result;
     }
   }
 
-  // If all the transitions have been explored, but we still aren't on a final state,
-  // just return false
-  return false;
+  // All the branches have been explored, but we still aren't on a final state.
+  result.verdict = (pruned) ? Verdict::Undecided : Verdict::Rejected;
+  return result;
+}
+
+/*!
+ *  Explore the computation tree breadth-first.
+ *
+ *  Every configuration reached is stored on a visited set, and it's only explored the
+ *  first time it's found. The first accepting configuration found is the one with the
+ *  shortest computation. With a checkpoint, the frontier and the visited set are saved
+ *  from time to time, and the search can continue from saved ones.
+ */
+RunResult Turing::breadthFirstSearch(const CompiledMachine& machine,
+                                     const std::vector<Tape>& tapes,
+                                     Checkpoint* checkpoint) const {
+  RunResult result;
+  result.tapes = tapes;
+
+  Profile* profile = nullptr;
+  if (profiling_) {
+    profile = &result.profile.emplace(machine);
+    profile->startRun();
+  }
+
+  if (machine.initialState() == CompiledMachine::no_state) {
+    return result;
+  }
+
+  std::deque<Configuration> frontier;
+  std::unordered_set<Configuration> visited;
+
+  // Set when a configuration isn't explored due to the depth budget
+  bool pruned = false;
+
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Steps done when the checkpoint was last checked
+  std::uint64_t checked_steps = 0;
+
+  // Save the steps, the frontier and the visited set to the checkpoint
+  auto save_snapshot = [&] {
+    Checkpoint::Snapshot snapshot;
+    snapshot.steps = result.steps;
+    snapshot.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time);
+    snapshot.pruned = pruned;
+
+    for (const auto& configuration : frontier) {
+      snapshot.frontier.push_back({configuration});
+    }
+    snapshot.visited.assign(visited.begin(), visited.end());
+
+    checkpoint->save(snapshot);
+  };
+
+  // Accept if the configuration is on a Final state
+  auto accept = [this, &machine, &result, profile](Configuration& configuration) {
+    if (!machine.isFinal(configuration.state)) {
+      return false;
+    }
+
+    if (profile) {
+      profile->visit(configuration.state);
+    }
+
+    if (debugMode()) {
+      printConfiguration(machine.stateName(configuration.state), configuration.tapes);
+      std::cout << "> " << machine.stateName(configuration.state)
+                << " is a Final state." << std::endl;
+      std::cout << "---------------------------" << std::endl;
+    }
+
+    result.verdict = Verdict::Accepted;
+    result.tapes = std::move(configuration.tapes);
+    result.depth = configuration.depth;
+    return true;
+  };
+
+  std::optional<Checkpoint::Snapshot> snapshot;
+  if (checkpoint) {
+    snapshot = checkpoint->begin(machine, SearchMode::BreadthFirst, tapes);
+  }
+
+  if (snapshot) {
+    // Continue from the saved frontier and visited set
+    result.steps = checked_steps = snapshot->steps;
+    pruned = snapshot->pruned;
+    start_time -= snapshot->elapsed;
+
+    for (auto& configuration : snapshot->visited) {
+      visited.insert(std::move(configuration));
+    }
+    for (auto& frame : snapshot->frontier) {
+      frontier.push_back(std::move(frame.configuration));
+    }
+  } else {
+    Configuration initial{machine.initialState(), tapes, 0};
+    if (accept(initial)) {
+      return result;
+    }
+
+    visited.insert(initial);
+    frontier.push_back(std::move(initial));
+  }
+
+  while (!frontier.empty()) {
+    if (checkpoint && result.steps - checked_steps >= 1024) {
+      checked_steps = result.steps;
+      if (checkpoint->due()) {
+        save_snapshot();
+      }
+    }
+
+    Configuration current = std::move(frontier.front());
+    frontier.pop_front();
+
+    if (debugMode()) {
+      printConfiguration(machine.stateName(current.state), current.tapes);
+    }
+
+    auto range = machine.transitions(current.state, current.tapes);
+    if (profile) {
+      profile->visit(current.state);
+      if (range.size() > 1) {
+        profile->branch(current.state);
+      }
+    }
+
+    if (limits_.max_depth && current.depth >= limits_.max_depth) {
+      pruned = pruned || !range.empty();
+      continue;
+    }
+
+    for (TransitionId transition = range.first; transition < range.last; ++transition) {
+      // Check the budgets
+      if (limits_.max_steps && result.steps >= limits_.max_steps) {
+        result.verdict = Verdict::Undecided;
+        return result;
+      }
+
+      if (limits_.max_time.count() && (result.steps % 1024) == 0 &&
+          std::chrono::steady_clock::now() - start_time >= limits_.max_time) {
+        result.verdict = Verdict::Undecided;
+        return result;
+      }
+
+      if (debugMode()) {
+        std::cout << "> Transition: " << machine.transitionName(transition) << std::endl;
+      }
+
+      Configuration next{0, current.tapes, current.depth + 1};
+      next.state = machine.apply(transition, next.tapes);
+      ++result.steps;
+
+      if (profile) {
+        profile->fire(transition);
+        if (transition != range.first) {
+          profile->backtrack(current.state);
+        }
+        profile->track(next.tapes);
+      }
+
+      // Skip configurations already found
+      if (!visited.insert(next).second) {
+        continue;
+      }
+
+      if (accept(next)) {
+        return result;
+      }
+
+      frontier.push_back(std::move(next));
+    }
+  }
+
+  // All the reachable configurations have been explored, but none is final.
+  result.verdict = (pruned) ? Verdict::Undecided : Verdict::Rejected;
+  return result;
 }
 
 /*!
  *  Print the Turing Machine.
  */
 std::ostream& operator<<(std::ostream& os, const Turing& machine) {
+  // Machines loaded from an image only have the compiled machine
+  const CompiledMachine* compiled =
+      (machine.states_.empty()) ? machine.compiled_.get() : nullptr;
+
   os << "> Turing machine: " << machine.numTapes() << " tapes." << std::endl;
   os << "> States: ";
 
-  for (const auto& s : machine.states_) {
-    os << s.second->name() << ((s.second->isFinal()) ? "*" : "") << " ";
+  if (compiled) {
+    for (StateId state = 0; state < compiled->numStates(); ++state) {
+      os << compiled->stateName(state) << ((compiled->isFinal(state)) ? "*" : "")
+         << " ";
+    }
+  }
+
+  for (const auto& s_pair : machine.state_ids_) {
+    const bool final = machine.states_[s_pair.second].isFinal();
+    os << s_pair.first << ((final) ? "*" : "") << " ";
   }
 
   os << std::endl;
@@ -334,13 +1154,33 @@ std::ostream& operator<<(std::ostream& os, const Turing& machine) {
   os << "> Input alphabet: " << machine.inputAlphabet() << std::endl;
   os << "> Tape alphabet: " << machine.tapeAlphabet() << std::endl;
 
-  os << "> Initial state: " << machine.initial_state_->name() << std::endl;
+  if (compiled && compiled->initialState() != CompiledMachine::no_state) {
+    os << "> Initial state: " << compiled->stateName(compiled->initialState())
+       << std::endl;
+  } else if (machine.initial_state_ != State::no_state) {
+    os << "> Initial state: " << machine.stateName(machine.initial_state_)
+       << std::endl;
+  }
 
   os << "> Tapes:\n" << machine.tapes_;
 
   os << "> Transitions: " << std::endl;
-  for (const auto& s_pair : machine.states_) {
-    std::cout << *s_pair.second << std::endl;
+  if (compiled) {
+    for (TransitionId t = 0; t < compiled->numTransitions(); ++t) {
+      os << compiled->stateName(compiled->sourceState(t)) << ": "
+         << compiled->transitionName(t) << std::endl;
+    }
+  }
+
+  for (const auto& s_pair : machine.state_ids_) {
+    for (const auto& t_pair : machine.states_[s_pair.second].transitions()) {
+      os << s_pair.first << ": [ ";
+      for (const auto& t : t_pair.second) {
+        os << to_string(t, machine.state_names_) << ", ";
+      }
+      os << "\b\b ]" << std::endl;
+    }
+    os << std::endl;
   }
 
   return os;
@@ -1,15 +1,32 @@
 #pragma once
 
+#include <map>
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "core/result.hpp"
 #include "data/alphabet.hpp"
 #include "state/state.hpp"
 #include "utils/utils.hpp"
 
 namespace turing {
 
+class Checkpoint;
+class CompiledMachine;
+class InputFile;
+class ResultCache;
+class TraceWriter;
+
 class Turing {
 public:
   Turing(int num_tapes = 1);
-  ~Turing();
+
+  Turing(const Turing&) = delete;
+  Turing& operator=(const Turing&) = delete;
+
+  Turing(Turing&&) = default;
+  Turing& operator=(Turing&&) = default;
 
   int numTapes() const;
   void setNumTapes(int num_tapes);
@@ -23,10 +40,17 @@ public:
   const Alphabet& inputAlphabet() const;
 
   // States
-  State* state(const std::string& name);
+  size_t numStates() const;
+  const std::vector<State>& states() const;
+
+  State& state(StateId id);
+  const State& state(StateId id) const;
+
+  StateId stateId(const std::string& name) const;
+  const std::string& stateName(StateId id) const;
   bool hasState(const std::string& name) const;
 
-  const State* initialState() const;
+  StateId initialState() const;
   void setInitialState(const std::string& name);
 
   void setFinalStates(const std::vector<std::string>& state_names);
@@ -46,21 +70,97 @@ public:
   bool debugMode() const;
   void toggleDebugMode(bool toggle);
 
-  bool run(const std::string& input_string);
-  bool run(State* current_state, std::vector<Tape>& tapes);
+  bool profiling() const;
+  void toggleProfiling(bool toggle);
+
+  const Limits& limits() const;
+  void setLimits(const Limits& limits);
+
+  SearchMode searchMode() const;
+  void setSearchMode(SearchMode mode);
+
+  size_t searchThreads() const;
+  void setSearchThreads(size_t num_threads);
+
+  int blockSize() const;
+  void setBlockSize(int block_size);
+
+  bool runLengthTape() const;
+  void toggleRunLengthTape(bool toggle);
+
+  bool loopDetection() const;
+  void toggleLoopDetection(bool toggle);
+
+  std::shared_ptr<ResultCache> resultCache() const;
+  void setResultCache(std::shared_ptr<ResultCache> cache);
+
+  std::shared_ptr<TraceWriter> trace() const;
+  void setTrace(std::shared_ptr<TraceWriter> trace);
+
+  std::shared_ptr<Checkpoint> checkpoint() const;
+  void setCheckpoint(std::shared_ptr<Checkpoint> checkpoint);
+  bool checkpointed() const;
+
+  void compile();
+  std::shared_ptr<const CompiledMachine> compiled() const;
+  void setCompiled(std::shared_ptr<const CompiledMachine> compiled);
+
+  Verdict run(const std::string& input_string);
+  RunResult simulate(const std::string& input_string) const;
+  RunResult simulate(std::shared_ptr<const InputFile> input_file,
+                     bool check_input = false) const;
 
   friend std::ostream& operator<<(std::ostream& os, const Turing& turing);
 
 private:
-  Alphabet input_alphabet_;
-  Alphabet tape_alphabet_;
+  RunResult simulate(std::vector<Tape>&& tapes, Diagnostics&& diagnostics) const;
+  std::uint64_t cacheKey(const CompiledMachine& machine) const;
+  void resetCompiled();
+
+  RunResult search(const CompiledMachine& machine, const std::vector<Tape>& tapes) const;
+  RunResult depthFirstSearch(const CompiledMachine& machine,
+                             const std::vector<Tape>& tapes,
+                             Checkpoint* checkpoint = nullptr) const;
+  RunResult breadthFirstSearch(const CompiledMachine& machine,
+                               const std::vector<Tape>& tapes,
+                               Checkpoint* checkpoint = nullptr) const;
+
+private:
+  // On the heap, so the Tapes and Transitions that refer to them survive a move
+  std::unique_ptr<Alphabet> input_alphabet_;
+  std::unique_ptr<Alphabet> tape_alphabet_;
 
   std::vector<Tape> tapes_;
 
-  State* initial_state_{nullptr};
-  std::map<std::string, State*> states_;
+  // States by id, and their names
+  std::vector<State> states_;
+  std::vector<std::string> state_names_;
+  std::map<std::string, StateId> state_ids_;
+
+  StateId initial_state_{State::no_state};
+
+  // Compiled version of the machine. Reset when the machine is modified, unless it was
+  // given with "setCompiled" (p.e. from a MachineImage).
+  std::shared_ptr<const CompiledMachine> compiled_;
+  bool keep_compiled_{false};
 
   bool debug_mode_{true};
+  bool profiling_{false};
+  Limits limits_;
+  SearchMode search_mode_{SearchMode::DepthFirst};
+  size_t search_threads_{std::max(std::thread::hardware_concurrency(), 1u)};
+  int block_size_{0};
+  bool run_length_tape_{false};
+  bool loop_detection_{false};
+
+  // Results of previous runs. Can be shared with other machines.
+  std::shared_ptr<ResultCache> result_cache_;
+
+  // Binary trace of the runs
+  std::shared_ptr<TraceWriter> trace_;
+
+  // Snapshots of the runs, to resume them
+  std::shared_ptr<Checkpoint> checkpoint_;
 };
 
 }  // namespace turing
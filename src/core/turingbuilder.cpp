@@ -3,6 +3,9 @@
 #include <fstream>
 #include <sstream>
 
+#include "core/compiledmachine.hpp"
+#include "core/machineimage.hpp"
+
 namespace turing {
 
 /*!
@@ -10,15 +13,12 @@ namespace turing {
  *  \brief Construct a Turing object from different sources (p.e. file)
  */
 
+namespace {
+
 /*!
- *  Construct a Turing machine from a file.
+ *  Construct a Turing machine from its text definition.
  */
-Turing TuringBuilder::fromFile(const std::string& file_path) {
-  std::ifstream file_stream(file_path);
-  if (!file_stream.is_open()) {
-    throw std::runtime_error("Can't read Turing Machine file: " + file_path);
-  }
-
+Turing fromText(std::istream& file_stream) {
   Turing machine;
 
   std::string line;
@@ -58,6 +58,10 @@ Turing TuringBuilder::fromFile(const std::string& file_path) {
       line = Utils::nextLine(file_stream);
     }
 
+    // Lay out the machine to run it
+    line.clear();
+    machine.compile();
+
   } catch (const std::exception& e) {
     std::string message = "Error on Line: " + line + "\n";
     message += std::string("||") + e.what() + "\n";
@@ -68,4 +72,57 @@ Turing TuringBuilder::fromFile(const std::string& file_path) {
   return machine;
 }
 
+}  // namespace
+
+/*!
+ *  Construct a Turing machine from a file. Machine images (See "fromImage") are
+ *  detected and loaded directly.
+ */
+Turing TuringBuilder::fromFile(const std::string& file_path) {
+  if (MachineImage::isImage(file_path)) {
+    return fromImage(file_path);
+  }
+
+  std::ifstream file_stream(file_path);
+  if (!file_stream.is_open()) {
+    throw std::runtime_error("Can't read Turing Machine file: " + file_path);
+  }
+
+  return fromText(file_stream);
+}
+
+/*!
+ *  Construct a Turing machine from its text definition, with the same format as the
+ *  machine files.
+ */
+Turing TuringBuilder::fromString(const std::string& definition) {
+  std::istringstream stream(definition);
+  return fromText(stream);
+}
+
+/*!
+ *  Construct a Turing machine from an image written by MachineImage::write. The image
+ *  is mapped and run directly, so the machine doesn't have States nor Transitions: it
+ *  can be run, but not modified.
+ *
+ *  !WARNING: Throw if the file isn't a valid image.
+ */
+Turing TuringBuilder::fromImage(const std::string& file_path) {
+  auto image = std::make_shared<const MachineImage>(file_path);
+  auto compiled = std::make_shared<const CompiledMachine>(image);
+
+  Turing machine(compiled->numTapes());
+  machine.inputAlphabet().setSymbols(image->inputSymbols());
+
+  // Same ids as the alphabet of the compiled machine
+  std::vector<Symbol> symbols = image->tapeSymbols();
+  machine.tapeAlphabet().setBlank(symbols[0]);
+  machine.tapeAlphabet().setSymbols(
+      std::vector<Symbol>(symbols.begin() + 1, symbols.end()));
+
+  machine.setCompiled(compiled);
+
+  return machine;
+}
+
 }  // namespace turing
@@ -7,6 +7,8 @@ namespace turing {
 class TuringBuilder {
 public:
   static Turing fromFile(const std::string& file_path);
+  static Turing fromImage(const std::string& file_path);
+  static Turing fromString(const std::string& definition);
 };
 
 }  // namespace turing
@@ -1,6 +1,8 @@
 #include "alphabet.hpp"
 
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 
 namespace turing {
 
@@ -19,8 +21,22 @@ namespace turing {
  *  (Also, note how even if the string doesn't has spaces, the symbol BD is
  * recognized as a whole)
  *
+ *  Strings are split with a trie of the symbols, taking the longest symbol that
+ *  matches at each position.
+ *
+ *  The Alphabet also works as a symbol table: each symbol is interned as a small
+ *  integer (SymbolId) so Tapes, Transitions and States can compare and store ids
+ *  instead of strings. The blank symbol is always interned as "blank_id".
+ *
  */
 
+/*!
+ *  Construct an Alphabet that only contains the blank symbol.
+ */
+Alphabet::Alphabet() {
+  buildTrie();
+}
+
 /*!
  *  Check if the alphabet is empty.
  */
@@ -57,9 +73,14 @@ void Alphabet::setBlank(Symbol blank) {
   } else {
     // Remove last blank symbol
     alphabet_symbols_.erase(blank_);
+    ids_.erase(blank_);
 
     // Set new one
     blank_ = blank;
+    symbols_[blank_id] = blank_;
+    ids_[blank_] = blank_id;
+
+    buildTrie();
   }
 }
 
@@ -68,7 +89,8 @@ void Alphabet::setBlank(Symbol blank) {
  */
 void Alphabet::reset() {
   alphabet_symbols_.clear();
-  regex_ = std::regex();
+  resetIds();
+  buildTrie();
 }
 
 /*!
@@ -78,14 +100,43 @@ bool Alphabet::contains(Symbol symbol) const {
   return alphabet_symbols_.count(symbol);
 }
 
+/*!
+ *  Return the id of the Symbol.
+ *
+ *  !WARNING: Throw if the Symbol isn't on the alphabet (nor is the blank symbol).
+ */
+SymbolId Alphabet::id(const Symbol &symbol) const {
+  auto it = ids_.find(symbol);
+  if (it == ids_.end()) {
+    throw std::runtime_error("Symbol " + symbol + " is not in Alphabet.");
+  }
+
+  return it->second;
+}
+
+/*!
+ *  Return the Symbol interned as "id".
+ */
+const Symbol &Alphabet::symbol(SymbolId id) const {
+  return symbols_.at(id);
+}
+
+/*!
+ *  Return the number of interned symbols (Alphabet symbols plus blank).
+ *  All ids are in the range [0, numIds()).
+ */
+size_t Alphabet::numIds() const noexcept {
+  return symbols_.size();
+}
+
 /*!
  *  Add a new symbol to the Alphabet.
  */
 void Alphabet::addSymbol(Symbol symbol) {
   if (!alphabet_symbols_.count(symbol)) {
     alphabet_symbols_.insert(symbol);
-
-    regex_ = std::regex(regexStr());
+    intern(symbol);
+    addToTrie(symbol);
   }
 }
 
@@ -94,43 +145,84 @@ void Alphabet::addSymbol(Symbol symbol) {
  */
 void Alphabet::setSymbols(const std::vector<Symbol> &symbols) {
   alphabet_symbols_.clear();
+  resetIds();
 
   for (const auto &symbol : symbols) {
     alphabet_symbols_.insert(symbol);
+    intern(symbol);
   }
 
-  regex_ = std::regex(regexStr());
+  buildTrie();
 }
 
 /*!
  *  Use the Alphabet to split the input symbol on a vector of individual
- * Symbols. Note: Unrecognized elements are skipped.
+ * Symbols. Note: Unrecognized elements are skipped, and reported on "diagnostics".
  */
-std::vector<Symbol> Alphabet::splitInSymbols(const std::string &symbols_str) const {
+std::vector<Symbol> Alphabet::splitInSymbols(const std::string &symbols_str,
+                                             Diagnostics *diagnostics) const {
   std::vector<Symbol> matches;
 
-  // Prints a warning message if a symbol was skipped due to not being on the
-  // Alphabet.
-  auto check_sticky = [](int init_pos, int end_pos, const std::string &symbols_str) {
-    if (init_pos != end_pos) {
-      std::cout << "WARNING! Unrecognized symbol: "
-                << symbols_str.substr(init_pos, end_pos - init_pos) << std::endl;
+  for (const auto &id : splitInIds(symbols_str, diagnostics)) {
+    matches.push_back(symbols_[id]);
+  }
+
+  return matches;
+}
+
+/*!
+ *  Same as splitInSymbols, but return the ids of the Symbols.
+ *
+ *  At each position, take the longest symbol of the Alphabet that matches. If none
+ *  matches, skip the character.
+ */
+std::vector<SymbolId> Alphabet::splitInIds(const std::string &symbols_str,
+                                           Diagnostics *diagnostics) const {
+  std::vector<SymbolId> matches;
+
+  // Reports the characters skipped due to not being on the Alphabet.
+  auto check_sticky = [&](size_t init_pos, size_t end_pos) {
+    if (diagnostics && init_pos != end_pos) {
+      diagnostics->add("Unrecognized symbol: " +
+                       symbols_str.substr(init_pos, end_pos - init_pos));
     }
   };
 
-  int current_pos = 0;
-  for (auto it = std::sregex_iterator(symbols_str.begin(), symbols_str.end(), regex_);
-       it != std::sregex_iterator();
-       ++it) {
-    // Push the current match to the symbols vector
-    matches.push_back(it->str());
+  size_t skipped_pos = 0;
+  size_t pos = 0;
+  while (pos < symbols_str.size()) {
+    // Walk the trie, remembering the last (longest) symbol found
+    std::int32_t match = no_symbol;
+    size_t match_end = pos;
+
+    std::uint32_t node = root_edges_[static_cast<unsigned char>(symbols_str[pos])];
+    for (size_t i = pos + 1; node != no_node; ++i) {
+      if (trie_symbols_[node] != no_symbol) {
+        match = trie_symbols_[node];
+        match_end = i;
+      }
 
-    // Check if we skipped some symbol between matches
-    check_sticky(current_pos, it->position(), symbols_str);
-    current_pos = it->position() + it->length();
+      if (i == symbols_str.size()) {
+        break;
+      }
+
+      auto it = trie_edges_.find((std::uint64_t(node) << 8) |
+                                 static_cast<unsigned char>(symbols_str[i]));
+      node = (it != trie_edges_.end()) ? it->second : no_node;
+    }
+
+    if (match == no_symbol) {
+      ++pos;
+      continue;
+    }
+
+    check_sticky(skipped_pos, pos);
+
+    matches.push_back(static_cast<SymbolId>(match));
+    pos = skipped_pos = match_end;
   }
 
-  check_sticky(current_pos, symbols_str.length(), symbols_str);
+  check_sticky(skipped_pos, symbols_str.size());
 
   return matches;
 }
@@ -139,29 +231,77 @@ std::vector<Symbol> Alphabet::splitInSymbols(const std::string &symbols_str) con
  *  Print the content of the alphabet (Splitted by whitespaces)
  */
 std::ostream &operator<<(std::ostream &os, const Alphabet &alphabet) {
-  std::string alphabet_symbols(alphabet.regexStr());
-  std::replace(alphabet_symbols.begin(), alphabet_symbols.end(), '|', ' ');
-  std::replace(alphabet_symbols.begin(), alphabet_symbols.end(), '\\', ' ');
-
-  os << alphabet_symbols;
+  for (auto it = alphabet.alphabet_symbols_.cbegin();
+       it != alphabet.alphabet_symbols_.cend();
+       ++it) {
+    os << ((it != alphabet.alphabet_symbols_.cbegin()) ? " (" : "(") << *it << ")";
+  }
 
   return os;
 }
 
 /*!
- *  Transform the alphabet symbols to a regex expression (string).
+ *  Assign the next free id to the Symbol, if it doesn't have one yet.
  */
-std::string Alphabet::regexStr() const {
-  std::string regex_str;
+void Alphabet::intern(const Symbol &symbol) {
+  if (ids_.count(symbol)) {
+    return;
+  }
 
-  regex_str += "(" + *alphabet_symbols_.cbegin() + ")";
+  if (symbols_.size() > std::numeric_limits<SymbolId>::max()) {
+    throw std::runtime_error("Too many symbols on the Alphabet.");
+  }
 
-  for (auto it = next(alphabet_symbols_.cbegin()); it != alphabet_symbols_.cend();
-       ++it) {
-    regex_str += "|(" + *it + ")";
+  ids_[symbol] = static_cast<SymbolId>(symbols_.size());
+  symbols_.push_back(symbol);
+}
+
+/*!
+ *  Add the Symbol to the trie used to split strings.
+ */
+void Alphabet::addToTrie(const Symbol &symbol) {
+  if (symbol.empty()) {
+    return;
   }
 
-  return regex_str;
+  std::uint32_t node = no_node;
+  for (const auto &c : symbol) {
+    auto byte = static_cast<unsigned char>(c);
+
+    std::uint32_t &child =
+        (node == no_node) ? root_edges_[byte] : trie_edges_[(std::uint64_t(node) << 8) | byte];
+
+    if (child == no_node) {
+      child = trie_symbols_.size();
+      trie_symbols_.push_back(no_symbol);
+    }
+
+    node = child;
+  }
+
+  trie_symbols_[node] = ids_.at(symbol);
+}
+
+/*!
+ *  Rebuild the trie with the current Alphabet symbols.
+ */
+void Alphabet::buildTrie() {
+  root_edges_.fill(no_node);
+  trie_edges_.clear();
+  trie_symbols_.assign(1, no_symbol);
+
+  for (const auto &symbol : alphabet_symbols_) {
+    addToTrie(symbol);
+  }
+}
+
+/*!
+ *  Clear the symbol table, leaving only the blank symbol.
+ */
+void Alphabet::resetIds() {
+  symbols_.assign(1, blank_);
+  ids_.clear();
+  ids_[blank_] = blank_id;
 }
 
 }  // namespace turing
@@ -1,17 +1,23 @@
 #pragma once
 
-#include <regex>
+#include <array>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include "utils/diagnostics.hpp"
 #include "utils/utils.hpp"
 
 namespace turing {
 
 class Alphabet {
 public:
-  Alphabet() = default;
+  static constexpr SymbolId blank_id{0};
+
+public:
+  Alphabet();
 
   bool empty() const noexcept;
   size_t size() const noexcept;
@@ -23,21 +29,45 @@ public:
 
   bool contains(Symbol symbol) const;
 
+  SymbolId id(const Symbol &symbol) const;
+  const Symbol &symbol(SymbolId id) const;
+  size_t numIds() const noexcept;
+
   void addSymbol(Symbol symbol);
   void setSymbols(const std::vector<Symbol> &symbols);
 
-  std::vector<Symbol> splitInSymbols(const std::string &symbols_str) const;
+  std::vector<Symbol> splitInSymbols(const std::string &symbols_str,
+                                     Diagnostics *diagnostics = nullptr) const;
+  std::vector<SymbolId> splitInIds(const std::string &symbols_str,
+                                   Diagnostics *diagnostics = nullptr) const;
 
   friend std::ostream &operator<<(std::ostream &os, const Alphabet &alphabet);
 
 private:
-  std::string regexStr() const;
+  void intern(const Symbol &symbol);
+  void resetIds();
+
+  void addToTrie(const Symbol &symbol);
+  void buildTrie();
+
+private:
+  static constexpr std::uint32_t no_node = 0;
+  static constexpr std::int32_t no_symbol = -1;
 
 private:
   std::string blank_{"."};
 
-  std::regex regex_;
   std::unordered_set<Symbol> alphabet_symbols_{blank_};
+
+  // Trie of the alphabet symbols, used to split strings. Node 0 is the root, so it
+  // can't be a child. The edges from the root are on a table indexed by character.
+  std::array<std::uint32_t, 256> root_edges_{};
+  std::unordered_map<std::uint64_t, std::uint32_t> trie_edges_;
+  std::vector<std::int32_t> trie_symbols_;
+
+  // Symbol table. The blank symbol is always interned as "blank_id".
+  std::vector<Symbol> symbols_{blank_};
+  std::unordered_map<Symbol, SymbolId> ids_{{blank_, blank_id}};
 };
 
 }  // namespace turing
@@ -0,0 +1,96 @@
+#include "inputfile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+namespace turing {
+
+/*!
+ *  \class InputFile
+ *  \brief Input string mapped from a file, read-only.
+ *
+ *  The file isn't read to memory: its pages are loaded by the system when they are
+ *  accessed, and can be dropped again under memory pressure. Used as the input layer
+ *  of a Tape (See Tape::setInputFile), so huge inputs aren't copied.
+ *
+ *  A line break at the end of the file isn't part of the input.
+ */
+
+/*!
+ *  Map the file.
+ *
+ *  !WARNING: Throw if the file can't be read or mapped.
+ */
+InputFile::InputFile(const std::string& file_path) : path_(file_path) {
+  int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Can't read input file: " + file_path);
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) < 0) {
+    ::close(fd);
+    throw std::runtime_error("Can't read input file: " + file_path);
+  }
+
+  mapped_size_ = file_stat.st_size;
+
+  // Empty files can't be mapped
+  if (mapped_size_ > 0) {
+    void* data = ::mmap(nullptr, mapped_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Can't map input file: " + file_path);
+    }
+
+    // The input is read sequentially by the tape head
+    ::madvise(data, mapped_size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(data);
+  }
+
+  ::close(fd);
+
+  size_ = mapped_size_;
+  if (size_ > 0 && data_[size_ - 1] == '\n') {
+    --size_;
+  }
+  if (size_ > 0 && data_[size_ - 1] == '\r') {
+    --size_;
+  }
+}
+
+/*!
+ *  Unmap the file.
+ */
+InputFile::~InputFile() {
+  if (data_) {
+    ::munmap(const_cast<char*>(data_), mapped_size_);
+  }
+}
+
+/*!
+ *  Return the path of the file.
+ */
+const std::string& InputFile::path() const {
+  return path_;
+}
+
+/*!
+ *  Return the characters of the input.
+ */
+const char* InputFile::data() const {
+  return data_;
+}
+
+/*!
+ *  Return the number of characters of the input.
+ */
+size_t InputFile::size() const {
+  return size_;
+}
+
+}  // namespace turing
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace turing {
+
+class InputFile {
+public:
+  explicit InputFile(const std::string& file_path);
+  ~InputFile();
+
+  InputFile(const InputFile&) = delete;
+  InputFile& operator=(const InputFile&) = delete;
+
+  const std::string& path() const;
+
+  const char* data() const;
+  size_t size() const;
+
+private:
+  std::string path_;
+
+  const char* data_{nullptr};
+  size_t size_{0};
+
+  // Size of the mapping (The size can exclude the final line break)
+  size_t mapped_size_{0};
+};
+
+}  // namespace turing
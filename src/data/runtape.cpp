@@ -0,0 +1,232 @@
+#include "runtape.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace turing {
+
+/*!
+ *  \class RunTape
+ *  \brief Tape stored as runs of identical symbols.
+ *
+ *  A tape like "1^5000 0 1^3000" is stored as three runs instead of 8001 cells. The
+ *  runs at the left and the right of the head are kept on two stacks, with the run
+ *  next to the head on top, so moving the head is O(1).
+ *
+ *  Besides single steps, a whole run can be rewritten while the head crosses it
+ *  ("sweep"), which is what a transition that loops on its own state does.
+ */
+
+/*!
+ *  Build the runs of a Tape.
+ */
+RunTape::RunTape(const Tape& tape)
+    : head_symbol_(tape.peekId()), head_(tape.head()) {
+  if (!tape.empty()) {
+    first_written_ = tape.firstWritten();
+    last_written_ = tape.lastWritten();
+  }
+
+  for (std::int64_t i = std::min<std::int64_t>(first_written_, head_); i < head_; ++i) {
+    push(left_, tape.peekId(i), 1);
+  }
+
+  for (std::int64_t i = std::max<std::int64_t>(last_written_, head_); i > head_; --i) {
+    push(right_, tape.peekId(i), 1);
+  }
+}
+
+/*!
+ *  Return the position of the head.
+ */
+std::int64_t RunTape::head() const {
+  return head_;
+}
+
+/*!
+ *  Return the number of runs stored (Not counting the cell under the head).
+ */
+size_t RunTape::numRuns() const {
+  return left_.size() + right_.size();
+}
+
+/*!
+ *  Return the symbol id under the head.
+ */
+SymbolId RunTape::peekId() const {
+  return head_symbol_;
+}
+
+/*!
+ *  Write a symbol id under the head.
+ */
+void RunTape::writeId(SymbolId id) {
+  head_symbol_ = id;
+
+  first_written_ = std::min(first_written_, head_);
+  last_written_ = std::max(last_written_, head_);
+}
+
+/*!
+ *  Move the head one cell in the given direction.
+ */
+void RunTape::move(Move dir) {
+  if (dir != Move::Stop) {
+    shift(dir, 1, head_symbol_);
+  }
+}
+
+/*!
+ *  Return the number of consecutive cells with the symbol under the head, starting
+ *  from the head (included) in the given direction.
+ *  Return "unbounded" if they are blanks that reach the end of the tape.
+ */
+std::uint64_t RunTape::runLength(Move dir) const {
+  if (dir == Move::Stop) {
+    return 1;
+  }
+
+  const auto& ahead = (dir == Move::Right) ? right_ : left_;
+
+  if (ahead.empty()) {
+    return (head_symbol_ == Alphabet::blank_id) ? unbounded : 1;
+  }
+
+  // Adjacent runs never have the same symbol, so only the top one can continue the
+  // run under the head.
+  if (ahead.back().symbol != head_symbol_) {
+    return 1;
+  }
+
+  if (head_symbol_ == Alphabet::blank_id && ahead.size() == 1) {
+    return unbounded;
+  }
+
+  return ahead.back().length + 1;
+}
+
+/*!
+ *  Write "id" on "cells" cells while moving the head in the given direction, starting
+ *  from the head. The head ends on the cell next to the last one written.
+ *  "cells" can't be bigger than "runLength(dir)".
+ */
+void RunTape::sweep(SymbolId id, Move dir, std::uint64_t cells) {
+  if (cells == 0) {
+    return;
+  }
+
+  if (dir == Move::Stop) {
+    writeId(id);
+    return;
+  }
+
+  std::int64_t last = head_ + ((dir == Move::Right) ? 1 : -1) * std::int64_t(cells - 1);
+  first_written_ = std::min({first_written_, head_, last});
+  last_written_ = std::max({last_written_, head_, last});
+
+  shift(dir, cells, id);
+}
+
+/*!
+ *  Copy the written cells and the head position to a Tape.
+ *
+ *  !WARNING: Throw if the positions don't fit on the Tape.
+ */
+void RunTape::writeTo(Tape& tape) const {
+  if (first_written_ < std::numeric_limits<int>::min() ||
+      last_written_ > std::numeric_limits<int>::max() ||
+      head_ < std::numeric_limits<int>::min() || head_ > std::numeric_limits<int>::max()) {
+    throw std::runtime_error("Tape too long to be stored cell by cell.");
+  }
+
+  auto move_to = [&tape](std::int64_t position) {
+    while (tape.head() > position) {
+      tape.move(Move::Left);
+    }
+    while (tape.head() < position) {
+      tape.move(Move::Right);
+    }
+  };
+
+  // Leftmost position stored
+  std::int64_t position = head_;
+  for (const auto& run : left_) {
+    position -= run.length;
+  }
+
+  // Write the cells from left to right
+  auto write = [&](SymbolId id, std::uint64_t length) {
+    std::int64_t first = std::max(position, first_written_);
+    std::int64_t last = std::min<std::int64_t>(position + length - 1, last_written_);
+
+    if (first <= last) {
+      move_to(first);
+      for (std::int64_t i = first; i <= last; ++i) {
+        tape.writeId(id);
+        tape.move(Move::Right);
+      }
+    }
+
+    position += length;
+  };
+
+  for (const auto& run : left_) {
+    write(run.symbol, run.length);
+  }
+
+  write(head_symbol_, 1);
+
+  for (auto it = right_.rbegin(); it != right_.rend(); ++it) {
+    write(it->symbol, it->length);
+  }
+
+  move_to(head_);
+}
+
+/*!
+ *  Move the head "cells" cells in the given direction, leaving "id" on the cells it
+ *  crosses (Including the one under the head).
+ */
+void RunTape::shift(Move dir, std::uint64_t cells, SymbolId id) {
+  auto& ahead = (dir == Move::Right) ? right_ : left_;
+  auto& behind = (dir == Move::Right) ? left_ : right_;
+
+  push(behind, id, cells);
+
+  // Drop the crossed cells, and take the next one as the head
+  std::uint64_t crossed = cells - 1;
+  while (crossed && !ahead.empty()) {
+    std::uint64_t taken = std::min(crossed, ahead.back().length);
+    ahead.back().length -= taken;
+    crossed -= taken;
+
+    if (ahead.back().length == 0) {
+      ahead.pop_back();
+    }
+  }
+
+  if (ahead.empty()) {
+    head_symbol_ = Alphabet::blank_id;
+  } else {
+    head_symbol_ = ahead.back().symbol;
+    if (--ahead.back().length == 0) {
+      ahead.pop_back();
+    }
+  }
+
+  head_ += ((dir == Move::Right) ? 1 : -1) * std::int64_t(cells);
+}
+
+/*!
+ *  Add "length" cells with "id" on top of the runs, merging them with the top run if
+ *  it has the same symbol.
+ */
+void RunTape::push(std::vector<Run>& runs, SymbolId id, std::uint64_t length) {
+  if (!runs.empty() && runs.back().symbol == id) {
+    runs.back().length += length;
+  } else {
+    runs.push_back({id, length});
+  }
+}
+
+}  // namespace turing
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "data/tape.hpp"
+#include "utils/utils.hpp"
+
+namespace turing {
+
+class RunTape {
+public:
+  // Cells of a sweep that never ends (Blanks up to the end of the tape)
+  static constexpr std::uint64_t unbounded = std::numeric_limits<std::uint64_t>::max();
+
+  // "length" consecutive cells with the same symbol
+  struct Run {
+    SymbolId symbol;
+    std::uint64_t length;
+  };
+
+public:
+  explicit RunTape(const Tape& tape);
+
+  std::int64_t head() const;
+  size_t numRuns() const;
+
+  SymbolId peekId() const;
+  void writeId(SymbolId id);
+
+  void move(Move dir);
+
+  std::uint64_t runLength(Move dir) const;
+  void sweep(SymbolId id, Move dir, std::uint64_t cells);
+
+  void writeTo(Tape& tape) const;
+
+private:
+  void shift(Move dir, std::uint64_t cells, SymbolId id);
+
+  static void push(std::vector<Run>& runs, SymbolId id, std::uint64_t length);
+
+private:
+  // Runs at each side of the head. The back is the run next to the head.
+  std::vector<Run> left_;
+  std::vector<Run> right_;
+
+  SymbolId head_symbol_{0};
+  std::int64_t head_{0};
+
+  // Range of written cells
+  std::int64_t first_written_{std::numeric_limits<std::int64_t>::max()};
+  std::int64_t last_written_{std::numeric_limits<std::int64_t>::min()};
+};
+
+}  // namespace turing
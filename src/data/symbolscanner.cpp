@@ -0,0 +1,290 @@
+#include "symbolscanner.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace turing {
+
+/*!
+ *  \class SymbolScanner
+ *  \brief Find the extent of a run of cells whose symbols belong to a set.
+ *
+ *  Used to cross the cells a scan loop (p.e. "q0 0 q0 0 R", "q0 1 q0 1 R") goes
+ *  over, on contiguous cells. Sets of up to "max_vector_symbols" symbols are compared
+ *  with vector instructions: each block of cells is compared with every symbol, and
+ *  the first cell out of the set is found on the mask of the matches.
+ *
+ *  AVX2 (16 cells per block) is used if the processor supports it, SSE2 (8 cells)
+ *  otherwise. Without them, or for bigger sets, the cells are checked one by one.
+ */
+
+namespace {
+
+#if defined(__SSE2__)
+
+/*!
+ *  Number of leading cells with a symbol of the set, comparing 8 cells at a time.
+ *  Only complete blocks are compared: if all of them are on the set, the remaining
+ *  cells must be checked one by one.
+ */
+size_t spanRightSse2(const SymbolId* cells,
+                     size_t size,
+                     const SymbolId* symbols,
+                     size_t num_symbols) {
+  __m128i keys[SymbolScanner::max_vector_symbols];
+  for (size_t k = 0; k < num_symbols; ++k) {
+    keys[k] = _mm_set1_epi16(static_cast<short>(symbols[k]));
+  }
+
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + i));
+
+    __m128i match = _mm_cmpeq_epi16(block, keys[0]);
+    for (size_t k = 1; k < num_symbols; ++k) {
+      match = _mm_or_si128(match, _mm_cmpeq_epi16(block, keys[k]));
+    }
+
+    // Two bits for each cell
+    unsigned mask = _mm_movemask_epi8(match);
+    if (mask != 0xFFFF) {
+      return i + __builtin_ctz(~mask) / 2;
+    }
+  }
+
+  return i;
+}
+
+/*!
+ *  Number of trailing cells with a symbol of the set, comparing 8 cells at a time.
+ *  As "spanRightSse2", only complete blocks are compared.
+ */
+size_t spanLeftSse2(const SymbolId* cells,
+                    size_t size,
+                    const SymbolId* symbols,
+                    size_t num_symbols) {
+  __m128i keys[SymbolScanner::max_vector_symbols];
+  for (size_t k = 0; k < num_symbols; ++k) {
+    keys[k] = _mm_set1_epi16(static_cast<short>(symbols[k]));
+  }
+
+  size_t end = size;
+  for (; end >= 8; end -= 8) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cells + end - 8));
+
+    __m128i match = _mm_cmpeq_epi16(block, keys[0]);
+    for (size_t k = 1; k < num_symbols; ++k) {
+      match = _mm_or_si128(match, _mm_cmpeq_epi16(block, keys[k]));
+    }
+
+    unsigned mask = ~_mm_movemask_epi8(match) & 0xFFFF;
+    if (mask) {
+      size_t last_out = (31 - __builtin_clz(mask)) / 2;
+      return size - (end - 8 + last_out + 1);
+    }
+  }
+
+  return size - end;
+}
+
+#endif
+
+#if defined(__SSE2__) && defined(__x86_64__) && defined(__GNUC__)
+#define TURING_HAS_AVX2 1
+
+/*!
+ *  As "spanRightSse2", comparing 16 cells at a time.
+ */
+__attribute__((target("avx2"))) size_t spanRightAvx2(const SymbolId* cells,
+                                                     size_t size,
+                                                     const SymbolId* symbols,
+                                                     size_t num_symbols) {
+  __m256i keys[SymbolScanner::max_vector_symbols];
+  for (size_t k = 0; k < num_symbols; ++k) {
+    keys[k] = _mm256_set1_epi16(static_cast<short>(symbols[k]));
+  }
+
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + i));
+
+    __m256i match = _mm256_cmpeq_epi16(block, keys[0]);
+    for (size_t k = 1; k < num_symbols; ++k) {
+      match = _mm256_or_si256(match, _mm256_cmpeq_epi16(block, keys[k]));
+    }
+
+    unsigned mask = _mm256_movemask_epi8(match);
+    if (mask != 0xFFFFFFFF) {
+      return i + __builtin_ctz(~mask) / 2;
+    }
+  }
+
+  return i;
+}
+
+/*!
+ *  As "spanLeftSse2", comparing 16 cells at a time.
+ */
+__attribute__((target("avx2"))) size_t spanLeftAvx2(const SymbolId* cells,
+                                                    size_t size,
+                                                    const SymbolId* symbols,
+                                                    size_t num_symbols) {
+  __m256i keys[SymbolScanner::max_vector_symbols];
+  for (size_t k = 0; k < num_symbols; ++k) {
+    keys[k] = _mm256_set1_epi16(static_cast<short>(symbols[k]));
+  }
+
+  size_t end = size;
+  for (; end >= 16; end -= 16) {
+    __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cells + end - 16));
+
+    __m256i match = _mm256_cmpeq_epi16(block, keys[0]);
+    for (size_t k = 1; k < num_symbols; ++k) {
+      match = _mm256_or_si256(match, _mm256_cmpeq_epi16(block, keys[k]));
+    }
+
+    unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(match));
+    if (mask) {
+      size_t last_out = (31 - __builtin_clz(mask)) / 2;
+      return size - (end - 16 + last_out + 1);
+    }
+  }
+
+  return size - end;
+}
+
+#endif
+
+}  // namespace
+
+/*!
+ *  Prepare to scan for the given symbols, choosing the instructions used.
+ */
+SymbolScanner::SymbolScanner(const std::vector<SymbolId>& symbols) {
+  for (SymbolId symbol : symbols) {
+    if (!contains(symbol)) {
+      symbols_.push_back(symbol);
+      member_.resize(std::max<size_t>(member_.size(), symbol + 1), false);
+      member_[symbol] = true;
+    }
+  }
+
+  if (symbols_.empty() || symbols_.size() > max_vector_symbols) {
+    return;
+  }
+
+#if defined(TURING_HAS_AVX2)
+  if (__builtin_cpu_supports("avx2")) {
+    instruction_set_ = InstructionSet::Avx2;
+    return;
+  }
+#endif
+
+#if defined(__SSE2__)
+  instruction_set_ = InstructionSet::Sse2;
+#endif
+}
+
+/*!
+ *  Check if the symbol is on the set.
+ */
+bool SymbolScanner::contains(SymbolId symbol) const {
+  return symbol < member_.size() && member_[symbol];
+}
+
+/*!
+ *  Return the instructions used to compare the cells.
+ */
+SymbolScanner::InstructionSet SymbolScanner::instructionSet() const {
+  return instruction_set_;
+}
+
+/*!
+ *  Return the number of consecutive cells with a symbol of the set, from the first
+ *  cell of [cells, cells + size) to the right.
+ */
+size_t SymbolScanner::spanRight(const SymbolId* cells, size_t size) const {
+  size_t span = 0;
+
+  switch (instruction_set_) {
+#if defined(TURING_HAS_AVX2)
+    case InstructionSet::Avx2:
+      span = spanRightAvx2(cells, size, symbols_.data(), symbols_.size());
+      break;
+#endif
+#if defined(__SSE2__)
+    case InstructionSet::Sse2:
+      span = spanRightSse2(cells, size, symbols_.data(), symbols_.size());
+      break;
+#endif
+    default:
+      break;
+  }
+
+  // The cells that don't fill a block (If the span ended on a block, the next cell
+  // isn't on the set)
+  if (span == size) {
+    return span;
+  }
+
+  return span + spanRightScalar(cells + span, size - span);
+}
+
+/*!
+ *  Return the number of consecutive cells with a symbol of the set, from the last
+ *  cell of [cells, cells + size) to the left.
+ */
+size_t SymbolScanner::spanLeft(const SymbolId* cells, size_t size) const {
+  size_t span = 0;
+
+  switch (instruction_set_) {
+#if defined(TURING_HAS_AVX2)
+    case InstructionSet::Avx2:
+      span = spanLeftAvx2(cells, size, symbols_.data(), symbols_.size());
+      break;
+#endif
+#if defined(__SSE2__)
+    case InstructionSet::Sse2:
+      span = spanLeftSse2(cells, size, symbols_.data(), symbols_.size());
+      break;
+#endif
+    default:
+      break;
+  }
+
+  if (span == size) {
+    return span;
+  }
+
+  return span + spanLeftScalar(cells, size - span);
+}
+
+/*!
+ *  Count the leading cells of the set one by one.
+ */
+size_t SymbolScanner::spanRightScalar(const SymbolId* cells, size_t size) const {
+  size_t span = 0;
+  while (span < size && contains(cells[span])) {
+    ++span;
+  }
+
+  return span;
+}
+
+/*!
+ *  Count the trailing cells of the set one by one.
+ */
+size_t SymbolScanner::spanLeftScalar(const SymbolId* cells, size_t size) const {
+  size_t span = 0;
+  while (span < size && contains(cells[size - span - 1])) {
+    ++span;
+  }
+
+  return span;
+}
+
+}  // namespace turing
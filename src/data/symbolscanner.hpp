@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "utils/utils.hpp"
+
+namespace turing {
+
+class SymbolScanner {
+public:
+  // Max symbols of a set compared with vector instructions
+  static constexpr size_t max_vector_symbols = 4;
+
+  enum class InstructionSet { Scalar, Sse2, Avx2 };
+
+public:
+  explicit SymbolScanner(const std::vector<SymbolId>& symbols = {});
+
+  bool contains(SymbolId symbol) const;
+  InstructionSet instructionSet() const;
+
+  size_t spanRight(const SymbolId* cells, size_t size) const;
+  size_t spanLeft(const SymbolId* cells, size_t size) const;
+
+private:
+  size_t spanRightScalar(const SymbolId* cells, size_t size) const;
+  size_t spanLeftScalar(const SymbolId* cells, size_t size) const;
+
+private:
+  std::vector<SymbolId> symbols_;
+
+  // Membership of each symbol id
+  std::vector<char> member_;
+
+  InstructionSet instruction_set_{InstructionSet::Scalar};
+};
+
+}  // namespace turing
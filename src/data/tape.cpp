@@ -1,7 +1,9 @@
 #include "tape.hpp"
 
+#include <algorithm>
 #include <iomanip>
 
+#include "data/inputfile.hpp"
 #include "utils/utils.hpp"
 
 namespace turing {
@@ -12,12 +14,47 @@ namespace turing {
  *
  *  All symbols on the Tape must be recognized by the alphabet.
  *  The Tape head can move to Left/Right/Stop.
+ *
+ *  Cells store the SymbolId given by the alphabet. peek/write translate from/to
+ *  strings, while peekId/writeId work directly with ids.
+ *
+ *  The "infinite" tape is split in fixed size pages of contiguous cells. The page
+ *  table is centered on the page 0 and doubles its size when a page out of it is
+ *  written. Pages never written are blank (The blank symbol is always the id 0).
+ *
+ *  Copying a Tape is O(1): copies share the page table and the pages, and only the
+ *  table and the pages that are written afterwards are cloned (copy-on-write). This
+ *  makes branching on Non-Deterministic machines cheap. Copies can be used by
+ *  different threads: the check for a shared page is synchronized (See RefPtr).
+ *
+ *  The input can also be an InputFile mapped on memory, as a read-only layer under
+ *  the pages (See "setInputFile"). Pages of the input are decoded when the head
+ *  reaches them, and stored when they are written, so it's never copied as a whole.
+ *  Its characters are checked as they are decoded.
  */
 
+namespace {
+
+// Initial number of pages of the page table
+constexpr int initial_pages = 2;
+
+// Head displacement for each Move (Left, Right, Stop)
+constexpr int move_delta[] = {-1, 1, 0};
+
+}  // namespace
+
+const Tape::Page Tape::blank_page_{};
+
 /*!
  *  Construct a Tape object with the given alphabet.
  */
-Tape::Tape(const Alphabet& alphabet) : alphabet_(alphabet) {}
+Tape::Tape(const Alphabet& alphabet)
+    : table_(RefPtr<PageTable>::make()), alphabet_(alphabet) {
+  table_->offset = initial_pages / 2;
+  table_->pages.resize(initial_pages);
+
+  loadPage();
+}
 
 /*!
  *  Return the Alphabet associated with this Tape.
@@ -30,14 +67,36 @@ const Alphabet& Tape::alphabet() const {
  *  Return if the Tape is empty.
  */
 bool Tape::empty() const {
-  return data_.empty();
+  return first_written_ > last_written_;
+}
+
+/*!
+ *  Return the position of the head. The input string starts at position 0.
+ */
+int Tape::head() const {
+  return tape_head_;
+}
+
+/*!
+ *  Return the position of the leftmost written cell. Greater than "lastWritten" if
+ *  the Tape is empty.
+ */
+int Tape::firstWritten() const {
+  return first_written_;
+}
+
+/*!
+ *  Return the position of the rightmost written cell.
+ */
+int Tape::lastWritten() const {
+  return last_written_;
 }
 
 /*!
  *  Get the current symbol pointed by the tape head.
  */
 Symbol Tape::peek() const {
-  return at(tape_head_);
+  return alphabet_.get().symbol(peekId());
 }
 
 /*!
@@ -51,68 +110,387 @@ void Tape::write(Symbol symbol) {
     throw std::runtime_error("Can't write Symbol " + symbol + ". Not in Alphabet.");
   }
 
-  data_[tape_head_] = symbol;
+  writeId(alphabet_.get().id(symbol));
+}
+
+/*!
+ *  Get the id of the current symbol pointed by the tape head.
+ */
+SymbolId Tape::peekId() const {
+  return current_cells_[tape_head_ & page_mask];
+}
+
+/*!
+ *  Return the symbol id on any position of the tape, without moving the head.
+ */
+SymbolId Tape::peekId(int position) const {
+  return at(position);
+}
+
+/*!
+ *  Write a new symbol id on the tape head position.
+ *  The id must have been obtained from the Tape alphabet.
+ */
+void Tape::writeId(SymbolId id) {
+  Page& page = writablePage(current_page_);
+  page[tape_head_ & page_mask] = id;
+
+  // The page could have been cloned
+  current_cells_ = page.data();
+
+  first_written_ = std::min(first_written_, tape_head_);
+  last_written_ = std::max(last_written_, tape_head_);
 }
 
 /*!
  *  Move the tape head in the given direction.
  */
 void Tape::move(Move dir) {
-  switch (dir) {
-    case Move::Left:
-      --tape_head_;
-      break;
+  tape_head_ += move_delta[static_cast<int>(dir)];
 
-    case Move::Right:
-      ++tape_head_;
-      break;
-
-    case Move::Stop:
-    default:
-      break;
+  if ((tape_head_ >> page_bits) != current_page_) {
+    loadPage();
   }
 }
 
+/*!
+ *  Move the tape head to the position at once.
+ */
+void Tape::seek(int position) {
+  tape_head_ = position;
+  loadPage();
+}
+
 /*!
  *  Clear all data from the Tape and reset the head to 0.
+ *  Pages not shared with other Tapes are kept to be reused.
  */
 void Tape::reset() {
+  if (table_.unique()) {
+    for (auto& page : table_->pages) {
+      if (page.unique()) {
+        page->fill(Alphabet::blank_id);
+      } else {
+        page.reset();
+      }
+    }
+  } else {
+    table_ = RefPtr<PageTable>::make();
+    table_->offset = initial_pages / 2;
+    table_->pages.resize(initial_pages);
+  }
+
+  input_.reset();
+  input_page_.reset();
+
   tape_head_ = 0;
-  data_.clear();
+  first_written_ = std::numeric_limits<int>::max();
+  last_written_ = std::numeric_limits<int>::min();
+
+  loadPage();
 }
 
 /*!
  *  Split the input string using the input alphabet and write it on the tape.
  *
- *  !WARNING: input symbols that aren't on the alphabet will be ignored.
- *  If a symbol can't be written on the Tape, an exception will be thrown.
+ *  !WARNING: input symbols that aren't on the alphabet will be ignored (and reported on
+ *  "diagnostics"). If a symbol can't be written on the Tape, an exception will be
+ *  thrown.
  *
  */
 void Tape::setInputString(const std::string& input_line,
-                          const Alphabet& input_alphabet) {
+                          const Alphabet& input_alphabet,
+                          Diagnostics* diagnostics) {
   reset();
 
-  auto symbols = input_alphabet.splitInSymbols(input_line);
+  // Ids of the input alphabet translated to ids of the Tape alphabet (-1 if unknown)
+  std::vector<std::int32_t> tape_ids(input_alphabet.numIds(), -1);
 
-  for (int i = 0; i < symbols.size(); ++i) {
-    write(symbols[i]);
+  for (const auto& input_id : input_alphabet.splitInIds(input_line, diagnostics)) {
+    if (tape_ids[input_id] == -1) {
+      const Symbol& symbol = input_alphabet.symbol(input_id);
+      if (!alphabet().contains(symbol) && symbol != alphabet().blank()) {
+        throw std::runtime_error("Can't write Symbol " + symbol + ". Not in Alphabet.");
+      }
+
+      tape_ids[input_id] = alphabet().id(symbol);
+    }
+
+    writeId(tape_ids[input_id]);
     move(Move::Right);
   }
 
   tape_head_ = 0;
+  loadPage();
+}
+
+/*!
+ *  Use the file as input, without copying it: its characters are the cells of the
+ *  Tape from the position 0, until they are written. Loading it is O(1): the file
+ *  isn't read until the cells are.
+ *
+ *  Each character should be a symbol of the input alphabet. The ones that aren't are
+ *  read as blanks, and the first one read is reported by "reportInput". With
+ *  "check_all", the whole file is checked first instead (Reading all of it).
+ *
+ *  !WARNING: Throw if a symbol of the input alphabet has more than one character, if
+ *  it can't be written on the Tape, if the file has more cells than the ones a Tape
+ *  can index, or (With "check_all") if a character of the file isn't on the input
+ *  alphabet.
+ */
+void Tape::setInputFile(std::shared_ptr<const InputFile> input_file,
+                        const Alphabet& input_alphabet,
+                        bool check_all) {
+  reset();
+
+  if (input_file->size() >= static_cast<size_t>(std::numeric_limits<int>::max())) {
+    throw std::runtime_error("Input file too big: " + input_file->path());
+  }
+
+  auto layer = std::make_shared<InputLayer>();
+  layer->file = input_file;
+  layer->size = input_file->size();
+
+  // Tape ids of the characters. Characters out of the input alphabet are invalid.
+  constexpr std::uint32_t invalid = std::numeric_limits<std::uint32_t>::max();
+  std::array<std::uint32_t, 256> ids;
+  ids.fill(invalid);
+
+  for (SymbolId input_id = 1; input_id < input_alphabet.numIds(); ++input_id) {
+    const Symbol& symbol = input_alphabet.symbol(input_id);
+    if (symbol.size() != 1) {
+      throw std::runtime_error("Input files need symbols of a single character: " +
+                               symbol);
+    }
+
+    if (!alphabet().contains(symbol) && symbol != alphabet().blank()) {
+      throw std::runtime_error("Can't write Symbol " + symbol + ". Not in Alphabet.");
+    }
+
+    ids[static_cast<unsigned char>(symbol[0])] = alphabet().id(symbol);
+  }
+
+  const char* data = input_file->data();
+  for (int i = 0; check_all && i < layer->size; ++i) {
+    if (ids[static_cast<unsigned char>(data[i])] == invalid) {
+      throw std::runtime_error("Unrecognized symbol on input file " +
+                               input_file->path() + " at " + std::to_string(i) +
+                               ": " + std::string(1, data[i]));
+    }
+  }
+
+  for (size_t c = 0; c < ids.size(); ++c) {
+    layer->known[c] = ids[c] != invalid;
+    layer->ids[c] = (ids[c] == invalid) ? Alphabet::blank_id : ids[c];
+  }
+
+  input_ = std::move(layer);
+  if (input_->size > 0) {
+    first_written_ = 0;
+    last_written_ = input_->size - 1;
+  }
+
+  loadPage();
+}
+
+/*!
+ *  Check if the Tape has an input file under its pages (See "setInputFile").
+ */
+bool Tape::hasInputFile() const {
+  return input_ != nullptr;
+}
+
+/*!
+ *  Add a warning to "diagnostics" if a character of the input file that isn't on the
+ *  input alphabet has been read (By this Tape or any of its copies).
+ */
+void Tape::reportInput(Diagnostics& diagnostics) const {
+  if (!input_) {
+    return;
+  }
+
+  int position = input_->first_unknown.load(std::memory_order_relaxed);
+  if (position == std::numeric_limits<int>::max()) {
+    return;
+  }
+
+  diagnostics.add("Unrecognized symbol on input file " + input_->file->path() + " at " +
+                  std::to_string(position) + ": " +
+                  std::string(1, input_->file->data()[position]) + " (Read as blank)");
+}
+
+/*!
+ *  Hash of the non-blank cells, relative to the tape head.
+ *  Equivalent Tapes have the same hash.
+ */
+size_t Tape::hash() const {
+  size_t seed = 0;
+
+  auto combine = [&seed](size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+
+  for (int i = first_written_; i <= last_written_; ++i) {
+    SymbolId id = at(i);
+    if (id != Alphabet::blank_id) {
+      combine(i - tape_head_);
+      combine(id);
+    }
+  }
+
+  return seed;
+}
+
+/*!
+ *  Check if both Tapes have the same symbols around the tape head.
+ *  As the Turing machine only sees the cells relative to the head, two equivalent
+ *  Tapes behave the same even if their heads are on different positions.
+ */
+bool Tape::equivalent(const Tape& other) const {
+  // Union of the written ranges of both tapes, relative to each tape head
+  long first = std::numeric_limits<long>::max();
+  long last = std::numeric_limits<long>::min();
+
+  for (const Tape* tape : {this, &other}) {
+    if (!tape->empty()) {
+      first = std::min<long>(first, tape->first_written_ - tape->tape_head_);
+      last = std::max<long>(last, tape->last_written_ - tape->tape_head_);
+    }
+  }
+
+  for (long i = first; i <= last; ++i) {
+    if (at(tape_head_ + i) != other.at(other.tape_head_ + i)) {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 /*!
  *  Return the element at the position "idx".
- *  Because we're using a map to simulate an "infinite" tape, return blank if the index
- *  isn't contained on the map, or the element otherwise.
  */
-Symbol Tape::at(int idx) const {
-  if (!data_.count(idx)) {
-    return alphabet_.get().blank();
+SymbolId Tape::at(int idx) const {
+  const Page* page = pageAt(idx >> page_bits);
+  if (page) {
+    return (*page)[idx & page_mask];
+  }
+
+  if (input_ && idx >= 0 && idx < input_->size) {
+    return input_->decode(idx);
+  }
+
+  return Alphabet::blank_id;
+}
+
+/*!
+ *  Return the page "page_idx", or null if it was never written.
+ */
+const Tape::Page* Tape::pageAt(int page_idx) const {
+  size_t idx = page_idx + table_->offset;
+  if (idx >= table_->pages.size()) {
+    return nullptr;
+  }
+
+  return table_->pages[idx].get();
+}
+
+/*!
+ *  Return the page "page_idx" ready to be written.
+ *  If the page table or the page are shared with other Tape, clone them first. If the
+ *  page doesn't fit on the page table, double its size until it fits.
+ */
+Tape::Page& Tape::writablePage(int page_idx) {
+  if (!table_.unique()) {
+    table_ = RefPtr<PageTable>::make(*table_);
+  }
+
+  auto& table = *table_;
+
+  while (static_cast<size_t>(page_idx + table.offset) >= table.pages.size()) {
+    int size = table.pages.size();
+
+    std::vector<RefPtr<Page>> new_pages(size * 2);
+    std::move(table.pages.begin(), table.pages.end(), new_pages.begin() + size / 2);
+
+    table.pages.swap(new_pages);
+    table.offset += size / 2;
+  }
+
+  auto& page = table.pages[page_idx + table.offset];
+  if (!page) {
+    page = RefPtr<Page>::make(blank_page_);
+    readInput(page_idx, *page);
+  } else if (!page.unique()) {
+    page = RefPtr<Page>::make(*page);
+  }
+
+  return *page;
+}
+
+/*!
+ *  Point the current page to the one that contains the tape head.
+ */
+void Tape::loadPage() {
+  current_page_ = tape_head_ >> page_bits;
+
+  const Page* page = pageAt(current_page_);
+  if (page) {
+    current_cells_ = page->data();
+    return;
+  }
+
+  // Decode the page of the input file, reusing the last one if it isn't shared
+  if (input_ && current_page_ >= 0 &&
+      current_page_ <= ((input_->size - 1) >> page_bits)) {
+    if (!input_page_ || input_page_idx_ != current_page_) {
+      if (!input_page_.unique()) {
+        input_page_ = RefPtr<Page>::make();
+      }
+
+      input_page_->fill(Alphabet::blank_id);
+      readInput(current_page_, *input_page_);
+      input_page_idx_ = current_page_;
+    }
+
+    current_cells_ = input_page_->data();
+    return;
+  }
+
+  current_cells_ = blank_page_.data();
+}
+
+/*!
+ *  Copy the cells of the input file that are on the page "page_idx".
+ */
+void Tape::readInput(int page_idx, Page& page) const {
+  if (!input_) {
+    return;
+  }
+
+  long first = std::max<long>(long(page_idx) << page_bits, 0);
+  long last = std::min<long>((long(page_idx) + 1) << page_bits, input_->size);
+
+  for (long i = first; i < last; ++i) {
+    page[i & page_mask] = input_->decode(i);
+  }
+}
+
+/*!
+ *  Return the id of the character of the input file on the position. A character out
+ *  of the input alphabet is a blank, and its position is kept if it's the first one.
+ */
+SymbolId Tape::InputLayer::decode(int position) const {
+  auto c = static_cast<unsigned char>(file->data()[position]);
+  if (!known[c]) {
+    int first = first_unknown.load(std::memory_order_relaxed);
+    while (position < first &&
+           !first_unknown.compare_exchange_weak(first, position,
+                                                std::memory_order_relaxed)) {
+    }
   }
 
-  return data_.at(idx);
+  return ids[c];
 }
 
 /*!
@@ -124,8 +502,8 @@ std::ostream& operator<<(std::ostream& os, const Tape& tape) {
     return os;
   }
 
-  int first_cell_idx = tape.data_.cbegin()->first - 1;
-  int last_cell_idx = tape.data_.crbegin()->first + 1;
+  int first_cell_idx = tape.first_written_ - 1;
+  int last_cell_idx = tape.last_written_ + 1;
 
   // Write indices
   os << " ";
@@ -137,7 +515,7 @@ std::ostream& operator<<(std::ostream& os, const Tape& tape) {
   // Write tape tracks
   os << "[ ";
   for (int i = first_cell_idx; i <= last_cell_idx; ++i) {
-    os << tape.at(i) << " | ";
+    os << tape.alphabet().symbol(tape.at(i)) << " | ";
   }
 
   os << "\b\b]\n";
@@ -152,8 +530,8 @@ std::ostream& operator<<(std::ostream& os, const Tape& tape) {
  */
 std::ostream& operator<<(std::ostream& os, const std::vector<Tape>& tapes) {
   for (int i = 0; i < tapes.size(); ++i) {
-    os << "Tape " << i << std::endl;
-    os << tapes[i] << std::endl;
+    os << "Tape " << i << "\n";
+    os << tapes[i] << "\n";
   }
 
   return os;
@@ -1,14 +1,22 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <iostream>
-#include <map>
+#include <limits>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include "data/alphabet.hpp"
+#include "utils/diagnostics.hpp"
+#include "utils/refptr.hpp"
 #include "utils/utils.hpp"
 
 namespace turing {
 
+class InputFile;
+
 class Tape {
 public:
   explicit Tape(const Alphabet &alphabet = Alphabet());
@@ -16,25 +24,97 @@ public:
   const Alphabet &alphabet() const;
 
   bool empty() const;
+  int head() const;
+  int firstWritten() const;
+  int lastWritten() const;
 
   Symbol peek() const;
   void write(Symbol symbol);
 
+  SymbolId peekId() const;
+  SymbolId peekId(int position) const;
+  void writeId(SymbolId id);
+
   void move(Move dir);
+  void seek(int position);
 
   void reset();
 
-  void setInputString(const std::string &input_string, const Alphabet &input_alphabet);
+  void setInputString(const std::string &input_string,
+                      const Alphabet &input_alphabet,
+                      Diagnostics *diagnostics = nullptr);
+  void setInputFile(std::shared_ptr<const InputFile> input_file,
+                    const Alphabet &input_alphabet,
+                    bool check_all = false);
+  bool hasInputFile() const;
+  void reportInput(Diagnostics &diagnostics) const;
+
+  size_t hash() const;
+  bool equivalent(const Tape &other) const;
 
   friend std::ostream &operator<<(std::ostream &os, const Tape &tape);
   friend std::ostream &operator<<(std::ostream &os, const std::vector<Tape> &tapes);
 
+  friend class TapeStore;
+
+private:
+  static constexpr int page_bits = 9;
+  static constexpr int page_cells = 1 << page_bits;
+  static constexpr int page_mask = page_cells - 1;
+
+  using Page = std::array<SymbolId, page_cells>;
+
+  // Page "idx" is stored on pages[idx + offset]. Null pages are blank.
+  struct PageTable {
+    int offset{0};
+    std::vector<RefPtr<Page>> pages;
+  };
+
+  // Cells of an input file that weren't written (See setInputFile)
+  struct InputLayer {
+    std::shared_ptr<const InputFile> file;
+    int size;
+    std::array<SymbolId, 256> ids;
+
+    // Characters of the input alphabet, and the first position read with one that
+    // isn't (Shared by the copies of the Tape, on any thread)
+    std::array<bool, 256> known;
+    mutable std::atomic<int> first_unknown{std::numeric_limits<int>::max()};
+
+    SymbolId decode(int position) const;
+  };
+
+  static const Page blank_page_;
+
 private:
-  Symbol at(int idx) const;
+  SymbolId at(int idx) const;
+
+  const Page *pageAt(int page_idx) const;
+  Page &writablePage(int page_idx);
+
+  void loadPage();
+  void readInput(int page_idx, Page &page) const;
 
 private:
   int tape_head_{0};
-  std::map<int, Symbol> data_;
+
+  // Pages shared between copies of the Tape. Both the table and the pages are copied
+  // when written, only if they are shared with another Tape (Possibly owned by another
+  // thread, see RefPtr).
+  RefPtr<PageTable> table_;
+
+  // Page containing the tape head
+  int current_page_{0};
+  const SymbolId *current_cells_{nullptr};
+
+  // Input layer, and its page under the head if that page was never written
+  std::shared_ptr<const InputLayer> input_;
+  RefPtr<Page> input_page_;
+  int input_page_idx_{0};
+
+  // Range of written cells
+  int first_written_{std::numeric_limits<int>::max()};
+  int last_written_{std::numeric_limits<int>::min()};
 
   std::reference_wrapper<const Alphabet> alphabet_;
 };
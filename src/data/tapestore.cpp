@@ -0,0 +1,177 @@
+#include "tapestore.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace turing {
+
+/*!
+ *  \class TapeStore
+ *  \brief Write tapes to a binary stream and read them back, storing shared pages once.
+ *
+ *  Copies of a Tape share their pages (See Tape), so the tapes of the configurations of
+ *  a search have most of their pages in common. The store numbers each page the first
+ *  time it's written, and the next tapes refer to it by number. Reading the tapes in
+ *  the same order with another store shares the pages again, so the tapes take as
+ *  much memory as the ones written.
+ *
+ *  Tapes with an input file (See Tape::setInputFile) can't be stored.
+ */
+
+namespace {
+
+template <typename T>
+void writeValue(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T readValue(std::istream& is) {
+  T value{};
+  is.read(reinterpret_cast<char*>(&value), sizeof(value));
+  if (!is) {
+    throw std::runtime_error("Truncated tape data.");
+  }
+
+  return value;
+}
+
+// Number of bytes left to read on the stream
+std::uint64_t bytesLeft(std::istream& is) {
+  const auto position = is.tellg();
+  is.seekg(0, std::ios::end);
+  const auto end = is.tellg();
+  is.seekg(position);
+
+  return (position < 0 || end < position) ? 0 : end - position;
+}
+
+}  // namespace
+
+/*!
+ *  Create an empty store to read tapes. They are built with the given alphabet.
+ */
+TapeStore::TapeStore(const Alphabet& alphabet) : alphabet_(&alphabet) {}
+
+/*!
+ *  Write the tape: its head, its written range and its pages. The pages already
+ *  stored are written by number.
+ *
+ *  !WARNING: Throw if the tape has an input file.
+ */
+void TapeStore::write(std::ostream& os, const Tape& tape) {
+  if (tape.input_) {
+    throw std::runtime_error("Tapes with an input file can't be stored.");
+  }
+
+  const auto& table = *tape.table_;
+
+  writeValue<std::int32_t>(os, tape.tape_head_);
+  writeValue<std::int32_t>(os, tape.first_written_);
+  writeValue<std::int32_t>(os, tape.last_written_);
+  writeValue<std::int32_t>(os, table.offset);
+  writeValue<std::uint32_t>(os, table.pages.size());
+
+  // 0 for blank pages, or the number of the page plus one. New pages follow it.
+  for (const auto& page : table.pages) {
+    if (!page) {
+      writeValue<std::uint32_t>(os, 0);
+      continue;
+    }
+
+    auto inserted = page_ids_.emplace(page.get(), page_ids_.size());
+    writeValue<std::uint32_t>(os, inserted.first->second + 1);
+
+    if (inserted.second) {
+      os.write(reinterpret_cast<const char*>(page->data()), sizeof(Tape::Page));
+    }
+  }
+}
+
+/*!
+ *  Read the next tape written by "write".
+ *
+ *  !WARNING: Throw if the store has no alphabet, or if the data isn't a valid tape.
+ */
+Tape TapeStore::read(std::istream& is) {
+  if (!alphabet_) {
+    throw std::logic_error("Tapes can't be read without an alphabet.");
+  }
+
+  Tape tape(*alphabet_);
+
+  tape.tape_head_ = readValue<std::int32_t>(is);
+  tape.first_written_ = readValue<std::int32_t>(is);
+  tape.last_written_ = readValue<std::int32_t>(is);
+
+  auto table = RefPtr<Tape::PageTable>::make();
+  table->offset = readValue<std::int32_t>(is);
+
+  // Each page takes its number at least, so a corrupt size doesn't exhaust the memory
+  auto num_pages = readValue<std::uint32_t>(is);
+  if (num_pages > bytesLeft(is) / sizeof(std::uint32_t)) {
+    throw std::runtime_error("Truncated tape data.");
+  }
+  table->pages.resize(num_pages);
+
+  if (table->pages.empty() || table->offset < 0 ||
+      static_cast<size_t>(table->offset) > table->pages.size()) {
+    throw std::runtime_error("Invalid page table on tape data.");
+  }
+
+  // The written cells are on the pages of the table (The head can be out of them)
+  const std::int64_t first_cell = -std::int64_t(table->offset) * Tape::page_cells;
+  const std::int64_t end_cell =
+      std::int64_t(table->pages.size() - table->offset) * Tape::page_cells;
+
+  if (tape.empty()) {
+    if (tape.first_written_ != std::numeric_limits<int>::max() ||
+        tape.last_written_ != std::numeric_limits<int>::min()) {
+      throw std::runtime_error("Invalid written range on tape data.");
+    }
+  } else if (tape.first_written_ < first_cell || tape.last_written_ >= end_cell) {
+    throw std::runtime_error("Invalid written range on tape data.");
+  }
+
+  for (auto& page : table->pages) {
+    auto ref = readValue<std::uint32_t>(is);
+    if (ref == 0) {
+      continue;
+    }
+
+    if (ref - 1 == pages_.size()) {
+      auto new_page = RefPtr<Tape::Page>::make();
+      is.read(reinterpret_cast<char*>(new_page->data()), sizeof(Tape::Page));
+      if (!is) {
+        throw std::runtime_error("Truncated tape data.");
+      }
+
+      for (SymbolId id : *new_page) {
+        if (id >= alphabet_->numIds()) {
+          throw std::runtime_error("Invalid symbol on tape data.");
+        }
+      }
+
+      pages_.push_back(std::move(new_page));
+    } else if (ref - 1 > pages_.size()) {
+      throw std::runtime_error("Invalid page on tape data.");
+    }
+
+    page = pages_[ref - 1];
+  }
+
+  tape.table_ = std::move(table);
+  tape.loadPage();
+
+  return tape;
+}
+
+/*!
+ *  Return the number of different pages written or read.
+ */
+size_t TapeStore::numPages() const {
+  return std::max(page_ids_.size(), pages_.size());
+}
+
+}  // namespace turing
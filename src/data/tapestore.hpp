@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include "data/tape.hpp"
+
+namespace turing {
+
+class TapeStore {
+public:
+  TapeStore() = default;
+  explicit TapeStore(const Alphabet& alphabet);
+
+  TapeStore(const TapeStore&) = delete;
+  TapeStore& operator=(const TapeStore&) = delete;
+
+  void write(std::ostream& os, const Tape& tape);
+  Tape read(std::istream& is);
+
+  size_t numPages() const;
+
+private:
+  // Alphabet of the tapes read
+  const Alphabet* alphabet_{nullptr};
+
+  // Pages already stored, numbered in the order they were written/read
+  std::unordered_map<const Tape::Page*, std::uint32_t> page_ids_;
+  std::vector<RefPtr<Tape::Page>> pages_;
+};
+
+}  // namespace turing
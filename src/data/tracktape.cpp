@@ -0,0 +1,283 @@
+#include "tracktape.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace turing {
+
+/*!
+ *  \class TrackTape
+ *  \brief Tape of several tracks that share a single head.
+ *
+ *  Multi-track machines move all their heads together, so their tapes are stored as a
+ *  single tape whose cells are tuples of symbols, one for each track. The cells of
+ *  each track are contiguous (Struct of arrays), and the tuple of each cell is also
+ *  numbered as a packed key:
+ *      key = (symbol_0 * S + symbol_1) * S + ...
+ *  with S the number of symbols, so the symbols under the head are read with a single
+ *  load, in the same order as CompiledMachine numbers the configurations.
+ *
+ *  The cells grow on demand, doubling at the side the head leaves. A tape of a single
+ *  track is a contiguous copy of a Tape: its cells can also be crossed at once (See
+ *  "span" and "cross").
+ */
+
+namespace {
+
+// Minimum number of cells stored
+constexpr size_t min_capacity = 64;
+
+}  // namespace
+
+/*!
+ *  Copy the tapes, one for each track. Their heads must be on the same position.
+ *
+ *  !WARNING: Throw if the heads are on different positions.
+ */
+TrackTape::TrackTape(const std::vector<Tape>& tapes, size_t num_symbols)
+    : num_tracks_(tapes.size()), num_symbols_(num_symbols) {
+  if (tapes.empty()) {
+    throw std::runtime_error("A track tape needs at least one track.");
+  }
+
+  std::int64_t head = tapes[0].head();
+  std::int64_t first = head;
+  std::int64_t last = head;
+
+  for (const auto& tape : tapes) {
+    if (tape.head() != head) {
+      throw std::runtime_error("The heads of the tracks must be on the same cell.");
+    }
+
+    if (!tape.empty()) {
+      first = std::min<std::int64_t>(first, tape.firstWritten());
+      last = std::max<std::int64_t>(last, tape.lastWritten());
+    }
+  }
+
+  capacity_ = std::max<size_t>(min_capacity, 2 * (last - first + 1));
+  cells_.assign(capacity_ * num_tracks_, 0);
+  keys_.assign(capacity_, 0);
+
+  origin_ = first;
+  head_ = head - first;
+
+  // Read each tape sequentially from a copy, so the cells are read from the page
+  // under the head (Copies are cheap, see Tape)
+  for (int i = 0; i < num_tracks_; ++i) {
+    SymbolId* track = &cells_[i * capacity_];
+
+    Tape tape(tapes[i]);
+    while (tape.head() > first) {
+      tape.move(Move::Left);
+    }
+
+    for (std::int64_t pos = first; pos <= last; ++pos) {
+      track[pos - first] = tape.peekId();
+      tape.move(Move::Right);
+    }
+  }
+
+  for (size_t idx = 0; idx < capacity_; ++idx) {
+    std::uint64_t k = 0;
+    for (int i = 0; i < num_tracks_; ++i) {
+      k = k * num_symbols_ + cells_[i * capacity_ + idx];
+    }
+    keys_[idx] = k;
+  }
+}
+
+/*!
+ *  Return the number of tracks.
+ */
+int TrackTape::numTracks() const {
+  return num_tracks_;
+}
+
+/*!
+ *  Return the position of the head. The input string starts at position 0.
+ */
+std::int64_t TrackTape::head() const {
+  return origin_ + static_cast<std::int64_t>(head_);
+}
+
+/*!
+ *  Return the key of the symbols under the head.
+ */
+std::uint64_t TrackTape::peekKey() const {
+  return keys_[head_];
+}
+
+/*!
+ *  Return the symbol id of a track under the head.
+ */
+SymbolId TrackTape::peekId(int track) const {
+  return cells_[track * capacity_ + head_];
+}
+
+/*!
+ *  Number the tuple of symbols ids (One for each track).
+ */
+std::uint64_t TrackTape::key(const SymbolId* ids) const {
+  std::uint64_t k = 0;
+  for (int i = 0; i < num_tracks_; ++i) {
+    k = k * num_symbols_ + ids[i];
+  }
+
+  return k;
+}
+
+/*!
+ *  Write a symbol id on each track under the head. "key" must be the key of the ids
+ *  (See "key"), so it isn't computed on each write.
+ */
+void TrackTape::write(std::uint64_t key, const SymbolId* ids) {
+  markWritten(head_, head_);
+
+  // The tracks don't change if the tuple is the same
+  if (keys_[head_] == key) {
+    return;
+  }
+
+  keys_[head_] = key;
+  for (int i = 0; i < num_tracks_; ++i) {
+    cells_[i * capacity_ + head_] = ids[i];
+  }
+}
+
+/*!
+ *  Move the head in the given direction.
+ */
+void TrackTape::move(Move dir) {
+  if (dir == Move::Right) {
+    if (head_ + 1 == capacity_) {
+      grow(dir);
+    }
+    ++head_;
+  } else if (dir == Move::Left) {
+    if (head_ == 0) {
+      grow(dir);
+    }
+    --head_;
+  }
+}
+
+/*!
+ *  Return the number of cells stored from the head (included) to the end of the cells
+ *  in the given direction.
+ */
+size_t TrackTape::available(Move dir) const {
+  return (dir == Move::Right) ? capacity_ - head_ : head_ + 1;
+}
+
+/*!
+ *  Return the number of cells with a symbol of the set, from the head (included) in
+ *  the given direction. Only the cells stored are counted (See "available").
+ *  Only for tapes of a single track.
+ */
+size_t TrackTape::span(Move dir, const SymbolScanner& symbols) const {
+  if (dir == Move::Right) {
+    return symbols.spanRight(&cells_[head_], capacity_ - head_);
+  }
+
+  return symbols.spanLeft(cells_.data(), head_ + 1);
+}
+
+/*!
+ *  Cross "cells" cells from the head in the given direction, without changing them
+ *  (As the transitions of a scan loop, which write the symbol read). The cells must
+ *  be stored (See "available").
+ */
+void TrackTape::cross(Move dir, size_t cells) {
+  if (dir == Move::Right) {
+    markWritten(head_, head_ + cells - 1);
+    head_ += cells - 1;
+  } else {
+    markWritten(head_ - (cells - 1), head_);
+    head_ -= cells - 1;
+  }
+
+  move(dir);
+}
+
+/*!
+ *  Copy the written cells and the head position to the tapes (One for each track).
+ *
+ *  !WARNING: Throw if the positions don't fit on a Tape.
+ */
+void TrackTape::writeTo(std::vector<Tape>& tapes) const {
+  std::int64_t head_position = head();
+  if (std::min(first_written_, head_position) < std::numeric_limits<int>::min() ||
+      std::max(last_written_, head_position) > std::numeric_limits<int>::max()) {
+    throw std::runtime_error("Tape too long to be stored cell by cell.");
+  }
+
+  for (int i = 0; i < num_tracks_; ++i) {
+    Tape& tape = tapes[i];
+    const SymbolId* track = &cells_[i * capacity_];
+
+    auto move_to = [&tape](std::int64_t position) {
+      while (tape.head() > position) {
+        tape.move(Move::Left);
+      }
+      while (tape.head() < position) {
+        tape.move(Move::Right);
+      }
+    };
+
+    // Only the cells that changed are written, besides the ends of the range
+    if (first_written_ <= last_written_) {
+      move_to(first_written_);
+      for (std::int64_t pos = first_written_; pos <= last_written_; ++pos) {
+        SymbolId id = track[pos - origin_];
+        if (pos == first_written_ || pos == last_written_ || tape.peekId() != id) {
+          tape.writeId(id);
+        }
+
+        if (pos < last_written_) {
+          tape.move(Move::Right);
+        }
+      }
+    }
+
+    move_to(head_position);
+  }
+}
+
+/*!
+ *  Extend the range of written cells to the stored cells [first, last].
+ */
+void TrackTape::markWritten(size_t first, size_t last) {
+  first_written_ = std::min(first_written_, origin_ + std::int64_t(first));
+  last_written_ = std::max(last_written_, origin_ + std::int64_t(last));
+}
+
+/*!
+ *  Double the cells at the side the head is moving to.
+ */
+void TrackTape::grow(Move dir) {
+  size_t new_capacity = 2 * capacity_;
+
+  // Cells added at the left of the current ones
+  size_t shift = (dir == Move::Left) ? capacity_ : 0;
+
+  std::vector<SymbolId> cells(new_capacity * num_tracks_, 0);
+  for (int i = 0; i < num_tracks_; ++i) {
+    std::copy(cells_.begin() + i * capacity_,
+              cells_.begin() + (i + 1) * capacity_,
+              cells.begin() + i * new_capacity + shift);
+  }
+
+  // Blank cells have the key 0 (All their symbols are the blank id, 0)
+  std::vector<std::uint64_t> keys(new_capacity, 0);
+  std::copy(keys_.begin(), keys_.end(), keys.begin() + shift);
+
+  cells_ = std::move(cells);
+  keys_ = std::move(keys);
+  capacity_ = new_capacity;
+
+  head_ += shift;
+  origin_ -= static_cast<std::int64_t>(shift);
+}
+
+}  // namespace turing
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "data/symbolscanner.hpp"
+#include "data/tape.hpp"
+#include "utils/utils.hpp"
+
+namespace turing {
+
+class TrackTape {
+public:
+  TrackTape(const std::vector<Tape>& tapes, size_t num_symbols);
+
+  int numTracks() const;
+  std::int64_t head() const;
+
+  std::uint64_t peekKey() const;
+  SymbolId peekId(int track) const;
+
+  std::uint64_t key(const SymbolId* ids) const;
+  void write(std::uint64_t key, const SymbolId* ids);
+
+  void move(Move dir);
+
+  size_t available(Move dir) const;
+  size_t span(Move dir, const SymbolScanner& symbols) const;
+  void cross(Move dir, size_t cells);
+
+  void writeTo(std::vector<Tape>& tapes) const;
+
+private:
+  void markWritten(size_t first, size_t last);
+  void grow(Move dir);
+
+private:
+  int num_tracks_;
+  size_t num_symbols_;
+
+  // Cell "idx" of the track "i" is cells_[i * capacity_ + idx]. Its tuple of symbols
+  // is numbered on keys_[idx].
+  std::vector<SymbolId> cells_;
+  std::vector<std::uint64_t> keys_;
+  size_t capacity_{0};
+
+  // Index of the head on the cells, and position of the first cell
+  size_t head_{0};
+  std::int64_t origin_{0};
+
+  // Range of written cells
+  std::int64_t first_written_{std::numeric_limits<std::int64_t>::max()};
+  std::int64_t last_written_{std::numeric_limits<std::int64_t>::min()};
+};
+
+}  // namespace turing
@@ -1,9 +1,23 @@
 #include <boost/program_options.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <deque>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <sstream>
+#include <utility>
 
+#include "core/checkpoint.hpp"
+#include "core/codegenerator.hpp"
+#include "core/machineimage.hpp"
+#include "core/resultcache.hpp"
+#include "core/trace.hpp"
 #include "core/turing.hpp"
 #include "core/turingbuilder.hpp"
+#include "data/inputfile.hpp"
+#include "utils/threadpool.hpp"
 #include "utils/utils.hpp"
 
 namespace po = boost::program_options;
@@ -12,12 +26,67 @@ struct Options {
   bool debug_mode{false};
   std::string turing_file{""};
   std::string input{""};
+  bool map_input{false};
+  bool check_input{false};
+
+  turing::Limits limits;
+  std::string search_mode{"dfs"};
+  size_t search_threads{0};
+  int block_size{0};
+  bool run_length_tape{false};
+  bool detect_loops{false};
+
+  size_t jobs{1};
+
+  std::string profile_file{""};
+
+  bool cache{false};
+  std::string cache_file{""};
+
+  std::string trace_file{""};
+
+  std::string checkpoint_file{""};
+  std::uint64_t checkpoint_interval{60};
+  bool resume{false};
 };
 
-void runTuringMachine(turing::Turing& machine, const std::string& input);
+void runInputFile(const turing::Turing& machine,
+                  std::ifstream& input_file,
+                  size_t jobs,
+                  turing::Profile* profile);
+void runTuringMachine(const turing::Turing& machine,
+                      const std::string& input,
+                      std::ostream& out,
+                      std::ostream& err,
+                      turing::Profile* profile);
+void runMappedInput(const turing::Turing& machine,
+                    const std::string& file_path,
+                    bool check_input,
+                    turing::Profile* profile);
+void writeResult(const turing::RunResult& result,
+                 std::ostream& out,
+                 std::ostream& err,
+                 turing::Profile* profile);
+void writeProfile(const turing::Turing& machine,
+                  const turing::Profile& profile,
+                  const std::string& file_path);
+void stopIfInterrupted(const turing::Turing& machine);
+void interruptRun(int signal);
+int compileMachine(int argc, char* argv[]);
+int generateMachine(int argc, char* argv[]);
 bool parseArguments(int argc, char* argv[], Options& options);
 
 int main(int argc, char* argv[]) {
+  // "turing compile MACHINE IMAGE" writes the machine image instead of running it
+  if (argc > 1 && std::string(argv[1]) == "compile") {
+    return compileMachine(argc, argv);
+  }
+
+  // "turing generate MACHINE SOURCE" translates the machine to C++
+  if (argc > 1 && std::string(argv[1]) == "generate") {
+    return generateMachine(argc, argv);
+  }
+
   // Command line arguments
   Options options;
 
@@ -26,10 +95,56 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  // Buffer the output. Results are flushed when the buffer is full or at exit.
+  std::ios::sync_with_stdio(false);
+
   try {
     // Instantiate Turing Machine from file
     turing::Turing machine = turing::TuringBuilder::fromFile(options.turing_file);
     machine.toggleDebugMode(options.debug_mode);
+    machine.setLimits(options.limits);
+    machine.setSearchMode(turing::to_SearchMode(options.search_mode));
+    if (options.search_threads) {
+      machine.setSearchThreads(options.search_threads);
+    }
+    machine.setBlockSize(options.block_size);
+    machine.toggleRunLengthTape(options.run_length_tape);
+    machine.toggleLoopDetection(options.detect_loops);
+    machine.toggleProfiling(!options.profile_file.empty());
+
+    // Results of previous runs
+    std::shared_ptr<turing::ResultCache> cache;
+    if (options.cache || !options.cache_file.empty()) {
+      cache = std::make_shared<turing::ResultCache>();
+      if (!options.cache_file.empty()) {
+        cache->load(options.cache_file);
+      }
+      machine.setResultCache(cache);
+    }
+
+    if (!options.trace_file.empty()) {
+      machine.setTrace(std::make_shared<turing::TraceWriter>(options.trace_file,
+                                                             *machine.compiled()));
+    }
+
+    // Snapshots of the runs. Interrupted runs save one before exiting.
+    if (!options.checkpoint_file.empty()) {
+      auto checkpoint = std::make_shared<turing::Checkpoint>(
+          options.checkpoint_file, std::chrono::seconds(options.checkpoint_interval));
+      if (options.resume) {
+        checkpoint->load(*machine.compiled());
+      }
+      machine.setCheckpoint(checkpoint);
+
+      // Runs that aren't saved are stopped by the signals as usual
+      if (machine.checkpointed() && !options.map_input) {
+        std::signal(SIGINT, interruptRun);
+        std::signal(SIGTERM, interruptRun);
+      }
+    }
+
+    // Counters of all the runs
+    turing::Profile profile(*machine.compiled());
 
     if (machine.debugMode()) {
       std::cout << machine << std::endl << "-----------------" << std::endl;
@@ -37,18 +152,25 @@ int main(int argc, char* argv[]) {
 
     // Try to open the input as a file. If fails, execute is as an input sequence.
     std::ifstream input_file(options.input);
-    if (input_file.is_open()) {
-
-      // Run the automata for each line.
-      std::string line = turing::Utils::nextLine(input_file);
+    if (options.map_input) {
+      runMappedInput(machine, options.input, options.check_input, &profile);
 
-      while (!line.empty()) {
-        runTuringMachine(machine, line);
-        line = turing::Utils::nextLine(input_file);
-      }
+    } else if (input_file.is_open()) {
+      // The trace can't be interleaved, so debug mode always runs on a single thread
+      // (Checkpoints follow a single run too)
+      bool traced = machine.debugMode() || machine.trace() || machine.checkpoint();
+      runInputFile(machine, input_file, (traced) ? 1 : options.jobs, &profile);
 
     } else {  // Run the input as a string if couldn't be opened as a file
-      runTuringMachine(machine, options.input);
+      runTuringMachine(machine, options.input, std::cout, std::cerr, &profile);
+    }
+
+    if (machine.profiling()) {
+      writeProfile(machine, profile, options.profile_file);
+    }
+
+    if (cache && !options.cache_file.empty()) {
+      cache->save(options.cache_file);
     }
 
   } catch (const std::exception& e) {
@@ -59,22 +181,320 @@ int main(int argc, char* argv[]) {
   return 0;
 }
 
-void runTuringMachine(turing::Turing& machine, const std::string& input) {
-  std::cout << "Input: " << input << std::endl;
-  bool recognized = machine.run(input);
-  std::cout << "Recognized: " << std::boolalpha << recognized << std::endl << std::endl;
-  std::cout << machine.tapes() << std::endl;
+/*!
+ *  Run the machine for each line of the input file.
+ *
+ *  With more than one job, the lines are run concurrently on a pool of threads that
+ *  share the machine. The output of each line is formatted by its thread, and written
+ *  in the same order as the input.
+ *
+ *  If the process is interrupted (See interruptRun), the next lines aren't run.
+ */
+void runInputFile(const turing::Turing& machine,
+                  std::ifstream& input_file,
+                  size_t jobs,
+                  turing::Profile* profile) {
+  std::string line = turing::Utils::nextLine(input_file);
+
+  if (jobs <= 1) {
+    while (!line.empty() && !turing::Checkpoint::interrupted()) {
+      runTuringMachine(machine, line, std::cout, std::cerr, profile);
+      line = turing::Utils::nextLine(input_file);
+    }
+
+    stopIfInterrupted(machine);
+    return;
+  }
+
+  struct Report {
+    std::string output;
+    std::string warnings;
+    turing::Profile profile;
+  };
+
+  // Print the oldest line. Rethrows if its run failed.
+  std::deque<std::future<Report>> pending;
+  auto write_oldest = [&pending, profile] {
+    Report report = pending.front().get();
+    pending.pop_front();
+
+    std::cerr << report.warnings;
+    std::cout << report.output;
+    profile->merge(report.profile);
+  };
+
+  turing::ThreadPool pool(jobs);
+
+  // Bound the lines in flight, so the whole file isn't kept in memory
+  const size_t max_pending = jobs * 16;
+
+  while (!line.empty() && !turing::Checkpoint::interrupted()) {
+    pending.push_back(pool.submit([&machine, line] {
+      std::ostringstream out;
+      std::ostringstream err;
+      turing::Profile profile;
+      runTuringMachine(machine, line, out, err, &profile);
+
+      return Report{out.str(), err.str(), std::move(profile)};
+    }));
+
+    if (pending.size() >= max_pending) {
+      write_oldest();
+    }
+
+    line = turing::Utils::nextLine(input_file);
+  }
+
+  while (!pending.empty()) {
+    write_oldest();
+  }
+
+  stopIfInterrupted(machine);
+}
+
+/*!
+ *  Run the machine for the input, writing the result on "out" and the warnings on
+ *  "err". The counters of the run are added to "profile" if the machine is profiled.
+ */
+void runTuringMachine(const turing::Turing& machine,
+                      const std::string& input,
+                      std::ostream& out,
+                      std::ostream& err,
+                      turing::Profile* profile) {
+  out << "Input: " << input << "\n";
+  turing::RunResult result = machine.simulate(input);
+
+  writeResult(result, out, err, profile);
+  out << result.tapes << "\n";
+}
+
+/*!
+ *  Run the machine for the whole contents of the file, mapped on memory instead of
+ *  read (See turing::InputFile). The tapes aren't printed, as they can be huge. With
+ *  "check_input", the whole file is checked before the run.
+ */
+void runMappedInput(const turing::Turing& machine,
+                    const std::string& file_path,
+                    bool check_input,
+                    turing::Profile* profile) {
+  auto input_file = std::make_shared<const turing::InputFile>(file_path);
+
+  std::cout << "Input: " << file_path << " (" << input_file->size()
+            << " characters)\n";
+  turing::RunResult result = machine.simulate(input_file, check_input);
+
+  writeResult(result, std::cout, std::cerr, profile);
+}
+
+/*!
+ *  Write the verdict of the run on "out" and its warnings on "err". The counters of
+ *  the run are added to "profile" if the machine is profiled.
+ */
+void writeResult(const turing::RunResult& result,
+                 std::ostream& out,
+                 std::ostream& err,
+                 turing::Profile* profile) {
+  err << result.diagnostics;
+
+  if (result.profile) {
+    profile->merge(*result.profile);
+  }
+
+  out << "Recognized: ";
+  if (result.verdict == turing::Verdict::Undecided) {
+    out << "undecided (budget exhausted)";
+  } else if (result.cycle) {
+    out << "false (loops forever: cycle of " << result.cycle->length
+        << " steps from step " << result.cycle->start << ")";
+  } else {
+    out << std::boolalpha << result.accepted();
+  }
+  out << "\n\n";
+}
+
+/*!
+ *  Stop between two runs if the process was interrupted. The runs that were already
+ *  saved stay on the checkpoint.
+ *
+ *  !WARNING: Throw if the process was interrupted.
+ */
+void stopIfInterrupted(const turing::Turing& machine) {
+  if (machine.checkpoint()) {
+    machine.checkpoint()->stopIfInterrupted();
+  }
+}
+
+/*!
+ *  Stop the checkpointed run, saving its snapshot. A second signal ends the process.
+ */
+void interruptRun(int signal) {
+  turing::Checkpoint::interrupt();
+  std::signal(signal, SIG_DFL);
+}
+
+/*!
+ *  Write the profile to the file. As CSV if the file ends with ".csv", as JSON
+ *  otherwise.
+ */
+void writeProfile(const turing::Turing& machine,
+                  const turing::Profile& profile,
+                  const std::string& file_path) {
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Can't write profile file: " + file_path);
+  }
+
+  const std::string csv_extension = ".csv";
+  bool csv = file_path.size() >= csv_extension.size() &&
+             file_path.compare(file_path.size() - csv_extension.size(),
+                               csv_extension.size(),
+                               csv_extension) == 0;
+
+  if (csv) {
+    profile.writeCsv(file, *machine.compiled());
+  } else {
+    profile.writeJson(file, *machine.compiled());
+  }
+}
+
+/*!
+ *  Compile a machine definition to a binary image, which is loaded faster. The image
+ *  can be used instead of the definition on "--FILE".
+ */
+int compileMachine(int argc, char* argv[]) {
+  if (argc != 4) {
+    std::cerr << "Usage: " << argv[0] << " compile MACHINE_FILE IMAGE_FILE"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    turing::Turing machine = turing::TuringBuilder::fromFile(argv[2]);
+    turing::MachineImage::write(machine, argv[3]);
+
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+/*!
+ *  Translate a deterministic machine to a C++ source file, to be compiled to a native
+ *  executable or library (See CodeGenerator).
+ */
+int generateMachine(int argc, char* argv[]) {
+  if (argc != 4) {
+    std::cerr << "Usage: " << argv[0] << " generate MACHINE_FILE SOURCE_FILE"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    turing::Turing machine = turing::TuringBuilder::fromFile(argv[2]);
+    turing::CodeGenerator(machine).write(argv[3]);
+
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
 }
 
 bool parseArguments(int argc, char* argv[], Options& options) {
+  std::uint64_t max_time_ms{0};
+
   po::options_description desc("Options");
   desc.add_options()("help,h", "Show help menu")(
       "FILE",
       po::value<std::string>(&options.turing_file)->required(),
-      "Turing machine definition")(
+      "Turing machine definition, or image written by \"turing compile\"")(
 
       "debug,D", po::bool_switch(&options.debug_mode), "Show a trace of the execution")(
 
+      "max-steps",
+      po::value<std::uint64_t>(&options.limits.max_steps),
+      "Maximum number of steps before giving up (0 = unlimited)")(
+
+      "max-depth",
+      po::value<std::uint64_t>(&options.limits.max_depth),
+      "Maximum length of a computation path (0 = unlimited)")(
+
+      "timeout",
+      po::value<std::uint64_t>(&max_time_ms),
+      "Maximum time in milliseconds for each input (0 = unlimited)")(
+
+      "search",
+      po::value<std::string>(&options.search_mode),
+      "Search strategy for Non-Deterministic machines: dfs (default), bfs or parallel")(
+
+      "search-threads",
+      po::value<size_t>(&options.search_threads),
+      "Number of threads used by the parallel search (Default: all cores)")(
+
+      "macro",
+      po::value<int>(&options.block_size),
+      "Run deterministic single-tape machines on blocks of N cells, caching the result "
+      "of each block (0 = off)")(
+
+      "rle",
+      po::bool_switch(&options.run_length_tape),
+      "Run deterministic single-tape machines on a run-length encoded tape, crossing "
+      "runs of symbols in a single step")(
+
+      "detect-loops",
+      po::bool_switch(&options.detect_loops),
+      "Reject the inputs of deterministic machines as soon as they repeat a "
+      "configuration, as they would loop forever")(
+
+      "jobs,j",
+      po::value<size_t>(&options.jobs),
+      "Number of input lines run concurrently (For input files)")(
+
+      "profile",
+      po::value<std::string>(&options.profile_file),
+      "Count the visits to each state and transition, and write them to a file (JSON, "
+      "or CSV if the file ends with .csv)")(
+
+      "cache",
+      po::bool_switch(&options.cache),
+      "Reuse the result of inputs that were already run (Ignored in debug mode)")(
+
+      "cache-file",
+      po::value<std::string>(&options.cache_file),
+      "Load the cached results from a file, and save them back at exit (Implies "
+      "--cache)")(
+
+      "trace",
+      po::value<std::string>(&options.trace_file),
+      "Write the steps of the runs to a compact binary trace (See turing-replay)")(
+
+      "mmap",
+      po::bool_switch(&options.map_input),
+      "Map the INPUT file on memory and run its whole contents as a single input, "
+      "without copying it (For huge inputs with single-character symbols). The tapes "
+      "aren't printed")(
+
+      "check-input",
+      po::bool_switch(&options.check_input),
+      "Check every character of the mapped INPUT file before the run, instead of the "
+      "ones the run reads (With --mmap)")(
+
+      "checkpoint",
+      po::value<std::string>(&options.checkpoint_file),
+      "Save a snapshot of the running input to a file from time to time, and when "
+      "interrupted (Removed when the run ends)")(
+
+      "checkpoint-interval",
+      po::value<std::uint64_t>(&options.checkpoint_interval),
+      "Seconds between snapshots (Default: 60)")(
+
+      "resume",
+      po::bool_switch(&options.resume),
+      "Continue the run saved on the checkpoint file instead of starting it again")(
+
       "INPUT",
       po::value<std::string>(&options.input)->required(),
       "Input string or file to be recognized by the automata.");
@@ -88,11 +508,39 @@ bool parseArguments(int argc, char* argv[], Options& options) {
                    "Non-Deterministic,Multitape,Multitrack Turing Machines"
                 << std::endl;
       std::cout << desc << std::endl;
+      std::cout << "Compile a machine to a binary image:\n  " << argv[0]
+                << " compile MACHINE_FILE IMAGE_FILE" << std::endl;
+      std::cout << "Translate a deterministic machine to C++:\n  " << argv[0]
+                << " generate MACHINE_FILE SOURCE_FILE" << std::endl;
       return false;
     }
 
     po::notify(vm);
 
+    options.limits.max_time = std::chrono::milliseconds(max_time_ms);
+
+    if (options.resume && options.checkpoint_file.empty()) {
+      throw po::error("--resume needs a --checkpoint file");
+    }
+
+    // Traced runs follow a single computation path at a time (See Turing::setTrace)
+    if (!options.trace_file.empty()) {
+      turing::SearchMode mode;
+      try {
+        mode = turing::to_SearchMode(options.search_mode);
+      } catch (const std::runtime_error& e) {
+        throw po::error(e.what());
+      }
+
+      if (mode != turing::SearchMode::DepthFirst) {
+        throw po::error("--trace only supports the depth-first search (--search dfs)");
+      }
+
+      if (!options.checkpoint_file.empty()) {
+        throw po::error("--trace can't be used with --checkpoint");
+      }
+    }
+
   } catch (const po::error& e) {
     std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
     std::cerr << desc << std::endl;
@@ -1,30 +1,15 @@
 #include "state.hpp"
 
-#include <iostream>
-
 namespace turing {
 
 /*!
  *  \class State
  *  \brief Class representing a State with transitions.
+ *
+ *  States are stored by the machine, which gives them an id and a name (See
+ *  Turing::stateId). The transitions refer to the next state by its id.
  */
 
-/*!
- *  Construct a new state object. MUST have a name.
- */
-State::State(const std::string &name) : name_(name) {
-  if (name_.empty()) {
-    throw std::runtime_error("Can't create a state with empty name!");
-  }
-}
-
-/*!
- *  Return the State name.
- */
-std::string State::name() const {
-  return name_;
-}
-
 /*!
  *  Return if the state is final.
  */
@@ -40,12 +25,23 @@ void State::setFinal(bool f) {
 }
 
 /*!
- *  Return all the transitions associated to these input.
+ *  Return all the transitions associated to these input symbol ids.
  *  If there aren't any transitions for the symbols, return an empty set.
  */
-std::unordered_set<Transition> &State::transitions(
-    const std::vector<Symbol> &input_symbols) {
-  return transitions_[input_symbols];
+const std::unordered_set<Transition> &State::transitions(
+    const std::vector<SymbolId> &input_symbols) const {
+  static const std::unordered_set<Transition> no_transitions;
+
+  auto it = transitions_.find(input_symbols);
+  return (it != transitions_.end()) ? it->second : no_transitions;
+}
+
+/*!
+ *  Return all the transitions of the state, grouped by their input symbol ids.
+ */
+const std::map<std::vector<SymbolId>, std::unordered_set<Transition>>
+    &State::transitions() const {
+  return transitions_;
 }
 
 /*!
@@ -57,18 +53,4 @@ void State::addTransition(const Transition &transition) {
   transitions_[transition.inputSymbols()].insert(transition);
 }
 
-/*!
- *  Print the State name and its transitions.
- */
-std::ostream &operator<<(std::ostream &os, const State &state) {
-  for (const auto &t_pair : state.transitions_) {
-    os << state.name() << ": [ ";
-    for (const auto &t : t_pair.second) {
-      os << t << ", ";
-    }
-    os << "\b\b ]" << std::endl;
-  }
-  return os;
-}
-
 }  // namespace turing
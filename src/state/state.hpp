@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <map>
 #include <string>
 #include <unordered_set>
@@ -11,23 +12,23 @@ namespace turing {
 
 class State {
 public:
-  explicit State(const std::string &name);
-
-  std::string name() const;
+  // Id of a missing state
+  static constexpr StateId no_state = std::numeric_limits<StateId>::max();
 
   bool isFinal() const;
   void setFinal(bool f);
 
-  std::unordered_set<Transition> &transitions(const std::vector<Symbol> &input_symbols);
-  void addTransition(const Transition &transition);
+  const std::unordered_set<Transition> &transitions(
+      const std::vector<SymbolId> &input_symbols) const;
+  const std::map<std::vector<SymbolId>, std::unordered_set<Transition>> &transitions()
+      const;
 
-  friend std::ostream &operator<<(std::ostream &os, const State &state);
+  void addTransition(const Transition &transition);
 
 private:
-  const std::string name_;
   bool final_{false};
 
-  std::map<std::vector<Symbol>, std::unordered_set<Transition>> transitions_;
+  std::map<std::vector<SymbolId>, std::unordered_set<Transition>> transitions_;
 };
 
 }  // namespace turing
@@ -9,70 +9,112 @@ namespace turing {
  *  \brief Represents a transition to a new state.
  *
  *  Transition objects are inmutable.
+ *  Symbols are stored as the ids given by the Tape alphabet, and the next state as its
+ *  id on the machine (See Turing::stateId).
  */
 
+namespace {
+
+/*!
+ *  Print the transition, with the given name for the next state.
+ */
+void print(std::ostream& os,
+           const Alphabet* alphabet,
+           const std::vector<SymbolId>& input_symbols,
+           const std::string& next_state_name,
+           const std::vector<SymbolId>& output_symbols,
+           const std::vector<Move>& moves) {
+  // Translate the ids back to Symbols
+  auto symbols = [alphabet](const std::vector<SymbolId>& ids) {
+    std::vector<Symbol> result;
+    for (const auto& id : ids) {
+      result.push_back((alphabet) ? alphabet->symbol(id) : std::to_string(id));
+    }
+    return result;
+  };
+
+  os << symbols(input_symbols) << " => { " << next_state_name << ", "
+     << symbols(output_symbols) << ", ";
+
+  for (const auto& mov : moves) {
+    os << "[" << to_string(mov) << "]";
+  }
+
+  os << " }";
+}
+
+}  // namespace
+
 /*!
- *  Construct a new Transition object.
+ *  Construct a new Transition object, translating the symbols to ids of "alphabet".
+ *
+ *  !WARNING: Throw if some symbol isn't on the alphabet.
  */
-Transition::Transition(const std::vector<Symbol>& input_symbols,
-                       State* next_state,
+Transition::Transition(const Alphabet& alphabet,
+                       const std::vector<Symbol>& input_symbols,
+                       StateId next_state,
                        const std::vector<Symbol>& output_symbols,
                        const std::vector<Move>& moves)
 
-    : input_symbols_(input_symbols),
-      next_state_(next_state),
-      output_symbols_(output_symbols),
-      moves_(moves) {}
+    : next_state_(next_state), moves_(moves), alphabet_(&alphabet) {
+  for (const auto& symbol : input_symbols) {
+    input_symbols_.push_back(alphabet.id(symbol));
+  }
+
+  for (const auto& symbol : output_symbols) {
+    output_symbols_.push_back(alphabet.id(symbol));
+  }
+}
 
 /*!
- *  Symbol needed by the Tape(s) for the transition.
+ *  Symbol ids needed by the Tape(s) for the transition.
  */
-std::vector<Symbol> Transition::inputSymbols() const {
+const std::vector<SymbolId>& Transition::inputSymbols() const {
   return input_symbols_;
 }
 
 /*!
- *  Symbols written to the Tape(s) when transitioning.
+ *  Symbol ids written to the Tape(s) when transitioning.
  */
-std::vector<Symbol> Transition::outputSymbols() const {
+const std::vector<SymbolId>& Transition::outputSymbols() const {
   return output_symbols_;
 }
 
 /*!
  *  Movement done by the Tape(s) upon transitioning.
  */
-std::vector<Move> Transition::moves() const {
+const std::vector<Move>& Transition::moves() const {
   return moves_;
 }
 
 /*!
- *  Name of the next state to which transition.
+ *  Id of the next state to which transition, without modifying any Tape.
  */
-std::string Transition::nextStateName() const {
-  return (next_state_) ? next_state_->name() : "";
+StateId Transition::target() const {
+  return next_state_;
 }
 
 /*!
- *  Move to the next state and return it, modifying the Tape(s) on the process.
- *  If the transition couldn't be performed, return null.
+ *  Move to the next state and return its id, modifying the Tape(s) on the process.
+ *  If the transition couldn't be performed, return State::no_state.
  */
-State* Transition::nextState(std::vector<Tape>& tapes) const {
+StateId Transition::nextState(std::vector<Tape>& tapes) const {
   // Must have the same amout of symbols that tapes (To write on each one)
   if (tapes.size() != input_symbols_.size()) {
-    return nullptr;
+    return State::no_state;
   }
 
   // Check that all tapes point to the correct symbol
   for (size_t i = 0; i < tapes.size(); ++i) {
     // Input symbols must be the same
-    if (tapes[i].peek() != input_symbols_[i]) {
-      return nullptr;
+    if (tapes[i].peekId() != input_symbols_[i]) {
+      return State::no_state;
     }
   }
 
   // Write on tapes
   for (size_t i = 0; i < tapes.size(); ++i) {
-    tapes[i].write(output_symbols_[i]);
+    tapes[i].writeId(output_symbols_[i]);
     tapes[i].move((moves_.size() == 1) ? moves_[0] : moves_[i]);
   }
 
@@ -86,12 +128,37 @@ State* Transition::nextState(std::vector<Tape>& tapes) const {
  */
 bool Transition::operator==(const Transition& other) const {
   return input_symbols_ == other.input_symbols_ &&
-         output_symbols_ == other.output_symbols_ &&
-         nextStateName() == other.nextStateName() && moves_ == other.moves_;
+         output_symbols_ == other.output_symbols_ && next_state_ == other.next_state_ &&
+         moves_ == other.moves_;
+}
+
+/*!
+ *  Hash of the transition. Equal transitions have the same hash.
+ */
+size_t Transition::hash() const {
+  size_t seed = std::hash<StateId>()(next_state_);
+
+  auto combine = [&seed](size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  };
+
+  for (const auto& id : input_symbols_) {
+    combine(id);
+  }
+
+  for (const auto& id : output_symbols_) {
+    combine(id);
+  }
+
+  for (const auto& mov : moves_) {
+    combine(static_cast<size_t>(mov));
+  }
+
+  return seed;
 }
 
 /*!
- *  Return the Transition as a string.
+ *  Return the Transition as a string. The next state is printed by its id.
  */
 std::string to_string(const Transition& other) {
   std::stringstream ss;
@@ -100,21 +167,32 @@ std::string to_string(const Transition& other) {
 }
 
 /*!
- *  Print the transition.
+ *  Return the Transition as a string, with the name of the next state.
+ *
+ *  !WARNING: Throw if the next state isn't on "state_names".
  */
-std::ostream& operator<<(std::ostream& os, const Transition& t) {
-  // os << "(" << t.input_symbol_ << ", " << t.stack_symbol_ << ") => {"
-  //    << t.next_state_->name() << ", " << t.new_stack_symbols_ << "}";
-  //
-  os << t.input_symbols_ << " => { " << t.nextStateName() << ", " << t.output_symbols_
-     << ", ";
-
-  for (const auto& mov : t.moves_) {
-    os << "[" << to_string(mov) << "]";
-  }
-
-  os << " }";
+std::string to_string(const Transition& other,
+                      const std::vector<std::string>& state_names) {
+  std::stringstream ss;
+  print(ss,
+        other.alphabet_,
+        other.input_symbols_,
+        state_names.at(other.next_state_),
+        other.output_symbols_,
+        other.moves_);
+  return ss.str();
+}
 
+/*!
+ *  Print the transition. The next state is printed by its id.
+ */
+std::ostream& operator<<(std::ostream& os, const Transition& t) {
+  print(os,
+        t.alphabet_,
+        t.input_symbols_,
+        std::to_string(t.next_state_),
+        t.output_symbols_,
+        t.moves_);
   return os;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -9,36 +10,42 @@
 
 namespace turing {
 
-class State;
-
 class Transition {
 public:
   Transition() = default;
-  Transition(const std::vector<Symbol>& input_symbols,
-             State* next_state,
+  Transition(const Alphabet& alphabet,
+             const std::vector<Symbol>& input_symbols,
+             StateId next_state,
              const std::vector<Symbol>& output_symbols,
              const std::vector<Move>& moves);
 
-  std::vector<Symbol> inputSymbols() const;
-  std::vector<Symbol> outputSymbols() const;
+  const std::vector<SymbolId>& inputSymbols() const;
+  const std::vector<SymbolId>& outputSymbols() const;
 
-  std::vector<Move> moves() const;
+  const std::vector<Move>& moves() const;
 
-  std::string nextStateName() const;
+  StateId target() const;
 
-  State* nextState(std::vector<Tape>& tapes) const;
+  StateId nextState(std::vector<Tape>& tapes) const;
 
   friend std::string to_string(const Transition& other);
+  friend std::string to_string(const Transition& other,
+                               const std::vector<std::string>& state_names);
 
   bool operator==(const Transition& other) const;
 
+  size_t hash() const;
+
   friend std::ostream& operator<<(std::ostream& os, const Transition& t);
 
 private:
-  std::vector<Symbol> input_symbols_{};
-  State* next_state_{nullptr};
-  std::vector<Symbol> output_symbols_{};
+  std::vector<SymbolId> input_symbols_{};
+  StateId next_state_{std::numeric_limits<StateId>::max()};
+  std::vector<SymbolId> output_symbols_{};
   std::vector<Move> moves_{Move::Stop};
+
+  // Used to translate the symbol ids back to strings when printing
+  const Alphabet* alphabet_{nullptr};
 };
 
 }  // namespace turing
@@ -49,9 +56,7 @@ private:
 namespace std {
 template <>
 struct hash<turing::Transition> {
-  size_t operator()(const turing::Transition& obj) const {
-    return hash<std::string>()(to_string(obj));
-  }
+  size_t operator()(const turing::Transition& obj) const { return obj.hash(); }
 };
 
 }  // namespace std
@@ -0,0 +1,126 @@
+#include <boost/program_options.hpp>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+#include "core/trace.hpp"
+
+namespace po = boost::program_options;
+
+struct Options {
+  std::string trace_file{""};
+
+  std::uint64_t run{0};
+  std::uint64_t from{0};
+  std::uint64_t to{std::numeric_limits<std::uint64_t>::max()};
+};
+
+void printConfiguration(const turing::TraceReader& trace);
+bool parseArguments(int argc, char* argv[], Options& options);
+
+/*!
+ *  Replay a binary trace written with "turing --trace", printing the configurations
+ *  of a range of steps.
+ */
+int main(int argc, char* argv[]) {
+  Options options;
+
+  if (!parseArguments(argc, argv, options)) {
+    return 1;
+  }
+
+  std::ios::sync_with_stdio(false);
+
+  try {
+    turing::TraceReader trace(options.trace_file);
+
+    for (std::uint64_t run = 1; trace.nextRun(); ++run) {
+      if (options.run && run != options.run) {
+        continue;
+      }
+
+      std::cout << "Run: " << run << "\n";
+
+      if (options.from == 0) {
+        printConfiguration(trace);
+      }
+
+      // Steps before the range are applied without printing them
+      while (trace.steps() < options.to && trace.nextStep()) {
+        if (trace.steps() >= options.from) {
+          std::cout << "> Transition: " << trace.transitionName(trace.lastTransition())
+                    << "\n";
+          printConfiguration(trace);
+        }
+      }
+
+      // Read until the end of the run to know its verdict
+      while (trace.nextStep()) {
+      }
+
+      std::cout << "Steps: " << trace.steps() << "\n";
+      std::cout << "Verdict: " << trace.verdict() << "\n\n";
+    }
+
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+/*!
+ *  Print the current configuration of the trace, as the debug mode of "turing" does.
+ */
+void printConfiguration(const turing::TraceReader& trace) {
+  std::cout << "---------------------------\n";
+  std::cout << "Step: " << trace.steps() << "\n";
+  std::cout << "Current state: " << trace.stateName(trace.state()) << "\n";
+  std::cout << trace.tapes();
+  std::cout << "---------------------------\n";
+}
+
+bool parseArguments(int argc, char* argv[], Options& options) {
+  po::options_description desc("Options");
+  desc.add_options()("help,h", "Show help menu")(
+      "TRACE",
+      po::value<std::string>(&options.trace_file)->required(),
+      "Trace file written with turing --trace")(
+
+      "run",
+      po::value<std::uint64_t>(&options.run),
+      "Only replay the N-th run of the trace, starting at 1 (0 = all)")(
+
+      "from",
+      po::value<std::uint64_t>(&options.from),
+      "First step printed (0 = initial configuration)")(
+
+      "to", po::value<std::uint64_t>(&options.to), "Last step printed (Default: all)");
+
+  po::positional_options_description positional;
+  positional.add("TRACE", 1);
+
+  try {
+    po::variables_map vm;
+    po::store(
+        po::command_line_parser(argc, argv).options(desc).positional(positional).run(),
+        vm);
+
+    if (vm.count("help")) {
+      std::cout << "Replay of the binary traces of the Turing Machine implementation"
+                << std::endl;
+      std::cout << desc << std::endl;
+      return false;
+    }
+
+    po::notify(vm);
+
+  } catch (const po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+    std::cerr << desc << std::endl;
+    return false;
+  }
+
+  return true;
+}
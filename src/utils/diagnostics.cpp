@@ -0,0 +1,80 @@
+#include "diagnostics.hpp"
+
+namespace turing {
+
+/*!
+ *  \class Diagnostics
+ *  \brief Bounded list of warning messages.
+ *
+ *  Collects the warnings found while processing an input, so the caller decides how
+ *  to report them. Only the first "max_messages" are kept, the rest are just counted.
+ */
+
+/*!
+ *  Create an empty list that keeps up to "max_messages".
+ */
+Diagnostics::Diagnostics(size_t max_messages) : max_messages_(max_messages) {}
+
+/*!
+ *  Check if there aren't any messages.
+ */
+bool Diagnostics::empty() const {
+  return count() == 0;
+}
+
+/*!
+ *  Return the number of messages added (Including the dropped ones).
+ */
+size_t Diagnostics::count() const {
+  return messages_.size() + dropped_;
+}
+
+/*!
+ *  Return the number of messages that weren't kept due to the bound.
+ */
+size_t Diagnostics::dropped() const {
+  return dropped_;
+}
+
+/*!
+ *  Return the messages kept.
+ */
+const std::vector<std::string>& Diagnostics::messages() const {
+  return messages_;
+}
+
+/*!
+ *  Add a new message. If the list is full, the message is only counted.
+ */
+void Diagnostics::add(const std::string& message) {
+  if (messages_.size() < max_messages_) {
+    messages_.push_back(message);
+  } else {
+    ++dropped_;
+  }
+}
+
+/*!
+ *  Remove all the messages.
+ */
+void Diagnostics::clear() {
+  messages_.clear();
+  dropped_ = 0;
+}
+
+/*!
+ *  Print the messages, one by line.
+ */
+std::ostream& operator<<(std::ostream& os, const Diagnostics& diagnostics) {
+  for (const auto& message : diagnostics.messages_) {
+    os << "WARNING! " << message << "\n";
+  }
+
+  if (diagnostics.dropped_) {
+    os << "WARNING! (" << diagnostics.dropped_ << " more warnings)\n";
+  }
+
+  return os;
+}
+
+}  // namespace turing
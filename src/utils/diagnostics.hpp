@@ -0,0 +1,31 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace turing {
+
+class Diagnostics {
+public:
+  explicit Diagnostics(size_t max_messages = 16);
+
+  bool empty() const;
+  size_t count() const;
+  size_t dropped() const;
+
+  const std::vector<std::string>& messages() const;
+
+  void add(const std::string& message);
+  void clear();
+
+  friend std::ostream& operator<<(std::ostream& os, const Diagnostics& diagnostics);
+
+private:
+  size_t max_messages_;
+  size_t dropped_{0};
+
+  std::vector<std::string> messages_;
+};
+
+}  // namespace turing
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace turing {
+
+/*!
+ *  \class RefPtr
+ *  \brief Shared pointer with an explicit atomic count, for copy-on-write data.
+ *
+ *  Works as a std::shared_ptr, but "unique" is reliable when the copies are dropped by
+ *  other threads: the count is decremented with release order and read with acquire
+ *  order, so once a thread sees that it holds the only reference, the reads done by
+ *  the previous owners through their copies happened before its writes. (The
+ *  use_count of std::shared_ptr is a relaxed read, so it can't be used for that.)
+ */
+template <typename T>
+class RefPtr {
+public:
+  RefPtr() = default;
+
+  template <typename... Args>
+  static RefPtr make(Args&&... args) {
+    RefPtr ptr;
+    ptr.node_ = new Node{{1}, T(std::forward<Args>(args)...)};
+    return ptr;
+  }
+
+  RefPtr(const RefPtr& other) : node_(other.node_) {
+    if (node_) {
+      node_->count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  RefPtr(RefPtr&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+
+  RefPtr& operator=(RefPtr other) noexcept {
+    std::swap(node_, other.node_);
+    return *this;
+  }
+
+  ~RefPtr() { reset(); }
+
+  void reset() {
+    if (node_ && node_->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete node_;
+    }
+    node_ = nullptr;
+  }
+
+  // Check if this is the only reference. Only its owner can add new references then.
+  bool unique() const {
+    return node_ && node_->count.load(std::memory_order_acquire) == 1;
+  }
+
+  T* get() const { return (node_) ? &node_->value : nullptr; }
+  T& operator*() const { return node_->value; }
+  T* operator->() const { return &node_->value; }
+  explicit operator bool() const { return node_ != nullptr; }
+
+private:
+  struct Node {
+    std::atomic<std::uint32_t> count;
+    T value;
+  };
+
+  Node* node_{nullptr};
+};
+
+}  // namespace turing
@@ -0,0 +1,67 @@
+#include "threadpool.hpp"
+
+namespace turing {
+
+/*!
+ *  \class ThreadPool
+ *  \brief Fixed set of threads that run the submitted tasks in FIFO order.
+ */
+
+/*!
+ *  Start the worker threads (At least one).
+ */
+ThreadPool::ThreadPool(size_t num_threads) {
+  num_threads = std::max<size_t>(num_threads, 1);
+
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+/*!
+ *  Wait for the queued tasks to finish and stop the worker threads.
+ */
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+
+  condition_.notify_all();
+
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+/*!
+ *  Return the number of worker threads.
+ */
+size_t ThreadPool::size() const {
+  return workers_.size();
+}
+
+/*!
+ *  Worker loop: run tasks until the pool is stopped and there aren't tasks left.
+ */
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+
+      if (tasks_.empty()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+
+    task();
+  }
+}
+
+}  // namespace turing
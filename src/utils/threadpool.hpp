@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace turing {
+
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t num_threads = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t size() const;
+
+  template <typename F>
+  auto submit(F&& task) -> std::future<decltype(task())>;
+
+private:
+  void work();
+
+private:
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::queue<std::function<void()>> tasks_;
+  bool stop_{false};
+};
+
+/*!
+ *  Queue a task to be run by the pool. Return a future with its result (or the
+ *  exception thrown by it).
+ */
+template <typename F>
+auto ThreadPool::submit(F&& task) -> std::future<decltype(task())> {
+  using Result = decltype(task());
+
+  auto packaged =
+      std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+  std::future<Result> future = packaged->get_future();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.emplace([packaged] { (*packaged)(); });
+  }
+
+  condition_.notify_one();
+
+  return future;
+}
+
+}  // namespace turing
@@ -1,7 +1,6 @@
 #include "utils.hpp"
 
 #include <algorithm>
-#include <fstream>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -62,12 +61,11 @@ std::ostream &operator<<(std::ostream &os, const std::vector<Symbol> &symbols) {
     return os;
   }
 
-  os << "[";
-  for (const auto &symbol : symbols) {
-    os << symbol << ", ";
+  os << "[" << symbols.front();
+  for (size_t i = 1; i < symbols.size(); ++i) {
+    os << ", " << symbols[i];
   }
-
-  os << "\b\b]";
+  os << "]";
 
   return os;
 }
@@ -128,11 +126,11 @@ std::string &Utils::rtrim(std::string &str) {
 /*!
  *  Read next line until its not empty or is not a comment.
  */
-std::string Utils::nextLine(std::ifstream &file_stream) {
+std::string Utils::nextLine(std::istream &stream) {
   std::string line;
   do {
-    std::getline(file_stream, line);
-  } while (!file_stream.eof() && (line.empty() || Utils::trim(line)[0] == '#'));
+    std::getline(stream, line);
+  } while (!stream.eof() && (line.empty() || Utils::trim(line)[0] == '#'));
 
   return line;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <tuple>
 #include <vector>
@@ -8,8 +9,11 @@ namespace turing {
 
 class Tape;
 using Symbol = std::string;
+using SymbolId = std::uint16_t;
+using StateId = std::uint32_t;
+using TransitionId = std::uint32_t;
 
-enum class Move { Left, Right, Stop };
+enum class Move : std::uint8_t { Left, Right, Stop };
 std::string to_string(const Move& move);
 Move to_Move(std::string move_str);
 
@@ -26,7 +30,7 @@ public:
   static std::string& ltrim(std::string& str);
   static std::string& rtrim(std::string& str);
 
-  static std::string nextLine(std::ifstream& file_stream);
+  static std::string nextLine(std::istream& stream);
 };
 
 }  // namespace turing
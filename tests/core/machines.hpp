@@ -0,0 +1,195 @@
+#pragma once
+
+#include <string>
+
+#include "core/turing.hpp"
+#include "core/turingbuilder.hpp"
+
+// Machines shared by the tests. Each one is built from its text definition (See
+// TuringBuilder::fromString), compiled, and with the debug mode off.
+namespace turing::machines {
+
+inline Turing build(const std::string& definition) {
+  Turing machine = TuringBuilder::fromString(definition);
+  machine.toggleDebugMode(false);
+  return machine;
+}
+
+// Mark the 1s, and accept if the input ends with 1
+inline Turing markOnes() {
+  return build(
+      "1\n"
+      "q0 q1 q2\n"
+      "0 1\n"
+      "0 1 X\n"
+      "q0\n"
+      ".\n"
+      "q2\n"
+      "q0 0 q0 0 R\n"
+      "q0 1 q1 X R\n"
+      "q1 0 q0 0 R\n"
+      "q1 1 q1 X R\n"
+      "q1 . q2 . L\n");
+}
+
+// Mark the 1s, and accept if the input ends with 1. Guess where it ends.
+inline Turing guessLastOne() {
+  return build(
+      "1\n"
+      "q0 q1 q2\n"
+      "0 1\n"
+      "0 1 X\n"
+      "q0\n"
+      ".\n"
+      "q2\n"
+      "q0 0 q0 0 R\n"
+      "q0 1 q1 X R\n"
+      "q0 1 q0 1 R\n"
+      "q1 . q2 . L\n");
+}
+
+// Guess the last 1, marking the cells crossed. Each cell leaves a pending branch.
+inline Turing markToGuessedEnd() {
+  return build(
+      "1\n"
+      "q0 q1 q2\n"
+      "1\n"
+      "1 X\n"
+      "q0\n"
+      ".\n"
+      "q2\n"
+      "q0 1 q0 X R\n"
+      "q0 1 q1 X R\n"
+      "q1 . q2 . L\n");
+}
+
+// Walk over the 1s and accept on the blank. Each 1 can also go to a dead end.
+inline Turing walkOnesWithDeadEnds() {
+  return build(
+      "1\n"
+      "q0 q1 q2\n"
+      "0 1\n"
+      "0 1\n"
+      "q0\n"
+      ".\n"
+      "q1\n"
+      "q0 1 q0 1 R\n"
+      "q0 1 q2 1 R\n"
+      "q0 . q1 . S\n");
+}
+
+// Walk over the 1s, and accept at the end. On a 0, write 1 and bounce forever on the
+// next cell, flipping the cell on the left.
+inline Turing bounceOnZero() {
+  return build(
+      "1\n"
+      "q0 q1 q2 q3\n"
+      "0 1\n"
+      "0 1\n"
+      "q0\n"
+      ".\n"
+      "q3\n"
+      "q0 1 q0 1 R\n"
+      "q0 . q3 . S\n"
+      "q0 0 q1 1 R\n"
+      "q1 0 q2 0 L\n"
+      "q1 1 q2 1 L\n"
+      "q1 . q2 . L\n"
+      "q2 1 q1 0 R\n"
+      "q2 0 q1 1 R\n");
+}
+
+// Flip the bits, and accept if the input ends with 1
+inline Turing flipBits() {
+  return build(
+      "1\n"
+      "q0 q1 q2\n"
+      "0 1\n"
+      "0 1\n"
+      "q0\n"
+      ".\n"
+      "q2\n"
+      "q0 0 q0 1 R\n"
+      "q0 1 q1 0 R\n"
+      "q1 0 q0 1 R\n"
+      "q1 1 q1 0 R\n"
+      "q1 . q2 . L\n");
+}
+
+// Cross the 1s to the right, then go back over them writing Xs and accept
+inline Turing crossAndMark() {
+  return build(
+      "1\n"
+      "q0 q1 q2 q3\n"
+      "1\n"
+      "1 X\n"
+      "q0\n"
+      ".\n"
+      "q3\n"
+      "q0 1 q0 1 R\n"
+      "q0 . q1 . L\n"
+      "q1 1 q1 X L\n"
+      "q1 . q3 . R\n");
+}
+
+// Scan right to the end of the input, mark the last symbol, scan back to the start
+// over the bits, and accept on the "#" before them
+inline Turing markLastAfterHash() {
+  return build(
+      "1\n"
+      "q0 q1 q2 q3\n"
+      "0 1 #\n"
+      "0 1 # X\n"
+      "q0\n"
+      ".\n"
+      "q3\n"
+      "q0 0 q0 0 R\n"
+      "q0 1 q0 1 R\n"
+      "q0 # q0 # R\n"
+      "q0 . q1 . L\n"
+      "q1 0 q2 X L\n"
+      "q1 1 q2 X L\n"
+      "q2 0 q2 0 L\n"
+      "q2 1 q2 1 L\n"
+      "q2 # q3 # S\n");
+}
+
+// Copy the input to the second tape, and go back to its start
+inline Turing copyInput() {
+  return build(
+      "2\n"
+      "q0 q1 q2\n"
+      "0 1\n"
+      "0 1\n"
+      "q0\n"
+      ".\n"
+      "q2\n"
+      "q0 0 . q0 0 0 R\n"
+      "q0 1 . q0 1 1 R\n"
+      "q0 . . q1 . . L\n"
+      "q1 0 0 q1 0 0 L\n"
+      "q1 1 1 q1 1 1 L\n"
+      "q1 . . q2 . . R\n");
+}
+
+// 4-state busy beaver. Halts after 107 steps.
+inline Turing busyBeaver4() {
+  return build(
+      "1\n"
+      "A B C D H\n"
+      "1\n"
+      "1\n"
+      "A\n"
+      ".\n"
+      "H\n"
+      "A . B 1 R\n"
+      "A 1 B 1 L\n"
+      "B . A 1 L\n"
+      "B 1 C . L\n"
+      "C . H 1 R\n"
+      "C 1 D 1 L\n"
+      "D . D 1 R\n"
+      "D 1 A . R\n");
+}
+
+}  // namespace turing::machines
@@ -0,0 +1,189 @@
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+
+#include "core/turing.hpp"
+#include "data/inputfile.hpp"
+#include "gtest/gtest.h"
+
+// Count the allocations done by the whole program while "counting" is set. The
+// allocations are done by malloc, as the default allocator.
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<std::size_t> num_allocations{0};
+std::atomic<std::size_t> allocated_bytes{0};
+
+void* allocate(std::size_t size) {
+  if (counting.load(std::memory_order_relaxed)) {
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  void* ptr = std::malloc(size ? size : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+
+  return ptr;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+  return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace turing {
+
+class AllocationsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    machine_.addStates({"q0", "q1"});
+    machine_.inputAlphabet().setSymbols({"1"});
+    machine_.tapeAlphabet().setSymbols({"1", "X"});
+    machine_.setInitialState("q0");
+    machine_.toggleDebugMode(false);
+  }
+
+  // Go back and forth over the input, flipping its symbols. The run never ends, and
+  // only the cells of the input (and the blanks next to it) are visited.
+  void addFlipTransitions() {
+    machine_.addTransition("q0 1 q0 X R");
+    machine_.addTransition("q0 X q0 1 R");
+    machine_.addTransition("q0 . q1 . L");
+    machine_.addTransition("q1 1 q1 X L");
+    machine_.addTransition("q1 X q1 1 L");
+    machine_.addTransition("q1 . q0 . R");
+  }
+
+  // Return the allocations done by a run of "steps" steps
+  std::size_t allocations(std::uint64_t steps) {
+    machine_.setLimits({steps, 0, std::chrono::milliseconds(0)});
+    machine_.compile();
+
+    num_allocations = 0;
+    counting = true;
+    RunResult result = machine_.simulate(input_);
+    counting = false;
+
+    EXPECT_EQ(result.verdict, Verdict::Undecided);
+    EXPECT_EQ(result.steps, steps);
+    return num_allocations;
+  }
+
+  // Check that longer runs don't allocate more: only the setup of the run allocates
+  void expectNoAllocationsPerStep() {
+    std::size_t expected = allocations(10000);
+    EXPECT_EQ(allocations(100000), expected);
+  }
+
+  // Return the bytes allocated by a run on the mapped "input_file"
+  std::size_t allocatedBytes(std::shared_ptr<const InputFile> input_file) {
+    allocated_bytes = 0;
+    counting = true;
+    RunResult result = machine_.simulate(std::move(input_file));
+    counting = false;
+
+    EXPECT_EQ(result.verdict, Verdict::Accepted);
+    EXPECT_EQ(result.steps, 1);
+    return allocated_bytes;
+  }
+
+  Turing machine_;
+  const std::string input_ = std::string(1000, '1');
+};
+
+TEST_F(AllocationsTest, DepthFirst) {
+  addFlipTransitions();
+  expectNoAllocationsPerStep();
+}
+
+TEST_F(AllocationsTest, Scans) {
+  // Go back and forth over the input, crossing it at once
+  machine_.addTransition("q0 1 q0 1 R");
+  machine_.addTransition("q0 . q1 . L");
+  machine_.addTransition("q1 1 q1 1 L");
+  machine_.addTransition("q1 . q0 . R");
+
+  expectNoAllocationsPerStep();
+}
+
+TEST_F(AllocationsTest, RunLengthTape) {
+  addFlipTransitions();
+  machine_.toggleRunLengthTape(true);
+  expectNoAllocationsPerStep();
+}
+
+TEST_F(AllocationsTest, MacroMachine) {
+  addFlipTransitions();
+  machine_.setBlockSize(4);
+  expectNoAllocationsPerStep();
+}
+
+TEST_F(AllocationsTest, Tracks) {
+  machine_.setNumTapes(2);
+  machine_.addTransition("q0 1 . q0 X . R");
+  machine_.addTransition("q0 X . q0 1 . R");
+  machine_.addTransition("q0 . . q1 . . L");
+  machine_.addTransition("q1 1 . q1 X . L");
+  machine_.addTransition("q1 X . q1 1 . L");
+  machine_.addTransition("q1 . . q0 . . R");
+
+  expectNoAllocationsPerStep();
+}
+
+TEST_F(AllocationsTest, MappedInput) {
+  // Accept after the first cell
+  machine_.inputAlphabet().setSymbols({"1", "X"});
+  machine_.setFinalStates({"q1"});
+  machine_.addTransition("q0 1 q1 1 R");
+  machine_.compile();
+
+  std::string input;
+  for (int i = 0; i < (1 << 19); ++i) {
+    input += "1X";
+  }
+
+  std::string file_path = ::testing::TempDir() + "turing_allocations.txt";
+  std::ofstream(file_path) << input;
+  auto input_file = std::make_shared<const InputFile>(file_path);
+  std::remove(file_path.c_str());
+
+  // The run reads a single page of the input, even with the runners that decode whole
+  // tapes: they aren't used for mapped inputs
+  const std::size_t max_bytes = input.size() / 8;
+  EXPECT_LT(allocatedBytes(input_file), max_bytes);
+
+  machine_.setBlockSize(4);
+  EXPECT_LT(allocatedBytes(input_file), max_bytes);
+
+  machine_.setBlockSize(0);
+  machine_.toggleRunLengthTape(true);
+  EXPECT_LT(allocatedBytes(input_file), max_bytes);
+}
+
+}  // namespace turing
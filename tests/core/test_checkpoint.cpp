@@ -0,0 +1,218 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include "core/checkpoint.hpp"
+#include "core/machineimage.hpp"
+#include "core/turing.hpp"
+#include "core/turingbuilder.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class CheckpointTest : public ::testing::Test {
+protected:
+  void TearDown() override {
+    Checkpoint::clearInterrupt();
+    std::remove(file_path_.c_str());
+  }
+
+  static std::string tapesString(const RunResult& result) {
+    std::ostringstream tapes;
+    tapes << result.tapes;
+    return tapes.str();
+  }
+
+  // Run the input until the first snapshot, and resume it on a new checkpoint
+  void expectSameAfterResume(SearchMode mode) {
+    machine_.setSearchMode(mode);
+    RunResult expected = machine_.simulate(input_);
+
+    machine_.setCheckpoint(std::make_shared<Checkpoint>(file_path_));
+    Checkpoint::interrupt();
+    ASSERT_THROW(machine_.simulate(input_), std::runtime_error);
+    Checkpoint::clearInterrupt();
+
+    ASSERT_TRUE(std::ifstream(file_path_).is_open());
+
+    auto checkpoint = std::make_shared<Checkpoint>(file_path_);
+    checkpoint->load(*machine_.compiled());
+    machine_.setCheckpoint(checkpoint);
+    ASSERT_TRUE(checkpoint->pending());
+
+    RunResult result = machine_.simulate(input_);
+    EXPECT_FALSE(checkpoint->pending());
+
+    EXPECT_EQ(result.verdict, expected.verdict);
+    EXPECT_EQ(result.steps, expected.steps);
+    EXPECT_EQ(result.depth, expected.depth);
+    EXPECT_EQ(tapesString(result), tapesString(expected));
+
+    // The snapshot is removed when the run ends
+    EXPECT_FALSE(std::ifstream(file_path_).is_open());
+  }
+
+  Turing machine_ = machines::markToGuessedEnd();
+  const std::string input_ = std::string(1500, '1');
+  const std::string file_path_ = ::testing::TempDir() + "turing_checkpoint.bin";
+};
+
+TEST_F(CheckpointTest, ResumeDepthFirst) {
+  expectSameAfterResume(SearchMode::DepthFirst);
+}
+
+TEST_F(CheckpointTest, ResumeBreadthFirst) {
+  expectSameAfterResume(SearchMode::BreadthFirst);
+}
+
+TEST_F(CheckpointTest, ResumeImage) {
+  const std::string image_path = file_path_ + ".tmi";
+  MachineImage::write(machine_, image_path);
+  Turing image = TuringBuilder::fromImage(image_path);
+  std::remove(image_path.c_str());
+  image.toggleDebugMode(false);
+
+  RunResult expected = machine_.simulate(input_);
+
+  image.setCheckpoint(std::make_shared<Checkpoint>(file_path_));
+  Checkpoint::interrupt();
+  ASSERT_THROW(image.simulate(input_), std::runtime_error);
+  Checkpoint::clearInterrupt();
+
+  // Images only have the compiled machine: it must survive loading the checkpoint
+  auto checkpoint = std::make_shared<Checkpoint>(file_path_);
+  checkpoint->load(*image.compiled());
+  image.setCheckpoint(checkpoint);
+  ASSERT_TRUE(checkpoint->pending());
+
+  RunResult result = image.simulate(input_);
+  EXPECT_FALSE(checkpoint->pending());
+
+  EXPECT_EQ(result.verdict, expected.verdict);
+  EXPECT_EQ(result.steps, expected.steps);
+  EXPECT_EQ(tapesString(result), tapesString(expected));
+}
+
+TEST_F(CheckpointTest, OtherRunStartsAgain) {
+  RunResult expected = machine_.simulate("111");
+
+  machine_.setCheckpoint(std::make_shared<Checkpoint>(file_path_));
+  Checkpoint::interrupt();
+  ASSERT_THROW(machine_.simulate(input_), std::runtime_error);
+  Checkpoint::clearInterrupt();
+
+  // The snapshot belongs to another input
+  auto checkpoint = std::make_shared<Checkpoint>(file_path_);
+  checkpoint->load(*machine_.compiled());
+  machine_.setCheckpoint(checkpoint);
+
+  RunResult result = machine_.simulate("111");
+  EXPECT_EQ(result.verdict, expected.verdict);
+  EXPECT_EQ(result.steps, expected.steps);
+  EXPECT_TRUE(checkpoint->pending());
+  EXPECT_TRUE(std::ifstream(file_path_).is_open());
+}
+
+TEST_F(CheckpointTest, KeptUntilItsRun) {
+  RunResult expected = machine_.simulate(input_);
+
+  machine_.setCheckpoint(std::make_shared<Checkpoint>(file_path_));
+  Checkpoint::interrupt();
+  ASSERT_THROW(machine_.simulate(input_), std::runtime_error);
+  Checkpoint::clearInterrupt();
+
+  // Interrupt the run of another input before reaching the one of the snapshot, as
+  // on a file of inputs
+  auto checkpoint = std::make_shared<Checkpoint>(file_path_);
+  checkpoint->load(*machine_.compiled());
+  machine_.setCheckpoint(checkpoint);
+
+  Checkpoint::interrupt();
+  ASSERT_THROW(machine_.simulate(std::string(1400, '1')), std::runtime_error);
+  Checkpoint::clearInterrupt();
+
+  // The snapshot is still on the file
+  checkpoint = std::make_shared<Checkpoint>(file_path_);
+  checkpoint->load(*machine_.compiled());
+  machine_.setCheckpoint(checkpoint);
+
+  RunResult result = machine_.simulate(input_);
+  EXPECT_FALSE(checkpoint->pending());
+  EXPECT_EQ(result.verdict, expected.verdict);
+  EXPECT_EQ(result.steps, expected.steps);
+  EXPECT_FALSE(std::ifstream(file_path_).is_open());
+}
+
+TEST_F(CheckpointTest, StopBetweenRuns) {
+  Checkpoint checkpoint(file_path_);
+  EXPECT_NO_THROW(checkpoint.stopIfInterrupted());
+
+  // Short runs end before checking it
+  machine_.setCheckpoint(std::make_shared<Checkpoint>(file_path_));
+  Checkpoint::interrupt();
+  EXPECT_NO_THROW(machine_.simulate("111"));
+  EXPECT_THROW(checkpoint.stopIfInterrupted(), std::runtime_error);
+}
+
+TEST_F(CheckpointTest, Checkpointed) {
+  EXPECT_FALSE(machine_.checkpointed());
+
+  machine_.setCheckpoint(std::make_shared<Checkpoint>(file_path_));
+  EXPECT_TRUE(machine_.checkpointed());
+
+  // Debug and profiled runs aren't saved
+  machine_.toggleDebugMode(true);
+  EXPECT_FALSE(machine_.checkpointed());
+  machine_.toggleDebugMode(false);
+  machine_.toggleProfiling(true);
+  EXPECT_FALSE(machine_.checkpointed());
+}
+
+TEST_F(CheckpointTest, InvalidFile) {
+  std::ofstream(file_path_) << "Not a checkpoint";
+
+  Checkpoint checkpoint(file_path_);
+  EXPECT_THROW(checkpoint.load(*machine_.compiled()), std::runtime_error);
+
+  // A state that isn't on the machine
+  machine_.setCheckpoint(std::make_shared<Checkpoint>(file_path_));
+  Checkpoint::interrupt();
+  ASSERT_THROW(machine_.simulate(input_), std::runtime_error);
+  Checkpoint::clearInterrupt();
+
+  std::string data;
+  {
+    std::ifstream file(file_path_, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(file), {});
+  }
+
+  // Magic, run (Machine, mode and input), steps, time, pruned, and number of frames
+  const size_t state_offset = 9 + 8 + 1 + 8 + input_.size() * sizeof(SymbolId) + 8 +
+                              8 + 1 + 8;
+  const StateId invalid_state = 3;
+  data.replace(state_offset, sizeof(StateId),
+               reinterpret_cast<const char*>(&invalid_state), sizeof(StateId));
+  std::ofstream(file_path_, std::ios::binary | std::ios::trunc)
+      .write(data.data(), data.size());
+
+  Checkpoint corrupt(file_path_);
+  EXPECT_THROW(corrupt.load(*machine_.compiled()), std::runtime_error);
+
+  // A size bigger than the file is rejected before allocating it
+  const std::uint64_t invalid_size = std::uint64_t(1) << 34;
+  data.replace(9 + 8 + 1, sizeof(invalid_size),
+               reinterpret_cast<const char*>(&invalid_size), sizeof(invalid_size));
+  std::ofstream(file_path_, std::ios::binary | std::ios::trunc)
+      .write(data.data(), data.size());
+
+  Checkpoint truncated(file_path_);
+  EXPECT_THROW(truncated.load(*machine_.compiled()), std::runtime_error);
+
+  // Missing files are ignored
+  Checkpoint missing(file_path_ + ".missing");
+  EXPECT_NO_THROW(missing.load(*machine_.compiled()));
+}
+
+}  // namespace turing
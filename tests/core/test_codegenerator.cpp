@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "core/codegenerator.hpp"
+#include "core/turing.hpp"
+#include "core/turingbuilder.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+// Compiler of the generated sources, and directory of the example machines. Both are
+// set by the build.
+#ifndef TURING_CXX_COMPILER
+#define TURING_CXX_COMPILER "c++"
+#endif
+
+#ifndef TURING_EXAMPLES_DIR
+#define TURING_EXAMPLES_DIR "examples"
+#endif
+
+namespace turing {
+
+class CodeGeneratorTest : public ::testing::Test {
+protected:
+  std::string generate() {
+    std::ostringstream source;
+    CodeGenerator(machine_).write(source);
+    return source.str();
+  }
+
+  // Every input of up to "length" symbols of the input alphabet of the machine
+  static std::vector<std::string> inputs(const Turing& machine, int length) {
+    std::vector<std::string> result{""};
+    for (size_t first = 0; length > 0; --length) {
+      size_t last = result.size();
+      for (size_t i = first; i < last; ++i) {
+        for (SymbolId id = 1; id < machine.inputAlphabet().numIds(); ++id) {
+          result.push_back(result[i] + machine.inputAlphabet().symbol(id));
+        }
+      }
+      first = last;
+    }
+
+    return result;
+  }
+
+  // Build the generated source with the system compiler, and check that it gives the
+  // same verdicts and steps as the machine
+  void expectSameRuns(Turing& machine) {
+    const std::string source_path = ::testing::TempDir() + "turing_generated.cpp";
+    const std::string binary_path = ::testing::TempDir() + "turing_generated";
+    const std::string inputs_path = ::testing::TempDir() + "turing_inputs.txt";
+    const std::string output_path = ::testing::TempDir() + "turing_output.txt";
+    const std::uint64_t max_steps = 1000;
+
+    CodeGenerator(machine).write(source_path);
+    std::string build = std::string(TURING_CXX_COMPILER) + " -std=c++17 -O1 -o " +
+                        binary_path + " " + source_path;
+    ASSERT_EQ(std::system(build.c_str()), 0) << build;
+
+    std::vector<std::string> runs = inputs(machine, 4);
+    {
+      std::ofstream inputs_file(inputs_path);
+      for (const auto& input : runs) {
+        inputs_file << input << "\n";
+      }
+    }
+
+    std::string run = binary_path + " --max-steps " + std::to_string(max_steps) +
+                      " < " + inputs_path + " > " + output_path;
+    ASSERT_EQ(std::system(run.c_str()), 0) << run;
+
+    machine.setLimits({max_steps, 0, std::chrono::milliseconds(0)});
+    std::ifstream output(output_path);
+    std::string recognized, steps;
+    for (const auto& input : runs) {
+      std::string line;
+      std::getline(output, line);
+      std::getline(output, recognized);
+      std::getline(output, steps);
+      std::getline(output, line);
+
+      RunResult expected = machine.simulate(input);
+      std::string verdict = (expected.verdict == Verdict::Accepted)   ? "true"
+                            : (expected.verdict == Verdict::Rejected) ? "false"
+                                                                      : "undecided";
+      EXPECT_EQ(recognized.substr(0, 12 + verdict.size()), "Recognized: " + verdict)
+          << input;
+      EXPECT_EQ(steps, "Steps: " + std::to_string(expected.steps)) << input;
+    }
+
+    for (const auto& path : {source_path, binary_path, inputs_path, output_path}) {
+      std::remove(path.c_str());
+    }
+  }
+
+  Turing machine_ = machines::markOnes();
+};
+
+TEST_F(CodeGeneratorTest, Interface) {
+  std::string source = generate();
+
+  EXPECT_NE(source.find("extern \"C\" int turing_run("), std::string::npos);
+  EXPECT_NE(source.find("#ifndef TURING_NO_MAIN"), std::string::npos);
+}
+
+TEST_F(CodeGeneratorTest, States) {
+  std::string source = generate();
+
+  // A block for each state, starting on the initial one
+  EXPECT_NE(source.find("goto state_0;"), std::string::npos);
+  EXPECT_NE(source.find("state_0:  // q0"), std::string::npos);
+  EXPECT_NE(source.find("state_1:  // q1"), std::string::npos);
+  EXPECT_NE(source.find("state_2:  // q2\n  goto accept;"), std::string::npos);
+}
+
+TEST_F(CodeGeneratorTest, Transitions) {
+  std::string source = generate();
+
+  // A case for each transition. Symbols that don't change aren't written.
+  size_t cases = 0;
+  for (size_t pos = source.find("    case "); pos != std::string::npos;
+       pos = source.find("    case ", pos + 1)) {
+    ++cases;
+  }
+  EXPECT_EQ(cases, 5);
+
+  SymbolId x = machine_.tapeAlphabet().id("X");
+  EXPECT_NE(source.find("t0.write(" + std::to_string(x) + ");"), std::string::npos);
+  EXPECT_EQ(source.find("t0.write(0);"), std::string::npos);
+}
+
+TEST_F(CodeGeneratorTest, Comments) {
+  // A backslash at the end of a comment would comment out the next line
+  machine_.addState("q\\");
+  machine_.addTransition("q\\ 1 q0 1 R");
+  std::string source = generate();
+
+  EXPECT_NE(source.find("// q\n"), std::string::npos);
+  EXPECT_EQ(source.find("\\\n"), std::string::npos);
+}
+
+TEST_F(CodeGeneratorTest, SameAsTuring) {
+  if (std::system(TURING_CXX_COMPILER " --version > /dev/null 2>&1") != 0) {
+    GTEST_SKIP() << "No C++ compiler to build the generated sources";
+  }
+
+  for (const char* example :
+       {"Ejemplo_MT.txt", "multitrack.txt", "problem_1.txt", "problem_2.txt"}) {
+    SCOPED_TRACE(example);
+    Turing machine =
+        TuringBuilder::fromFile(std::string(TURING_EXAMPLES_DIR) + "/" + example);
+    machine.toggleDebugMode(false);
+
+    expectSameRuns(machine);
+  }
+
+  // Runs that don't end
+  Turing machine = machines::bounceOnZero();
+  expectSameRuns(machine);
+}
+
+TEST_F(CodeGeneratorTest, NonDeterministic) {
+  machine_.addTransition("q0 0 q1 0 R");
+
+  EXPECT_THROW(CodeGenerator generator(machine_), std::runtime_error);
+}
+
+}  // namespace turing
@@ -0,0 +1,108 @@
+#include "core/compiledmachine.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+
+namespace turing {
+
+class CompiledMachineTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    machine_.addStates({"q0", "q1"});
+    machine_.inputAlphabet().setSymbols({"0", "1"});
+    machine_.tapeAlphabet().setSymbols({"0", "1", "."});
+    machine_.setInitialState("q0");
+    machine_.setFinalStates({"q1"});
+
+    machine_.addTransition("q0 1 q0 0 R");
+    machine_.addTransition("q0 0 q0 1 R");
+    machine_.addTransition("q0 0 q1 0 S");
+  }
+
+  std::vector<Tape> tapes(const std::string& input) {
+    std::vector<Tape> tapes(1, Tape(machine_.tapeAlphabet()));
+    tapes[0].setInputString(input, machine_.inputAlphabet());
+    return tapes;
+  }
+
+  Turing machine_;
+};
+
+TEST_F(CompiledMachineTest, States) {
+  CompiledMachine compiled(machine_);
+
+  ASSERT_EQ(compiled.numStates(), 2);
+  ASSERT_EQ(compiled.stateName(compiled.initialState()), "q0");
+  ASSERT_FALSE(compiled.isFinal(compiled.initialState()));
+}
+
+TEST_F(CompiledMachineTest, Transitions) {
+  CompiledMachine compiled(machine_);
+  ASSERT_EQ(compiled.numTransitions(), 3);
+
+  auto input = tapes("10");
+  auto range = compiled.transitions(compiled.initialState(), input);
+  ASSERT_EQ(range.size(), 1);
+  ASSERT_EQ(compiled.sourceState(range.first), compiled.initialState());
+
+  StateId next = compiled.apply(range.first, input);
+  ASSERT_EQ(compiled.stateName(next), "q0");
+
+  // Non-deterministic
+  range = compiled.transitions(next, input);
+  ASSERT_EQ(range.size(), 2);
+
+  // No transitions on blank
+  input[0].move(Move::Right);
+  ASSERT_TRUE(compiled.transitions(next, input).empty());
+}
+
+TEST_F(CompiledMachineTest, Actions) {
+  CompiledMachine compiled(machine_);
+
+  auto input = tapes("1");
+  auto range = compiled.transitions(compiled.initialState(), input);
+  const auto* action = compiled.actions(range.first);
+
+  ASSERT_EQ(action->write, machine_.tapeAlphabet().id("0"));
+  ASSERT_EQ(action->move, Move::Right);
+  ASSERT_EQ(compiled.stateName(action->next_state), "q0");
+}
+
+TEST_F(CompiledMachineTest, ReadSymbols) {
+  CompiledMachine compiled(machine_);
+
+  auto input = tapes("1");
+  auto range = compiled.transitions(compiled.initialState(), input);
+  ASSERT_EQ(compiled.readSymbols(range.first),
+            std::vector<SymbolId>{machine_.tapeAlphabet().id("1")});
+}
+
+TEST_F(CompiledMachineTest, SparseTable) {
+  // 3 tapes with 256 symbols don't fit on the dense table
+  Turing machine(3);
+  std::vector<Symbol> symbols;
+  for (int i = 0; i < 255; ++i) {
+    symbols.push_back("s" + std::to_string(i));
+  }
+
+  machine.addStates({"q0", "q1"});
+  machine.inputAlphabet().setSymbols(symbols);
+  machine.tapeAlphabet().setSymbols(symbols);
+  machine.setInitialState("q0");
+  machine.setFinalStates({"q1"});
+  machine.toggleDebugMode(false);
+
+  machine.addTransition("q0 s7 . . q0 s7 s7 . R");
+  machine.addTransition("q0 . . . q1 . . . S");
+
+  ASSERT_EQ(machine.run("s7s7s7"), Verdict::Accepted);
+  ASSERT_EQ(machine.run("s7s8"), Verdict::Rejected);
+}
+
+TEST_F(CompiledMachineTest, WrongNumberOfSymbols) {
+  machine_.addTransition("q0", {"0", "1"}, "q1", {"0", "1"}, {Move::Left});
+
+  ASSERT_THROW({ CompiledMachine compiled(machine_); }, std::runtime_error);
+}
+
+}  // namespace turing
@@ -0,0 +1,88 @@
+#include <sstream>
+
+#include "core/compiledmachine.hpp"
+#include "core/loopmachine.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class LoopMachineTest : public ::testing::Test {
+protected:
+  static std::string tapesString(const RunResult& result) {
+    std::ostringstream tapes;
+    tapes << result.tapes;
+    return tapes.str();
+  }
+
+  RunResult run(const std::string& input, const Limits& limits = Limits()) {
+    std::vector<Tape> tapes(1, Tape(machine_.tapeAlphabet()));
+    tapes[0].setInputString(input, machine_.inputAlphabet());
+
+    return LoopMachine(*machine_.compiled()).run(tapes, limits);
+  }
+
+  Turing machine_ = machines::bounceOnZero();
+};
+
+TEST_F(LoopMachineTest, DetectLoop) {
+  // "11" under the head at step 2 repeats every 4 steps
+  RunResult result = run("10");
+
+  ASSERT_EQ(result.verdict, Verdict::Rejected);
+  ASSERT_TRUE(result.cycle);
+  EXPECT_EQ(result.cycle->start, 2);
+  EXPECT_EQ(result.cycle->length, 4);
+
+  result = run("1111110");
+  ASSERT_TRUE(result.cycle);
+  EXPECT_EQ(result.cycle->start, 7);
+  EXPECT_EQ(result.cycle->length, 4);
+}
+
+TEST_F(LoopMachineTest, SameAsTuring) {
+  for (bool accept : {true, false}) {
+    machine_.setFinalStates((accept) ? std::vector<std::string>{"q3"}
+                                     : std::vector<std::string>{});
+    machine_.compile();
+
+    for (const std::string input : {"", "1", "1111"}) {
+      RunResult expected = machine_.simulate(input);
+      RunResult result = run(input);
+
+      EXPECT_EQ(result.verdict, expected.verdict) << input;
+      EXPECT_EQ(result.steps, expected.steps) << input;
+      EXPECT_EQ(result.depth, expected.depth) << input;
+      EXPECT_EQ(tapesString(result), tapesString(expected)) << input;
+      EXPECT_FALSE(result.cycle) << input;
+    }
+  }
+}
+
+TEST_F(LoopMachineTest, NoRepetition) {
+  // Write 1s to the right forever: the configurations never repeat
+  machine_.addTransition("q3 . q3 1 R");
+  machine_.setFinalStates({});
+  machine_.compile();
+
+  RunResult result = run("", {1000, 0, std::chrono::milliseconds(0)});
+
+  ASSERT_EQ(result.verdict, Verdict::Undecided);
+  ASSERT_EQ(result.steps, 1000);
+  ASSERT_FALSE(result.cycle);
+}
+
+TEST_F(LoopMachineTest, Turing) {
+  machine_.setLimits({1000, 0, std::chrono::milliseconds(0)});
+  ASSERT_EQ(machine_.run("10"), Verdict::Undecided);
+
+  machine_.toggleLoopDetection(true);
+  RunResult result = machine_.simulate("10");
+
+  ASSERT_EQ(result.verdict, Verdict::Rejected);
+  ASSERT_TRUE(result.cycle);
+  ASSERT_EQ(machine_.run("11"), Verdict::Accepted);
+}
+
+}  // namespace turing
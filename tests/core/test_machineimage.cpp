@@ -0,0 +1,211 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "core/compiledmachine.hpp"
+#include "core/machineimage.hpp"
+#include "core/turing.hpp"
+#include "core/turingbuilder.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class MachineImageTest : public ::testing::Test {
+protected:
+  void TearDown() override { std::remove(file_path_.c_str()); }
+
+  static std::string tapesString(const RunResult& result) {
+    std::ostringstream tapes;
+    tapes << result.tapes;
+    return tapes.str();
+  }
+
+  // Check that the image runs as the machine
+  void expectSameRuns(const Turing& machine,
+                      const Turing& image,
+                      const std::vector<std::string>& inputs) {
+    for (const auto& input : inputs) {
+      RunResult expected = machine.simulate(input);
+      RunResult result = image.simulate(input);
+
+      EXPECT_EQ(result.verdict, expected.verdict);
+      EXPECT_EQ(result.steps, expected.steps);
+      EXPECT_EQ(tapesString(result), tapesString(expected));
+    }
+  }
+
+  const std::string file_path_ = ::testing::TempDir() + "turing_machine.tmi";
+  Turing machine_ = machines::guessLastOne();
+};
+
+TEST_F(MachineImageTest, SameMachine) {
+  MachineImage::write(machine_, file_path_);
+
+  ASSERT_TRUE(MachineImage::isImage(file_path_));
+  Turing image = TuringBuilder::fromFile(file_path_);
+  image.toggleDebugMode(false);
+
+  auto expected = machine_.compiled();
+  auto compiled = image.compiled();
+
+  EXPECT_EQ(compiled->fingerprint(), expected->fingerprint());
+  EXPECT_EQ(compiled->numTapes(), expected->numTapes());
+  EXPECT_EQ(compiled->numStates(), expected->numStates());
+  EXPECT_EQ(compiled->numTransitions(), expected->numTransitions());
+  EXPECT_EQ(compiled->deterministic(), expected->deterministic());
+  EXPECT_EQ(compiled->stateName(compiled->initialState()), "q0");
+
+  for (TransitionId t = 0; t < expected->numTransitions(); ++t) {
+    EXPECT_EQ(compiled->transitionName(t), expected->transitionName(t));
+    EXPECT_EQ(compiled->sourceState(t), expected->sourceState(t));
+  }
+
+  expectSameRuns(machine_, image, {"", "0", "01", "0110", "0101", "2"});
+}
+
+TEST_F(MachineImageTest, SparseTable) {
+  // 3 tapes with 256 symbols don't fit on the dense table
+  Turing machine(3);
+  std::vector<Symbol> symbols;
+  for (int i = 0; i < 255; ++i) {
+    symbols.push_back("s" + std::to_string(i));
+  }
+
+  machine.addStates({"q0", "q1"});
+  machine.inputAlphabet().setSymbols(symbols);
+  machine.tapeAlphabet().setSymbols(symbols);
+  machine.setInitialState("q0");
+  machine.setFinalStates({"q1"});
+  machine.toggleDebugMode(false);
+
+  machine.addTransition("q0 s7 . . q0 s7 s7 . R");
+  machine.addTransition("q0 . . . q1 . . . S");
+  machine.compile();
+
+  MachineImage::write(machine, file_path_);
+  Turing image = TuringBuilder::fromImage(file_path_);
+  image.toggleDebugMode(false);
+
+  expectSameRuns(machine, image, {"s7s7s7", "s7s8", ""});
+}
+
+TEST_F(MachineImageTest, CantModifyTransitions) {
+  MachineImage::write(machine_, file_path_);
+  Turing image = TuringBuilder::fromImage(file_path_);
+
+  // The transitions were compiled, there aren't Transition objects
+  EXPECT_THROW(image.compiled()->transition(0), std::runtime_error);
+}
+
+TEST_F(MachineImageTest, KeepsCompiledMachine) {
+  MachineImage::write(machine_, file_path_);
+  Turing image = TuringBuilder::fromImage(file_path_);
+  image.toggleDebugMode(false);
+
+  // The image doesn't have States to compile again
+  auto compiled = image.compiled();
+  image.tapeAlphabet();
+  image.setNumTapes(1);
+  image.compile();
+  EXPECT_EQ(image.compiled(), compiled);
+
+  expectSameRuns(machine_, image, {"01", "0110"});
+}
+
+TEST_F(MachineImageTest, InvalidImage) {
+  std::ofstream(file_path_) << "not an image";
+  EXPECT_FALSE(MachineImage::isImage(file_path_));
+  EXPECT_THROW(MachineImage image(file_path_), std::runtime_error);
+
+  // Truncated image
+  MachineImage::write(machine_, file_path_);
+  std::string data;
+  {
+    std::ifstream file(file_path_, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(file), {});
+  }
+  std::ofstream(file_path_, std::ios::binary | std::ios::trunc)
+      .write(data.data(), data.size() / 2);
+
+  EXPECT_TRUE(MachineImage::isImage(file_path_));
+  EXPECT_THROW(MachineImage image(file_path_), std::runtime_error);
+}
+
+TEST_F(MachineImageTest, CorruptHeader) {
+  MachineImage::write(machine_, file_path_);
+  std::string data;
+  {
+    std::ifstream file(file_path_, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(file), {});
+  }
+
+  // Write the image with a field of the header replaced
+  auto patch = [&](size_t offset, auto value) {
+    std::string patched = data;
+    std::memcpy(&patched[offset], &value, sizeof(value));
+    std::ofstream(file_path_, std::ios::binary | std::ios::trunc)
+        .write(patched.data(), patched.size());
+  };
+
+  patch(offsetof(MachineImage::Header, initial_state), StateId(1000));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  patch(offsetof(MachineImage::Header, num_states), std::uint64_t(2));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  patch(offsetof(MachineImage::Header, num_transitions), std::uint64_t(3));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  // The last offset must be the number of transitions
+  const auto& header = *reinterpret_cast<const MachineImage::Header*>(data.data());
+  patch(header.offsets.offset + header.offsets.size - sizeof(TransitionId),
+        TransitionId(1000));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  // The original image is still valid
+  patch(offsetof(MachineImage::Header, initial_state), header.initial_state);
+  EXPECT_NO_THROW(TuringBuilder::fromImage(file_path_));
+}
+
+TEST_F(MachineImageTest, CorruptTables) {
+  MachineImage::write(machine_, file_path_);
+  std::string data;
+  {
+    std::ifstream file(file_path_, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(file), {});
+  }
+  const auto header = *reinterpret_cast<const MachineImage::Header*>(data.data());
+
+  // Write the image with a value of a section replaced
+  auto patch = [&](size_t offset, auto value) {
+    std::string patched = data;
+    std::memcpy(&patched[offset], &value, sizeof(value));
+    std::ofstream(file_path_, std::ios::binary | std::ios::trunc)
+        .write(patched.data(), patched.size());
+  };
+
+  const size_t action = header.actions.offset;
+  patch(action + offsetof(CompiledMachine::Action, next_state), StateId(3));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  patch(action + offsetof(CompiledMachine::Action, write), SymbolId(4));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  patch(action + offsetof(CompiledMachine::Action, move), std::uint8_t(7));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  patch(header.source_states.offset, StateId(3));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  // The offsets must not decrease
+  patch(header.offsets.offset + sizeof(TransitionId), TransitionId(2));
+  EXPECT_THROW(TuringBuilder::fromImage(file_path_), std::runtime_error);
+
+  patch(header.actions.offset, data[header.actions.offset]);
+  EXPECT_NO_THROW(TuringBuilder::fromImage(file_path_));
+}
+
+}  // namespace turing
@@ -0,0 +1,142 @@
+#include <sstream>
+
+#include "core/compiledmachine.hpp"
+#include "core/macromachine.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class MacroMachineTest : public ::testing::Test {
+protected:
+  // Run with and without blocks, and check that the results are the same
+  void expectSameResult(const std::string& input, int block_size) {
+    machine_.setBlockSize(0);
+    RunResult expected = machine_.simulate(input);
+
+    machine_.setBlockSize(block_size);
+    RunResult result = machine_.simulate(input);
+
+    EXPECT_EQ(result.verdict, expected.verdict);
+    EXPECT_EQ(result.steps, expected.steps);
+    EXPECT_EQ(result.depth, expected.depth);
+
+    std::ostringstream expected_tapes, result_tapes;
+    expected_tapes << expected.tapes;
+    result_tapes << result.tapes;
+    EXPECT_EQ(result_tapes.str(), expected_tapes.str());
+  }
+
+  Turing machine_ = machines::busyBeaver4();
+};
+
+TEST_F(MacroMachineTest, Supports) {
+  ASSERT_TRUE(MacroMachine::supports(*machine_.compiled()));
+
+  machine_.addTransition("A . C 1 R");
+  ASSERT_FALSE(MacroMachine::supports(*machine_.compiled()));
+}
+
+TEST_F(MacroMachineTest, BusyBeaver) {
+  machine_.setBlockSize(3);
+  RunResult result = machine_.simulate("");
+
+  ASSERT_EQ(result.verdict, Verdict::Accepted);
+  ASSERT_EQ(result.steps, 107);
+
+  for (int block_size = 1; block_size <= 8; ++block_size) {
+    expectSameResult("", block_size);
+    expectSameResult("111", block_size);
+    expectSameResult("1111111111", block_size);
+  }
+}
+
+TEST_F(MacroMachineTest, Reject) {
+  // No transition from B on a blank
+  machine_.addState("E");
+  machine_.setFinalStates({"E"});
+  machine_.compile();
+
+  for (int block_size = 1; block_size <= 4; ++block_size) {
+    expectSameResult("", block_size);
+  }
+}
+
+TEST_F(MacroMachineTest, StepBudget) {
+  for (std::uint64_t max_steps : {1, 50, 106, 107}) {
+    machine_.setLimits({max_steps, 0, std::chrono::milliseconds(0)});
+
+    for (int block_size = 1; block_size <= 4; ++block_size) {
+      expectSameResult("", block_size);
+    }
+  }
+}
+
+TEST_F(MacroMachineTest, Loop) {
+  // Bounces forever inside a block
+  machine_.addStates({"L", "R"});
+  machine_.addTransition("L . R . R");
+  machine_.addTransition("R . L . L");
+  machine_.setInitialState("L");
+  machine_.setBlockSize(4);
+
+  // The loop is counted up to the budget
+  for (std::uint64_t max_steps : {100, 448, 5000}) {
+    machine_.setLimits({max_steps, 0, std::chrono::milliseconds(0)});
+    expectSameResult("", 4);
+  }
+  machine_.setLimits({0, 1000, std::chrono::milliseconds(0)});
+  expectSameResult("", 4);
+
+  // Without a step budget, the loop is proven: the steps are the ones until it's
+  // detected (7 states * 4 cells * 2^4 blocks), and the cycle is the one found by
+  // LoopMachine
+  machine_.setBlockSize(0);
+  machine_.toggleLoopDetection(true);
+  machine_.setLimits({});
+  RunResult expected = machine_.simulate("");
+  ASSERT_TRUE(expected.cycle);
+
+  machine_.toggleLoopDetection(false);
+  machine_.setBlockSize(4);
+  for (auto max_time : {0, 1000}) {
+    machine_.setLimits({0, 0, std::chrono::milliseconds(max_time)});
+    RunResult result = machine_.simulate("");
+
+    EXPECT_EQ(result.verdict, Verdict::Rejected);
+    EXPECT_EQ(result.steps, 7 * 4 * 16);
+    ASSERT_TRUE(result.cycle);
+    EXPECT_EQ(result.cycle->start, expected.cycle->start);
+    EXPECT_EQ(result.cycle->length, expected.cycle->length);
+  }
+
+  // The cycle counts the steps done before the block
+  machine_.addState("P");
+  machine_.addTransition("P 1 P 1 R");
+  machine_.addTransition("P . L . R");
+  machine_.setInitialState("P");
+  machine_.setLimits({});
+
+  RunResult result = machine_.simulate("11111");
+  machine_.setBlockSize(0);
+  machine_.toggleLoopDetection(true);
+  expected = machine_.simulate("11111");
+  ASSERT_TRUE(result.cycle && expected.cycle);
+  EXPECT_EQ(result.cycle->start, expected.cycle->start);
+  EXPECT_EQ(result.cycle->length, expected.cycle->length);
+}
+
+TEST_F(MacroMachineTest, TimeBudget) {
+  // Bounces inside a block too big to detect the loop
+  machine_.addStates({"L", "R"});
+  machine_.addTransition("L . R . R");
+  machine_.addTransition("R . L . L");
+  machine_.setInitialState("L");
+  machine_.setBlockSize(32);
+  machine_.setLimits({0, 0, std::chrono::milliseconds(50)});
+
+  ASSERT_EQ(machine_.run(""), Verdict::Undecided);
+}
+
+}  // namespace turing
@@ -0,0 +1,107 @@
+#include <sstream>
+
+#include "core/compiledmachine.hpp"
+#include "core/profile.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class ProfileTest : public ::testing::Test {
+protected:
+  void SetUp() override { machine_.toggleProfiling(true); }
+
+  StateId state(const std::string& name) const {
+    auto compiled = machine_.compiled();
+    for (StateId s = 0; s < compiled->numStates(); ++s) {
+      if (compiled->stateName(s) == name) {
+        return s;
+      }
+    }
+    return CompiledMachine::no_state;
+  }
+
+  Turing machine_ = machines::walkOnesWithDeadEnds();
+};
+
+TEST_F(ProfileTest, Disabled) {
+  machine_.toggleProfiling(false);
+
+  ASSERT_FALSE(machine_.simulate("111").profile);
+}
+
+TEST_F(ProfileTest, Counters) {
+  for (auto mode : {SearchMode::DepthFirst, SearchMode::BreadthFirst}) {
+    machine_.setSearchMode(mode);
+    RunResult result = machine_.simulate("11");
+
+    ASSERT_TRUE(result.profile);
+    const Profile& profile = *result.profile;
+
+    ASSERT_EQ(profile.runs(), 1);
+    ASSERT_EQ(profile.branchPoints(state("q0")), 2);
+    ASSERT_EQ(profile.backtracks(state("q0")), 2);
+    ASSERT_EQ(profile.stateVisits(state("q1")), 1);
+    ASSERT_EQ(profile.minHead(0), 0);
+    ASSERT_EQ(profile.maxHead(0), 2);
+
+    // Every step fires a transition
+    std::uint64_t firings = 0;
+    for (TransitionId t = 0; t < machine_.compiled()->numTransitions(); ++t) {
+      firings += profile.transitionFirings(t);
+    }
+    ASSERT_EQ(firings, result.steps);
+  }
+}
+
+TEST_F(ProfileTest, Parallel) {
+  machine_.setSearchMode(SearchMode::Parallel);
+  machine_.setSearchThreads(2);
+
+  // The dead ends are never accepted, so the whole tree is explored
+  machine_.setFinalStates({});
+  machine_.compile();
+  RunResult result = machine_.simulate("111");
+
+  ASSERT_EQ(result.verdict, Verdict::Rejected);
+  ASSERT_TRUE(result.profile);
+  ASSERT_EQ(result.profile->branchPoints(state("q0")), 3);
+  ASSERT_EQ(result.profile->stateVisits(state("q2")), 3);
+}
+
+TEST_F(ProfileTest, Merge) {
+  Profile total;
+  total.merge(*machine_.simulate("1").profile);
+  total.merge(*machine_.simulate("111").profile);
+
+  ASSERT_EQ(total.runs(), 2);
+  ASSERT_EQ(total.stateVisits(state("q1")), 2);
+  ASSERT_EQ(total.maxHead(0), 3);
+}
+
+TEST_F(ProfileTest, Export) {
+  RunResult result = machine_.simulate("1");
+
+  std::ostringstream json;
+  result.profile->writeJson(json, *machine_.compiled());
+  ASSERT_NE(json.str().find("\"runs\": 1"), std::string::npos);
+  ASSERT_NE(json.str().find("\"name\": \"q0\""), std::string::npos);
+  ASSERT_NE(json.str().find("\"extent\": 2"), std::string::npos);
+
+  // Only the line breaks between the fields are control characters
+  for (char c : json.str()) {
+    ASSERT_TRUE(c == '\n' || static_cast<unsigned char>(c) >= 0x20);
+  }
+
+  std::ostringstream csv;
+  result.profile->writeCsv(csv, *machine_.compiled());
+  ASSERT_EQ(csv.str().find("kind,id,name"), 0);
+  ASSERT_NE(csv.str().find("state,"), std::string::npos);
+  ASSERT_NE(csv.str().find("transition,"), std::string::npos);
+  for (char c : csv.str()) {
+    ASSERT_TRUE(c == '\n' || static_cast<unsigned char>(c) >= 0x20);
+  }
+}
+
+}  // namespace turing
@@ -0,0 +1,217 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include "core/compiledmachine.hpp"
+#include "core/resultcache.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class ResultCacheTest : public ::testing::Test {
+protected:
+  static std::string tapesString(const RunResult& result) {
+    std::ostringstream tapes;
+    tapes << result.tapes;
+    return tapes.str();
+  }
+
+  Turing machine_ = machines::flipBits();
+};
+
+TEST_F(ResultCacheTest, HitsAndMisses) {
+  auto cache = std::make_shared<ResultCache>();
+  machine_.setResultCache(cache);
+
+  machine_.simulate("0101");
+  machine_.simulate("0101");
+  machine_.simulate("0100");
+  machine_.simulate("0101");
+
+  EXPECT_EQ(cache->size(), 2);
+  EXPECT_EQ(cache->hits(), 2);
+  EXPECT_EQ(cache->misses(), 2);
+}
+
+TEST_F(ResultCacheTest, SameResult) {
+  for (const std::string input : {"", "1", "0101", "0100"}) {
+    machine_.setResultCache(nullptr);
+    RunResult expected = machine_.simulate(input);
+
+    auto cache = std::make_shared<ResultCache>();
+    machine_.setResultCache(cache);
+    machine_.simulate(input);
+    RunResult result = machine_.simulate(input);
+
+    EXPECT_EQ(cache->hits(), 1);
+    EXPECT_EQ(result.verdict, expected.verdict);
+    EXPECT_EQ(result.steps, expected.steps);
+    EXPECT_EQ(result.depth, expected.depth);
+    EXPECT_EQ(tapesString(result), tapesString(expected));
+  }
+}
+
+TEST_F(ResultCacheTest, WithoutTapes) {
+  auto cache = std::make_shared<ResultCache>(false);
+  machine_.setResultCache(cache);
+
+  RunResult first = machine_.simulate("01");
+  RunResult cached = machine_.simulate("01");
+
+  // The cached result keeps the verdict, but the tapes are the initial ones
+  EXPECT_EQ(cache->hits(), 1);
+  EXPECT_EQ(cached.verdict, first.verdict);
+  EXPECT_EQ(cached.steps, first.steps);
+  RunResult initial;
+  initial.tapes.emplace_back(machine_.tapeAlphabet());
+  initial.tapes[0].setInputString("01", machine_.inputAlphabet());
+  EXPECT_EQ(tapesString(cached), tapesString(initial));
+}
+
+TEST_F(ResultCacheTest, ChangedMachine) {
+  auto cache = std::make_shared<ResultCache>();
+  machine_.setResultCache(cache);
+  machine_.simulate("0101");
+
+  std::uint64_t fingerprint = machine_.compiled()->fingerprint();
+
+  // A different machine doesn't share the results
+  machine_.addTransition("q0 . q2 . R");
+  machine_.compile();
+  EXPECT_NE(machine_.compiled()->fingerprint(), fingerprint);
+
+  machine_.simulate("0101");
+  EXPECT_EQ(cache->hits(), 0);
+
+  // Neither does a different budget
+  Limits limits;
+  limits.max_steps = 2;
+  machine_.setLimits(limits);
+
+  RunResult result = machine_.simulate("0101");
+  EXPECT_EQ(cache->hits(), 0);
+  EXPECT_EQ(result.verdict, Verdict::Undecided);
+}
+
+TEST_F(ResultCacheTest, ChangedRunner) {
+  auto cache = std::make_shared<ResultCache>();
+  machine_.setResultCache(cache);
+  machine_.simulate("0101");
+
+  // Blocks and run-length tapes don't share the results of the plain runs
+  machine_.setBlockSize(2);
+  machine_.simulate("0101");
+  EXPECT_EQ(cache->hits(), 0);
+
+  machine_.setBlockSize(0);
+  machine_.toggleRunLengthTape(true);
+  machine_.simulate("0101");
+  EXPECT_EQ(cache->hits(), 0);
+
+  machine_.toggleRunLengthTape(false);
+  machine_.simulate("0101");
+  EXPECT_EQ(cache->hits(), 1);
+}
+
+TEST_F(ResultCacheTest, DebugModeIgnoresCache) {
+  auto cache = std::make_shared<ResultCache>();
+  machine_.setResultCache(cache);
+  machine_.toggleDebugMode(true);
+
+  testing::internal::CaptureStdout();
+  machine_.simulate("01");
+  machine_.simulate("01");
+  testing::internal::GetCapturedStdout();
+
+  EXPECT_EQ(cache->size(), 0);
+}
+
+TEST_F(ResultCacheTest, SaveAndLoad) {
+  const std::string file_path = ::testing::TempDir() + "turing_result_cache.bin";
+
+  auto cache = std::make_shared<ResultCache>();
+  machine_.setResultCache(cache);
+  RunResult expected = machine_.simulate("0011");
+  machine_.simulate("0010");
+  cache->save(file_path);
+
+  auto loaded = std::make_shared<ResultCache>();
+  loaded->load(file_path);
+  EXPECT_EQ(loaded->size(), 2);
+
+  machine_.setResultCache(loaded);
+  RunResult result = machine_.simulate("0011");
+
+  EXPECT_EQ(loaded->hits(), 1);
+  EXPECT_EQ(result.verdict, expected.verdict);
+  EXPECT_EQ(result.steps, expected.steps);
+  EXPECT_EQ(tapesString(result), tapesString(expected));
+
+  std::remove(file_path.c_str());
+}
+
+TEST_F(ResultCacheTest, LoadInvalidFile) {
+  const std::string file_path = ::testing::TempDir() + "turing_invalid_cache.bin";
+  std::ofstream(file_path) << "not a cache";
+
+  ResultCache cache;
+  EXPECT_THROW(cache.load(file_path), std::runtime_error);
+
+  std::remove(file_path.c_str());
+
+  // A missing file is an empty cache
+  EXPECT_NO_THROW(cache.load(file_path));
+  EXPECT_EQ(cache.size(), 0);
+}
+
+TEST_F(ResultCacheTest, LoadCorruptFile) {
+  const std::string file_path = ::testing::TempDir() + "turing_corrupt_cache.bin";
+
+  ResultCache cache;
+  cache.insert(1, {}, machine_.simulate("0011"));
+  cache.save(file_path);
+
+  std::string data;
+  {
+    std::ifstream file(file_path, std::ios::binary);
+    data.assign(std::istreambuf_iterator<char>(file), {});
+  }
+
+  // Write the file with a value replaced
+  auto patch = [&](size_t offset, auto value) {
+    std::string patched = data;
+    std::memcpy(&patched[offset], &value, sizeof(value));
+    std::ofstream(file_path, std::ios::binary | std::ios::trunc)
+        .write(patched.data(), patched.size());
+  };
+
+  // Magic, number of entries, machine, and the size of the (empty) input
+  const size_t input_offset = 10 + 8 + 8;
+  const size_t verdict_offset = input_offset + 8;
+  const size_t num_tapes_offset = verdict_offset + 1 + 8 + 8;
+  const size_t cells_offset = num_tapes_offset + 4 + 4 + 4 + 8;
+
+  patch(input_offset, std::uint64_t(1) << 60);
+  EXPECT_THROW(ResultCache().load(file_path), std::runtime_error);
+
+  patch(verdict_offset, std::uint8_t(7));
+  EXPECT_THROW(ResultCache().load(file_path), std::runtime_error);
+
+  patch(num_tapes_offset, std::uint32_t(1) << 30);
+  EXPECT_THROW(ResultCache().load(file_path), std::runtime_error);
+
+  // A symbol that isn't on the alphabet is a miss
+  patch(cells_offset, SymbolId(1000));
+  ResultCache loaded;
+  loaded.load(file_path);
+  EXPECT_FALSE(loaded.find(1, {}, machine_.tapeAlphabet()));
+  EXPECT_EQ(loaded.misses(), 1);
+
+  std::remove(file_path.c_str());
+}
+
+}  // namespace turing
@@ -0,0 +1,75 @@
+#include <sstream>
+
+#include "core/runlengthmachine.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class RunLengthMachineTest : public ::testing::Test {
+protected:
+  // Run with and without the run-length tape, and check that the results are the same
+  void expectSameResult(const std::string& input) {
+    machine_.toggleRunLengthTape(false);
+    RunResult expected = machine_.simulate(input);
+
+    machine_.toggleRunLengthTape(true);
+    RunResult result = machine_.simulate(input);
+
+    EXPECT_EQ(result.verdict, expected.verdict);
+    EXPECT_EQ(result.steps, expected.steps);
+
+    std::ostringstream expected_tapes, result_tapes;
+    expected_tapes << expected.tapes;
+    result_tapes << result.tapes;
+    EXPECT_EQ(result_tapes.str(), expected_tapes.str());
+  }
+
+  Turing machine_ = machines::crossAndMark();
+};
+
+TEST_F(RunLengthMachineTest, Sweeps) {
+  expectSameResult("");
+  expectSameResult("1");
+  expectSameResult(std::string(1000, '1'));
+}
+
+TEST_F(RunLengthMachineTest, LongRun) {
+  machine_.toggleRunLengthTape(true);
+
+  // Two sweeps of 10^6 cells
+  RunResult result = machine_.simulate(std::string(1000000, '1'));
+
+  ASSERT_EQ(result.verdict, Verdict::Accepted);
+  ASSERT_EQ(result.steps, 2000002);
+}
+
+TEST_F(RunLengthMachineTest, Budgets) {
+  for (std::uint64_t max_steps : {1, 5, 11, 12}) {
+    machine_.setLimits({max_steps, 0, std::chrono::milliseconds(0)});
+    expectSameResult("11111");
+  }
+}
+
+TEST_F(RunLengthMachineTest, EndlessSweep) {
+  // Goes to the right forever
+  machine_.addTransition("q2 . q2 . R");
+  machine_.setInitialState("q2");
+
+  machine_.setLimits({1000, 0, std::chrono::milliseconds(0)});
+  expectSameResult("");
+
+  // Without a budget of steps, the blanks are crossed until the time runs out, as on
+  // the search
+  machine_.setLimits({0, 0, std::chrono::milliseconds(20)});
+  for (bool run_length : {true, false}) {
+    machine_.toggleRunLengthTape(run_length);
+    RunResult result = machine_.simulate("");
+
+    ASSERT_EQ(result.verdict, Verdict::Undecided) << run_length;
+    ASSERT_GT(result.steps, 1024) << run_length;
+  }
+}
+
+}  // namespace turing
@@ -0,0 +1,97 @@
+#include <sstream>
+
+#include "core/compiledmachine.hpp"
+#include "core/scanmachine.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class ScanMachineTest : public ::testing::Test {
+protected:
+  // Run crossing the scan loops and step by step (Profiling doesn't cross them), and
+  // check that the results are the same
+  void expectSameResult(const std::string& input) {
+    machine_.toggleProfiling(true);
+    RunResult expected = machine_.simulate(input);
+
+    machine_.toggleProfiling(false);
+    RunResult result = machine_.simulate(input);
+
+    EXPECT_EQ(result.verdict, expected.verdict) << input;
+    EXPECT_EQ(result.steps, expected.steps) << input;
+    EXPECT_EQ(result.depth, expected.depth) << input;
+
+    std::ostringstream expected_tapes, result_tapes;
+    expected_tapes << expected.tapes;
+    result_tapes << result.tapes;
+    EXPECT_EQ(result_tapes.str(), expected_tapes.str()) << input;
+  }
+
+  Turing machine_ = machines::markLastAfterHash();
+};
+
+TEST_F(ScanMachineTest, Scans) {
+  ASSERT_TRUE(ScanMachine::supports(*machine_.compiled()));
+  ASSERT_EQ(ScanMachine(*machine_.compiled()).numScans(), 2);
+
+  // Without loops on the same state, there's nothing to scan
+  Turing machine;
+  machine.addStates({"q0", "q1"});
+  machine.tapeAlphabet().setSymbols({"1"});
+  machine.setInitialState("q0");
+  machine.addTransition("q0 1 q1 1 R");
+  machine.addTransition("q1 1 q0 1 R");
+  ASSERT_FALSE(ScanMachine::supports(*machine.compiled()));
+}
+
+TEST_F(ScanMachineTest, SameResult) {
+  expectSameResult("");
+  expectSameResult("#");
+  expectSameResult("#1");
+  expectSameResult("#0110");
+  expectSameResult("0110");
+  expectSameResult("#" + std::string(1000, '1') + "0");
+  expectSameResult("10#" + std::string(5000, '0'));
+}
+
+TEST_F(ScanMachineTest, Budgets) {
+  machine_.setLimits({50, 0, std::chrono::milliseconds(0)});
+  expectSameResult("#0110");
+  expectSameResult("#" + std::string(100, '1'));
+
+  machine_.setLimits({0, 50, std::chrono::milliseconds(0)});
+  expectSameResult("#" + std::string(100, '1'));
+}
+
+TEST_F(ScanMachineTest, EndlessScan) {
+  // Scan over the blanks to the right, forever
+  machine_.addTransition("q1 # q1 # R");
+  machine_.addTransition("q1 . q1 . R");
+  machine_.setLimits({1000, 0, std::chrono::milliseconds(0)});
+
+  expectSameResult("#");
+
+  RunResult result = machine_.simulate("#");
+  ASSERT_EQ(result.verdict, Verdict::Undecided);
+  ASSERT_EQ(result.steps, 1000);
+}
+
+TEST_F(ScanMachineTest, EndlessScanWithoutSteps) {
+  machine_.addTransition("q1 # q1 # R");
+  machine_.addTransition("q1 . q1 . R");
+  machine_.setLimits({0, 0, std::chrono::milliseconds(20)});
+
+  // Without a budget of steps, the blanks are crossed until the time runs out, as on
+  // the search
+  for (bool profiling : {true, false}) {
+    machine_.toggleProfiling(profiling);
+    RunResult result = machine_.simulate("#");
+
+    ASSERT_EQ(result.verdict, Verdict::Undecided) << profiling;
+    ASSERT_GT(result.steps, 1024) << profiling;
+  }
+}
+
+}  // namespace turing
@@ -0,0 +1,97 @@
+#include <string>
+
+#include "core/staticmachine.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+namespace {
+
+// Mark the 1s, and accept if the input ends with 1. Symbols: blank, 0, 1, X.
+constexpr StaticMachine<3, 4> marker(0,
+                                     {2},
+                                     {{0, 1, 0, 1, Move::Right},
+                                      {0, 2, 1, 3, Move::Right},
+                                      {1, 1, 0, 1, Move::Right},
+                                      {1, 2, 1, 3, Move::Right},
+                                      {1, 0, 2, 0, Move::Left}});
+
+static_assert(marker.numTransitions() == 5, "Table built at compile time");
+static_assert(marker.isFinal(2) && !marker.isFinal(0), "Final states");
+
+}  // namespace
+
+class StaticMachineTest : public ::testing::Test {
+protected:
+  std::vector<SymbolId> ids(const std::string& input) {
+    std::vector<SymbolId> result;
+    for (char c : input) {
+      result.push_back(machine_.tapeAlphabet().id(std::string(1, c)));
+    }
+    return result;
+  }
+
+  Turing machine_ = machines::markOnes();
+};
+
+TEST_F(StaticMachineTest, SameIds) {
+  ASSERT_EQ(machine_.tapeAlphabet().id("0"), 1);
+  ASSERT_EQ(machine_.tapeAlphabet().id("1"), 2);
+  ASSERT_EQ(machine_.tapeAlphabet().id("X"), 3);
+}
+
+TEST_F(StaticMachineTest, SameAsTuring) {
+  for (std::string input : {"", "0", "1", "0101", "1011", "111111", "10"}) {
+    RunResult expected = machine_.simulate(input);
+    StaticResult result = marker.run(ids(input));
+
+    ASSERT_EQ(result.verdict, expected.verdict) << input;
+    ASSERT_EQ(result.steps, expected.steps) << input;
+
+    if (expected.accepted()) {
+      const Tape& tape = expected.tapes[0];
+      ASSERT_EQ(result.head, tape.head()) << input;
+      for (int pos = tape.firstWritten(); pos <= tape.lastWritten(); ++pos) {
+        ASSERT_EQ(result.at(pos), tape.peekId(pos)) << input << " at " << pos;
+      }
+    }
+  }
+}
+
+TEST_F(StaticMachineTest, StepBudget) {
+  StaticResult result = marker.run({2, 2, 2, 2}, 3);
+
+  ASSERT_EQ(result.verdict, Verdict::Undecided);
+  ASSERT_EQ(result.steps, 3);
+  ASSERT_EQ(marker.run({2, 2, 2, 2}, 5).verdict, Verdict::Accepted);
+}
+
+TEST_F(StaticMachineTest, GrowLeft) {
+  // Walk left over blanks until the budget runs out
+  constexpr StaticMachine<1, 1> walker(0, {}, {{0, 0, 0, 0, Move::Left}});
+
+  StaticResult result = walker.run({}, 1000);
+
+  ASSERT_EQ(result.verdict, Verdict::Undecided);
+  ASSERT_EQ(result.head, -1000);
+  ASSERT_EQ(result.at(result.head), 0);
+}
+
+TEST_F(StaticMachineTest, InvalidDefinition) {
+  using Machine = StaticMachine<2, 2>;
+
+  EXPECT_THROW(Machine(2, {}, {}), std::out_of_range);
+  EXPECT_THROW(Machine(0, {}, {{0, 2, 1, 0, Move::Right}}), std::out_of_range);
+  EXPECT_THROW(Machine(0, {}, {{0, 1, 1, 0, Move::Right}, {0, 1, 0, 1, Move::Left}}),
+               std::logic_error);
+}
+
+TEST_F(StaticMachineTest, InvalidInput) {
+  EXPECT_THROW(marker.run({1, 4}), std::out_of_range);
+  EXPECT_THROW(marker.run(std::vector<SymbolId>{5}), std::out_of_range);
+  EXPECT_EQ(marker.run({1, 3}).verdict, Verdict::Rejected);
+}
+
+}  // namespace turing
@@ -0,0 +1,179 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+#include "core/compiledmachine.hpp"
+#include "core/trace.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class TraceTest : public ::testing::Test {
+protected:
+  void TearDown() override { std::remove(file_path_.c_str()); }
+
+  // Run the inputs writing a trace, and check that the replay reaches the same result
+  void expectSameReplay(const std::vector<std::string>& inputs) {
+    std::vector<RunResult> results;
+    {
+      machine_.setTrace(std::make_shared<TraceWriter>(file_path_, *machine_.compiled()));
+      for (const auto& input : inputs) {
+        results.push_back(machine_.simulate(input));
+      }
+      machine_.setTrace(nullptr);
+    }
+
+    TraceReader trace(file_path_);
+    EXPECT_EQ(trace.fingerprint(), machine_.compiled()->fingerprint());
+    EXPECT_EQ(trace.numTapes(), machine_.numTapes());
+
+    for (const auto& result : results) {
+      ASSERT_TRUE(trace.nextRun());
+
+      while (trace.nextStep()) {
+      }
+
+      EXPECT_EQ(trace.verdict(), result.verdict);
+      EXPECT_EQ(trace.steps(), result.steps);
+      ASSERT_EQ(trace.tapes().size(), result.tapes.size());
+
+      // Only accepted runs return the tapes of the last configuration
+      if (result.verdict != Verdict::Accepted) {
+        continue;
+      }
+
+      for (size_t i = 0; i < result.tapes.size(); ++i) {
+        const Tape& tape = trace.tapes()[i];
+        const Tape& expected = result.tapes[i];
+
+        EXPECT_EQ(tape.head(), expected.head());
+        for (int j = expected.firstWritten(); j <= expected.lastWritten(); ++j) {
+          EXPECT_EQ(tape.alphabet().symbol(tape.peekId(j)),
+                    expected.alphabet().symbol(expected.peekId(j)));
+        }
+      }
+    }
+
+    EXPECT_FALSE(trace.nextRun());
+  }
+
+  const std::string file_path_ = ::testing::TempDir() + "turing_trace.bin";
+  Turing machine_ = machines::markOnes();
+};
+
+TEST_F(TraceTest, Deterministic) {
+  expectSameReplay({"0101", "0110", "", "1"});
+}
+
+TEST_F(TraceTest, NonDeterministic) {
+  // Guess where the input ends, going back on the wrong guesses
+  machine_.addTransition("q0 0 q1 0 R");
+  machine_.addTransition("q1 1 q0 1 R");
+  machine_.compile();
+  ASSERT_FALSE(machine_.compiled()->deterministic());
+
+  expectSameReplay({"0101", "0110", "000"});
+}
+
+TEST_F(TraceTest, Steps) {
+  machine_.setTrace(std::make_shared<TraceWriter>(file_path_, *machine_.compiled()));
+  machine_.simulate("011");
+  machine_.setTrace(nullptr);
+
+  TraceReader trace(file_path_);
+  ASSERT_TRUE(trace.nextRun());
+  EXPECT_EQ(trace.stateName(trace.state()), "q0");
+
+  ASSERT_TRUE(trace.nextStep());
+  EXPECT_EQ(trace.stateName(trace.state()), "q0");
+  EXPECT_EQ(trace.tapes()[0].head(), 1);
+
+  ASSERT_TRUE(trace.nextStep());
+  EXPECT_EQ(trace.stateName(trace.state()), "q1");
+  EXPECT_EQ(trace.tapes()[0].peekId(1), trace.tapeAlphabet().id("X"));
+
+  // Transitions are named as in the debug trace
+  EXPECT_EQ(trace.transitionName(trace.lastTransition()),
+            machine_.compiled()->transitionName(trace.lastTransition()));
+}
+
+TEST_F(TraceTest, InvalidFile) {
+  std::ofstream(file_path_) << "not a trace";
+
+  EXPECT_THROW(TraceReader trace(file_path_), std::runtime_error);
+}
+
+TEST_F(TraceTest, FarHead) {
+  std::vector<Tape> tapes(1, Tape(machine_.tapeAlphabet()));
+  tapes[0].setInputString("01", machine_.inputAlphabet());
+  tapes[0].seek(1 << 30);
+
+  {
+    TraceWriter writer(file_path_, *machine_.compiled());
+    writer.beginRun(*machine_.compiled(), tapes);
+    writer.endRun(RunResult());
+  }
+
+  // The head is placed at once, not walked cell by cell
+  TraceReader trace(file_path_);
+  ASSERT_TRUE(trace.nextRun());
+  EXPECT_EQ(trace.tapes()[0].head(), 1 << 30);
+  EXPECT_EQ(trace.tapes()[0].peekId(1), machine_.tapeAlphabet().id("1"));
+}
+
+TEST_F(TraceTest, CorruptFile) {
+  machine_.setTrace(std::make_shared<TraceWriter>(file_path_, *machine_.compiled()));
+  machine_.simulate("0101");
+  machine_.simulate("011");
+  machine_.setTrace(nullptr);
+
+  std::string trace_bytes;
+  {
+    std::ifstream file(file_path_, std::ios::binary);
+    trace_bytes.assign(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+  }
+
+  auto replay = [this](const std::string& bytes) {
+    std::ofstream(file_path_, std::ios::binary | std::ios::trunc) << bytes;
+
+    TraceReader trace(file_path_);
+    while (trace.nextRun()) {
+    }
+  };
+
+  replay(trace_bytes);
+
+  // A truncated file throws instead of ending the last run
+  EXPECT_THROW(replay(trace_bytes.substr(0, trace_bytes.size() - 1)),
+               std::runtime_error);
+
+  // The last step is: transition, state, symbol read, symbol written and move. Then
+  // the End record takes 3 bytes.
+  for (size_t offset : {8, 7, 6, 5, 4}) {
+    std::string bytes = trace_bytes;
+    bytes[bytes.size() - offset] = 0x7f;
+    EXPECT_THROW(replay(bytes), std::runtime_error) << offset;
+  }
+
+  // Any change of a byte is either a valid trace, or throws
+  size_t corrupt = 0;
+  for (size_t i = 0; i < trace_bytes.size(); ++i) {
+    for (char byte : {char(0x07), char(trace_bytes[i] ^ 0x80)}) {
+      std::string bytes = trace_bytes;
+      bytes[i] = byte;
+
+      try {
+        replay(bytes);
+      } catch (const std::runtime_error&) {
+        ++corrupt;
+      }
+    }
+  }
+  EXPECT_GT(corrupt, 0);
+}
+
+}  // namespace turing
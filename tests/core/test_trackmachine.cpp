@@ -0,0 +1,69 @@
+#include <sstream>
+
+#include "core/compiledmachine.hpp"
+#include "core/trackmachine.hpp"
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+#include "machines.hpp"
+
+namespace turing {
+
+class TrackMachineTest : public ::testing::Test {
+protected:
+  // Run on the track tape and step by step (Profiling doesn't use the track tape), and
+  // check that the results are the same
+  void expectSameResult(const std::string& input) {
+    machine_.toggleProfiling(true);
+    RunResult expected = machine_.simulate(input);
+
+    machine_.toggleProfiling(false);
+    RunResult result = machine_.simulate(input);
+
+    EXPECT_EQ(result.verdict, expected.verdict);
+    EXPECT_EQ(result.steps, expected.steps);
+    EXPECT_EQ(result.depth, expected.depth);
+
+    std::ostringstream expected_tapes, result_tapes;
+    expected_tapes << expected.tapes;
+    result_tapes << result.tapes;
+    EXPECT_EQ(result_tapes.str(), expected_tapes.str());
+  }
+
+  Turing machine_ = machines::copyInput();
+};
+
+TEST_F(TrackMachineTest, Supports) {
+  std::vector<Tape> tapes = machine_.tapes();
+  ASSERT_TRUE(machine_.compiled()->uniformMoves());
+  ASSERT_TRUE(TrackMachine::supports(*machine_.compiled(), tapes));
+
+  // Heads on different cells
+  tapes[1].move(Move::Right);
+  ASSERT_FALSE(TrackMachine::supports(*machine_.compiled(), tapes));
+
+  // A head that moves on its own
+  machine_.addTransition("q1 0 1 q1 0 1 L S");
+  ASSERT_FALSE(machine_.compiled()->uniformMoves());
+}
+
+TEST_F(TrackMachineTest, SameResult) {
+  expectSameResult("");
+  expectSameResult("0");
+  expectSameResult("0110");
+  expectSameResult(std::string(2000, '1'));
+
+  // Rejected when it's back at the start
+  machine_.setFinalStates({});
+  expectSameResult("0110");
+}
+
+TEST_F(TrackMachineTest, Budgets) {
+  machine_.setLimits({10, 0, std::chrono::milliseconds(0)});
+  expectSameResult("0110");
+  expectSameResult(std::string(20, '0'));
+
+  machine_.setLimits({0, 10, std::chrono::milliseconds(0)});
+  expectSameResult(std::string(20, '0'));
+}
+
+}  // namespace turing
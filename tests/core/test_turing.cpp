@@ -0,0 +1,216 @@
+#include <limits>
+
+#include "core/turing.hpp"
+#include "gtest/gtest.h"
+
+namespace turing {
+
+class TuringTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    machine_.addStates({"q0", "q1"});
+    machine_.inputAlphabet().setSymbols({"0", "1"});
+    machine_.tapeAlphabet().setSymbols({"0", "1", "."});
+    machine_.setInitialState("q0");
+    machine_.setFinalStates({"q1"});
+    machine_.toggleDebugMode(false);
+
+    // Walk over the 1s. Accept if the input ends with a blank. Loop forever on a 0.
+    machine_.addTransition("q0 1 q0 1 R");
+    machine_.addTransition("q0 . q1 . S");
+    machine_.addTransition("q0 0 q0 0 S");
+  }
+
+  Turing machine_;
+};
+
+TEST_F(TuringTest, Accept) {
+  ASSERT_EQ(machine_.run("111"), Verdict::Accepted);
+}
+
+TEST_F(TuringTest, Reject) {
+  machine_.addState("q2");
+  machine_.setInitialState("q2");
+
+  ASSERT_EQ(machine_.run("111"), Verdict::Rejected);
+}
+
+TEST_F(TuringTest, StateIds) {
+  // Ids are given in the order the states are added
+  machine_.addState("a");
+
+  EXPECT_EQ(machine_.numStates(), 3);
+  EXPECT_EQ(machine_.stateId("q0"), 0);
+  EXPECT_EQ(machine_.stateId("a"), 2);
+  EXPECT_EQ(machine_.stateName(1), "q1");
+  EXPECT_EQ(machine_.initialState(), machine_.stateId("q0"));
+  EXPECT_TRUE(machine_.state(machine_.stateId("q1")).isFinal());
+
+  EXPECT_THROW(machine_.stateId("q3"), std::runtime_error);
+
+  // Duplicated and empty names aren't added
+  machine_.addStates({"q0", ""});
+  EXPECT_EQ(machine_.numStates(), 3);
+}
+
+TEST_F(TuringTest, Move) {
+  RunResult expected = machine_.simulate("111");
+  machine_.compile();
+
+  // The tapes, transitions and compiled machine keep working after the move
+  Turing moved = std::move(machine_);
+  RunResult result = moved.simulate("111");
+
+  EXPECT_EQ(result.verdict, expected.verdict);
+  EXPECT_EQ(result.steps, expected.steps);
+  EXPECT_EQ(moved.tapes()[0].peek(), moved.tapeAlphabet().symbol(Alphabet::blank_id));
+  EXPECT_EQ(moved.stateName(moved.initialState()), "q0");
+
+  machine_ = std::move(moved);
+  machine_.setFinalStates({"q0"});
+  EXPECT_EQ(machine_.run("0"), Verdict::Accepted);
+}
+
+TEST_F(TuringTest, LongRun) {
+  // Would overflow the native stack with a recursive implementation
+  std::string input(500000, '1');
+
+  RunResult result = machine_.simulate(input);
+
+  ASSERT_EQ(result.verdict, Verdict::Accepted);
+  ASSERT_EQ(result.steps, input.size() + 1);
+}
+
+TEST(LimitsTest, DeterministicSteps) {
+  using std::chrono::milliseconds;
+
+  EXPECT_EQ((Limits{0, 0, milliseconds(0)}).deterministicSteps(),
+            std::numeric_limits<std::uint64_t>::max());
+  EXPECT_EQ((Limits{100, 0, milliseconds(0)}).deterministicSteps(), 100);
+  EXPECT_EQ((Limits{0, 50, milliseconds(0)}).deterministicSteps(), 50);
+  EXPECT_EQ((Limits{100, 50, milliseconds(0)}).deterministicSteps(), 50);
+  EXPECT_EQ((Limits{50, 100, milliseconds(0)}).deterministicSteps(), 50);
+}
+
+TEST_F(TuringTest, StepBudget) {
+  machine_.setLimits({100, 0, std::chrono::milliseconds(0)});
+
+  ASSERT_EQ(machine_.run("110"), Verdict::Undecided);
+  ASSERT_EQ(machine_.run("11"), Verdict::Accepted);
+}
+
+TEST_F(TuringTest, DepthBudget) {
+  machine_.setLimits({0, 10, std::chrono::milliseconds(0)});
+
+  ASSERT_EQ(machine_.run("110"), Verdict::Undecided);
+  ASSERT_EQ(machine_.run(std::string(20, '1')), Verdict::Undecided);
+  ASSERT_EQ(machine_.run("11"), Verdict::Accepted);
+}
+
+TEST_F(TuringTest, TimeBudget) {
+  machine_.setLimits({0, 0, std::chrono::milliseconds(50)});
+
+  ASSERT_EQ(machine_.run("0"), Verdict::Undecided);
+}
+
+TEST_F(TuringTest, BreadthFirstCycle) {
+  machine_.setSearchMode(SearchMode::BreadthFirst);
+
+  // Depth-first would loop forever on the "0"
+  ASSERT_EQ(machine_.run("110"), Verdict::Rejected);
+  ASSERT_EQ(machine_.run("11"), Verdict::Accepted);
+}
+
+TEST_F(TuringTest, BreadthFirstShortest) {
+  machine_.setSearchMode(SearchMode::BreadthFirst);
+
+  // Cycles on every 1, and a long detour to the final state on the first one
+  machine_.addStates({"q2", "q3"});
+  machine_.addTransition("q0 1 q0 1 S");
+  machine_.addTransition("q0 1 q2 1 R");
+  machine_.addTransition("q2 1 q3 1 L");
+  machine_.addTransition("q3 1 q0 1 R");
+
+  RunResult result = machine_.simulate("111");
+
+  ASSERT_EQ(result.verdict, Verdict::Accepted);
+  ASSERT_EQ(result.depth, 4);
+}
+
+TEST_F(TuringTest, BreadthFirstDepthBudget) {
+  machine_.setSearchMode(SearchMode::BreadthFirst);
+  machine_.setLimits({0, 2, std::chrono::milliseconds(0)});
+
+  ASSERT_EQ(machine_.run("111"), Verdict::Undecided);
+  ASSERT_EQ(machine_.run("1"), Verdict::Accepted);
+}
+
+TEST_F(TuringTest, ParallelAccept) {
+  machine_.setSearchMode(SearchMode::Parallel);
+  machine_.setSearchThreads(4);
+
+  // Branch on every 1 to a dead end
+  machine_.addState("q2");
+  machine_.addTransition("q0 1 q2 0 R");
+
+  RunResult result = machine_.simulate(std::string(1000, '1'));
+
+  ASSERT_EQ(result.verdict, Verdict::Accepted);
+  ASSERT_EQ(result.depth, 1001);
+  ASSERT_EQ(result.tapes[0].peek(), ".");
+}
+
+TEST_F(TuringTest, ParallelReject) {
+  machine_.setSearchMode(SearchMode::Parallel);
+  machine_.setSearchThreads(4);
+
+  // Two branches on every 1, none of them reaches the final state
+  machine_.addStates({"q2", "q3"});
+  machine_.addTransition("q2 1 q2 1 R");
+  machine_.addTransition("q2 1 q3 1 R");
+  machine_.addTransition("q3 1 q2 1 R");
+  machine_.addTransition("q3 1 q3 1 R");
+  machine_.setInitialState("q2");
+
+  ASSERT_EQ(machine_.run("1111111111"), Verdict::Rejected);
+}
+
+TEST_F(TuringTest, ParallelBudget) {
+  machine_.setSearchMode(SearchMode::Parallel);
+  machine_.setSearchThreads(4);
+  machine_.setLimits({10000, 0, std::chrono::milliseconds(0)});
+
+  ASSERT_EQ(machine_.run("110"), Verdict::Undecided);
+  ASSERT_EQ(machine_.run("11"), Verdict::Accepted);
+
+  machine_.setLimits({0, 10, std::chrono::milliseconds(0)});
+
+  ASSERT_EQ(machine_.run("110"), Verdict::Undecided);
+}
+
+TEST_F(TuringTest, ParallelExactBudget) {
+  // Two branches on every 1, none of them reaches the final state
+  machine_.addStates({"q2", "q3"});
+  machine_.addTransition("q2 1 q2 1 R");
+  machine_.addTransition("q2 1 q3 1 R");
+  machine_.addTransition("q3 1 q2 1 R");
+  machine_.addTransition("q3 1 q3 1 R");
+  machine_.setInitialState("q2");
+
+  std::string input(7, '1');
+  std::uint64_t steps = machine_.simulate(input).steps;
+
+  // The whole tree fits in the budget, as in the depth-first search
+  for (SearchMode mode : {SearchMode::DepthFirst, SearchMode::Parallel}) {
+    machine_.setSearchMode(mode);
+    machine_.setSearchThreads(4);
+
+    machine_.setLimits({steps, 0, std::chrono::milliseconds(0)});
+    EXPECT_EQ(machine_.run(input), Verdict::Rejected);
+
+    machine_.setLimits({steps - 1, 0, std::chrono::milliseconds(0)});
+    EXPECT_EQ(machine_.run(input), Verdict::Undecided);
+  }
+}
+
+}  // namespace turing
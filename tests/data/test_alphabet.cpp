@@ -50,10 +50,39 @@ TEST_F(AlphabetTest, UnrecognizedSymbols) {
   ASSERT_EQ(symbols[1], "b");
 }
 
+TEST_F(AlphabetTest, Diagnostics) {
+  Diagnostics diagnostics(1);
+
+  auto symbols = alphabet_.splitInSymbols("a01b2c", &diagnostics);
+
+  ASSERT_EQ(symbols.size(), 3);
+  ASSERT_EQ(diagnostics.count(), 2);
+  ASSERT_EQ(diagnostics.dropped(), 1);
+  ASSERT_EQ(diagnostics.messages()[0], "Unrecognized symbol: 01");
+}
+
+TEST_F(AlphabetTest, LongestMatch) {
+  alphabet_.setSymbols({"a", "ab", "abc", "b", "+", "(.)"});
+
+  auto symbols = alphabet_.splitInSymbols("abcaba+(.)(b");
+
+  std::vector<Symbol> expected{"abc", "ab", "a", "+", "(.)", "b"};
+  ASSERT_EQ(symbols, expected);
+}
+
+TEST_F(AlphabetTest, SplitInIds) {
+  auto ids = alphabet_.splitInIds("cab");
+
+  ASSERT_EQ(ids.size(), 3);
+  ASSERT_EQ(ids[0], alphabet_.id("c"));
+  ASSERT_EQ(ids[2], alphabet_.id("b"));
+}
+
 TEST_F(AlphabetTest, AddSymbol) {
   alphabet_.addSymbol("d");
 
   ASSERT_EQ(alphabet_.size(), 4);
+  ASSERT_EQ(alphabet_.splitInSymbols("dad").size(), 3);
 }
 
 TEST_F(AlphabetTest, SetSymbols) {
@@ -66,10 +95,24 @@ TEST_F(AlphabetTest, SetSymbols) {
   ASSERT_EQ(symbols[1], "Y");
 }
 
+TEST_F(AlphabetTest, SymbolIds) {
+  ASSERT_EQ(alphabet_.numIds(), 4);
+  ASSERT_EQ(alphabet_.id(alphabet_.blank()), Alphabet::blank_id);
+
+  for (const auto& symbol : {"a", "b", "c"}) {
+    ASSERT_NE(alphabet_.id(symbol), Alphabet::blank_id);
+    ASSERT_EQ(alphabet_.symbol(alphabet_.id(symbol)), symbol);
+  }
+
+  ASSERT_THROW({ alphabet_.id("1"); }, std::runtime_error);
+}
+
 TEST_F(AlphabetTest, SetBlank) {
   alphabet_.setBlank("z");
 
   ASSERT_EQ(alphabet_.blank(), "z");
+  ASSERT_EQ(alphabet_.id("z"), Alphabet::blank_id);
+  ASSERT_THROW({ alphabet_.id("."); }, std::runtime_error);
 }
 
 TEST_F(AlphabetTest, SetExistentBlank) {
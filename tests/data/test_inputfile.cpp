@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include "data/inputfile.hpp"
+#include "data/tape.hpp"
+#include "gtest/gtest.h"
+
+namespace turing {
+
+class InputFileTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    alphabet_.setSymbols({"0", "1"});
+    file_path_ = ::testing::TempDir() + "turing_input.txt";
+  }
+
+  void TearDown() override { std::remove(file_path_.c_str()); }
+
+  std::shared_ptr<const InputFile> write(const std::string& contents) {
+    std::ofstream(file_path_, std::ios::binary) << contents;
+    return std::make_shared<const InputFile>(file_path_);
+  }
+
+  std::string print(const Tape& tape) {
+    std::ostringstream os;
+    os << tape;
+    return os.str();
+  }
+
+  Alphabet alphabet_;
+  std::string file_path_;
+};
+
+TEST_F(InputFileTest, Contents) {
+  auto input = write("0110\n");
+
+  ASSERT_EQ(input->size(), 4);
+  ASSERT_EQ(std::string(input->data(), input->size()), "0110");
+  ASSERT_EQ(write("")->size(), 0);
+}
+
+TEST_F(InputFileTest, SameAsInputString) {
+  // Longer than a page of the Tape
+  std::string contents;
+  for (int i = 0; i < 3000; ++i) {
+    contents += (i % 3) ? "1" : "0";
+  }
+
+  Tape expected(alphabet_);
+  expected.setInputString(contents, alphabet_);
+
+  Tape tape(alphabet_);
+  tape.setInputFile(write(contents), alphabet_);
+
+  ASSERT_TRUE(tape.hasInputFile());
+  ASSERT_EQ(tape.firstWritten(), expected.firstWritten());
+  ASSERT_EQ(tape.lastWritten(), expected.lastWritten());
+  ASSERT_EQ(print(tape), print(expected));
+
+  // Read and write through the pages, as a machine does
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_EQ(tape.peekId(), expected.peekId()) << i;
+    if (i % 7 == 0) {
+      tape.writeId(alphabet_.id("1"));
+      expected.writeId(alphabet_.id("1"));
+    }
+    tape.move(Move::Right);
+    expected.move(Move::Right);
+  }
+
+  ASSERT_EQ(print(tape), print(expected));
+}
+
+TEST_F(InputFileTest, Copies) {
+  Tape tape(alphabet_);
+  tape.setInputFile(write("0000"), alphabet_);
+
+  // Copies share the input, but not the writes
+  Tape copy(tape);
+  copy.writeId(alphabet_.id("1"));
+
+  ASSERT_EQ(tape.peekId(), alphabet_.id("0"));
+  ASSERT_EQ(copy.peekId(), alphabet_.id("1"));
+  ASSERT_EQ(copy.peekId(1), alphabet_.id("0"));
+
+  // Setting another input drops the file
+  tape.setInputString("1", alphabet_);
+  ASSERT_FALSE(tape.hasInputFile());
+  ASSERT_EQ(tape.peekId(1), Alphabet::blank_id);
+}
+
+TEST_F(InputFileTest, InvalidInput) {
+  Tape tape(alphabet_);
+  ASSERT_THROW(tape.setInputFile(write("0120"), alphabet_, true), std::runtime_error);
+
+  // Unless the whole file is checked, unknown characters are found when they are read
+  std::string contents(2000, '0');
+  contents[1500] = '2';
+  tape.setInputFile(write(contents), alphabet_);
+
+  Diagnostics diagnostics;
+  tape.reportInput(diagnostics);
+  ASSERT_TRUE(diagnostics.empty());
+
+  Tape copy(tape);
+  ASSERT_EQ(copy.peekId(1500), Alphabet::blank_id);
+  tape.reportInput(diagnostics);
+  ASSERT_EQ(diagnostics.count(), 1);
+  ASSERT_NE(diagnostics.messages()[0].find("at 1500"), std::string::npos);
+
+  Alphabet long_symbols;
+  long_symbols.setSymbols({"0", "10"});
+  ASSERT_THROW(tape.setInputFile(write("0100"), long_symbols), std::runtime_error);
+
+  ASSERT_THROW(InputFile(file_path_ + ".missing"), std::runtime_error);
+}
+
+}  // namespace turing
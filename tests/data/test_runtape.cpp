@@ -0,0 +1,93 @@
+#include <sstream>
+
+#include "data/runtape.hpp"
+#include "gtest/gtest.h"
+
+namespace turing {
+
+class RunTapeTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    alphabet_.setSymbols({"0", "1"});
+
+    tape_ = Tape(alphabet_);
+    tape_.setInputString("1111011", alphabet_);
+  }
+
+  // Print the Tape after copying the runs to it
+  std::string print(const RunTape& runs) {
+    Tape tape(tape_);
+    runs.writeTo(tape);
+
+    std::ostringstream os;
+    os << tape;
+    return os.str();
+  }
+
+  Tape tape_;
+  Alphabet alphabet_;
+};
+
+TEST_F(RunTapeTest, Runs) {
+  RunTape runs(tape_);
+
+  // "1111" without the head, "0" and "11"
+  ASSERT_EQ(runs.numRuns(), 3);
+  ASSERT_EQ(runs.peekId(), alphabet_.id("1"));
+  ASSERT_EQ(runs.runLength(Move::Right), 4);
+  ASSERT_EQ(runs.runLength(Move::Left), 1);
+}
+
+TEST_F(RunTapeTest, Move) {
+  RunTape runs(tape_);
+
+  for (int i = 0; i < 4; ++i) {
+    runs.move(Move::Right);
+  }
+  ASSERT_EQ(runs.head(), 4);
+  ASSERT_EQ(runs.peekId(), alphabet_.id("0"));
+
+  runs.move(Move::Left);
+  ASSERT_EQ(runs.peekId(), alphabet_.id("1"));
+  ASSERT_EQ(runs.runLength(Move::Left), 4);
+}
+
+TEST_F(RunTapeTest, Sweep) {
+  RunTape runs(tape_);
+
+  runs.sweep(alphabet_.id("0"), Move::Right, runs.runLength(Move::Right));
+  ASSERT_EQ(runs.head(), 4);
+
+  // "00000" on the left of the head
+  ASSERT_EQ(runs.runLength(Move::Right), 1);
+  runs.move(Move::Left);
+  ASSERT_EQ(runs.runLength(Move::Left), 4);
+
+  // Same tape as writing cell by cell
+  Tape expected(tape_);
+  for (int i = 0; i < 4; ++i) {
+    expected.writeId(alphabet_.id("0"));
+    expected.move(Move::Right);
+  }
+  expected.move(Move::Left);
+
+  std::ostringstream os;
+  os << expected;
+  ASSERT_EQ(print(runs), os.str());
+}
+
+TEST_F(RunTapeTest, Unbounded) {
+  RunTape runs(tape_);
+  runs.move(Move::Left);
+
+  ASSERT_EQ(runs.peekId(), Alphabet::blank_id);
+  ASSERT_EQ(runs.runLength(Move::Left), RunTape::unbounded);
+  ASSERT_EQ(runs.runLength(Move::Right), 1);
+
+  // Blanks far from the input are written back as blanks
+  runs.sweep(Alphabet::blank_id, Move::Left, 1000);
+  ASSERT_EQ(runs.head(), -1001);
+  ASSERT_EQ(runs.runLength(Move::Right), 1001);
+}
+
+}  // namespace turing
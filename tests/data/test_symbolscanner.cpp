@@ -0,0 +1,89 @@
+#include <vector>
+
+#include "data/symbolscanner.hpp"
+#include "gtest/gtest.h"
+
+namespace turing {
+
+namespace {
+
+// Reference spans, cell by cell
+size_t spanRight(const std::vector<SymbolId>& cells, const SymbolScanner& scanner) {
+  size_t span = 0;
+  while (span < cells.size() && scanner.contains(cells[span])) {
+    ++span;
+  }
+  return span;
+}
+
+size_t spanLeft(const std::vector<SymbolId>& cells, const SymbolScanner& scanner) {
+  size_t span = 0;
+  while (span < cells.size() && scanner.contains(cells[cells.size() - span - 1])) {
+    ++span;
+  }
+  return span;
+}
+
+}  // namespace
+
+TEST(SymbolScannerTest, Contains) {
+  SymbolScanner scanner({1, 3, 3});
+
+  ASSERT_TRUE(scanner.contains(1));
+  ASSERT_TRUE(scanner.contains(3));
+  ASSERT_FALSE(scanner.contains(0));
+  ASSERT_FALSE(scanner.contains(2));
+  ASSERT_FALSE(scanner.contains(1000));
+}
+
+TEST(SymbolScannerTest, InstructionSet) {
+  // Too many symbols to compare them with vector instructions
+  std::vector<SymbolId> symbols;
+  for (SymbolId id = 0; id <= SymbolScanner::max_vector_symbols; ++id) {
+    symbols.push_back(id);
+  }
+
+  ASSERT_EQ(SymbolScanner(symbols).instructionSet(),
+            SymbolScanner::InstructionSet::Scalar);
+  ASSERT_EQ(SymbolScanner().instructionSet(), SymbolScanner::InstructionSet::Scalar);
+}
+
+TEST(SymbolScannerTest, Spans) {
+  // Every length around the blocks, with the end of the span on each cell
+  for (std::vector<SymbolId> symbols : {std::vector<SymbolId>{1},
+                                        std::vector<SymbolId>{1, 2},
+                                        std::vector<SymbolId>{0, 1, 2, 3, 4, 5}}) {
+    SymbolScanner scanner(symbols);
+
+    for (size_t size = 0; size < 70; ++size) {
+      for (size_t stop = 0; stop <= size; ++stop) {
+        std::vector<SymbolId> cells(size, 1);
+        if (stop < size) {
+          cells[stop] = 7;
+        }
+
+        ASSERT_EQ(scanner.spanRight(cells.data(), size), spanRight(cells, scanner))
+            << size << " " << stop;
+        ASSERT_EQ(scanner.spanLeft(cells.data(), size), spanLeft(cells, scanner))
+            << size << " " << stop;
+      }
+    }
+  }
+}
+
+TEST(SymbolScannerTest, MixedSymbols) {
+  SymbolScanner scanner({1, 2});
+
+  std::vector<SymbolId> cells;
+  for (int i = 0; i < 100; ++i) {
+    cells.push_back(1 + i % 2);
+  }
+  cells[37] = 0;
+  cells[90] = 3;
+
+  ASSERT_EQ(scanner.spanRight(cells.data(), cells.size()), 37);
+  ASSERT_EQ(scanner.spanLeft(cells.data(), cells.size()), 9);
+  ASSERT_EQ(scanner.spanRight(cells.data() + 38, 52), 52);
+}
+
+}  // namespace turing
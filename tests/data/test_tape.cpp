@@ -46,6 +46,20 @@ TEST_F(SimpleTapeTest, Move) {
   ASSERT_EQ(tape_.peek(), tape_.alphabet().blank());
 }
 
+TEST_F(SimpleTapeTest, Seek) {
+  tape_.seek(1);
+  ASSERT_EQ(tape_.peek(), "B");
+
+  tape_.seek(1 << 30);
+  ASSERT_EQ(tape_.head(), 1 << 30);
+  ASSERT_EQ(tape_.peek(), tape_.alphabet().blank());
+
+  tape_.write("C");
+  tape_.seek(0);
+  ASSERT_EQ(tape_.peek(), "A");
+  ASSERT_EQ(tape_.lastWritten(), 1 << 30);
+}
+
 TEST_F(SimpleTapeTest, Reset) {
   tape_.reset();
 }
@@ -67,6 +81,92 @@ TEST_F(SimpleTapeTest, WriteCorrectSymbol) {
   ASSERT_EQ(tape_.peek(), "C");
 }
 
+TEST_F(SimpleTapeTest, SymbolIds) {
+  ASSERT_EQ(tape_.peekId(), tape_alphabet_.id("A"));
+
+  tape_.writeId(tape_alphabet_.id("B"));
+  ASSERT_EQ(tape_.peek(), "B");
+
+  tape_.move(Move::Left);
+  ASSERT_EQ(tape_.peekId(), Alphabet::blank_id);
+}
+
+TEST_F(SimpleTapeTest, GrowBothSides) {
+  // Write far away from the initial buffer on both sides
+  for (int i = 0; i < 1000; ++i) {
+    tape_.move(Move::Left);
+  }
+  tape_.write("C");
+
+  for (int i = 0; i < 3000; ++i) {
+    tape_.move(Move::Right);
+  }
+  tape_.write("B");
+
+  for (int i = 0; i < 2000; ++i) {
+    tape_.move(Move::Left);
+  }
+  ASSERT_EQ(tape_.peek(), "A");
+
+  tape_.move(Move::Right);
+  ASSERT_EQ(tape_.peek(), "B");
+
+  tape_.reset();
+  ASSERT_TRUE(tape_.empty());
+  ASSERT_EQ(tape_.peek(), tape_.alphabet().blank());
+}
+
+TEST_F(SimpleTapeTest, CopyOnWrite) {
+  Tape copy(tape_);
+
+  // Writing on the copy doesn't modify the original and viceversa
+  copy.write("C");
+  ASSERT_EQ(copy.peek(), "C");
+  ASSERT_EQ(tape_.peek(), "A");
+
+  tape_.move(Move::Right);
+  tape_.write("A");
+  copy.move(Move::Right);
+  ASSERT_EQ(copy.peek(), "B");
+  ASSERT_EQ(tape_.peek(), "A");
+
+  // Copies of copies are also independent
+  Tape copy_of_copy(copy);
+  for (int i = 0; i < 2000; ++i) {
+    copy_of_copy.move(Move::Right);
+  }
+  copy_of_copy.write("A");
+
+  for (int i = 0; i < 2000; ++i) {
+    copy.move(Move::Right);
+  }
+  ASSERT_EQ(copy.peek(), tape_.alphabet().blank());
+  ASSERT_EQ(copy_of_copy.peek(), "A");
+}
+
+TEST_F(SimpleTapeTest, Equivalent) {
+  // Same symbols around the head, but on different positions
+  Tape shifted(tape_alphabet_);
+  shifted.move(Move::Left);
+  shifted.write("A");
+  shifted.move(Move::Right);
+  shifted.write("B");
+  shifted.move(Move::Left);
+
+  ASSERT_TRUE(tape_.equivalent(shifted));
+  ASSERT_EQ(tape_.hash(), shifted.hash());
+
+  // Written blanks are the same as not written cells
+  shifted.move(Move::Left);
+  shifted.write(tape_alphabet_.blank());
+  shifted.move(Move::Right);
+  ASSERT_TRUE(tape_.equivalent(shifted));
+
+  // Different position of the head
+  shifted.move(Move::Right);
+  ASSERT_FALSE(tape_.equivalent(shifted));
+}
+
 TEST_F(SimpleTapeTest, WriteIncorrectSymbol) {
   ASSERT_EQ(tape_.peek(), "A");
 
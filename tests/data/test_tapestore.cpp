@@ -0,0 +1,111 @@
+#include <sstream>
+
+#include "data/tapestore.hpp"
+#include "gtest/gtest.h"
+
+namespace turing {
+
+class TapeStoreTest : public ::testing::Test {
+protected:
+  void SetUp() override { alphabet_.setSymbols({"0", "1"}); }
+
+  static std::string print(const Tape& tape) {
+    std::ostringstream os;
+    os << tape;
+    return os.str();
+  }
+
+  Alphabet alphabet_;
+};
+
+TEST_F(TapeStoreTest, SameTapes) {
+  Tape tape(alphabet_);
+  tape.setInputString("0110", alphabet_);
+  for (int i = 0; i < 2000; ++i) {
+    tape.move(Move::Left);
+  }
+  tape.writeId(alphabet_.id("1"));
+
+  std::stringstream data;
+  TapeStore writer;
+  writer.write(data, tape);
+  writer.write(data, Tape(alphabet_));
+
+  TapeStore reader(alphabet_);
+  Tape read = reader.read(data);
+  Tape blank = reader.read(data);
+
+  EXPECT_EQ(read.head(), tape.head());
+  EXPECT_EQ(read.firstWritten(), tape.firstWritten());
+  EXPECT_EQ(read.lastWritten(), tape.lastWritten());
+  EXPECT_EQ(read.peekId(), tape.peekId());
+  EXPECT_EQ(print(read), print(tape));
+  EXPECT_TRUE(blank.empty());
+
+  // The tapes read can be written as usual
+  read.writeId(alphabet_.id("0"));
+  EXPECT_EQ(read.peekId(), alphabet_.id("0"));
+}
+
+TEST_F(TapeStoreTest, SharedPages) {
+  Tape tape(alphabet_);
+  tape.setInputString(std::string(5000, '1'), alphabet_);
+
+  // Each copy writes a single page
+  std::vector<Tape> copies(10, tape);
+  for (size_t i = 0; i < copies.size(); ++i) {
+    copies[i].writeId(alphabet_.id("0"));
+    copies[i].move(Move::Right);
+  }
+
+  std::stringstream data;
+  TapeStore writer;
+  for (const auto& copy : copies) {
+    writer.write(data, copy);
+  }
+
+  // The pages of the input are stored once
+  EXPECT_EQ(writer.numPages(), 10 + 9);
+
+  TapeStore reader(alphabet_);
+  for (const auto& copy : copies) {
+    Tape read = reader.read(data);
+    EXPECT_EQ(print(read), print(copy));
+  }
+  EXPECT_EQ(reader.numPages(), writer.numPages());
+}
+
+TEST_F(TapeStoreTest, InvalidData) {
+  std::stringstream data("short");
+  TapeStore reader(alphabet_);
+  EXPECT_THROW(reader.read(data), std::runtime_error);
+
+  std::stringstream tape_data;
+  TapeStore writer;
+  writer.write(tape_data, Tape(alphabet_));
+  EXPECT_THROW(writer.read(tape_data), std::logic_error);
+
+  // Head, first and last written cells, offset and number of pages of the table
+  Tape tape(alphabet_);
+  tape.setInputString("0110", alphabet_);
+  std::stringstream valid;
+  writer.write(valid, tape);
+
+  auto corrupt = [&valid](size_t offset, std::int32_t value) {
+    std::string bytes = valid.str();
+    bytes.replace(offset, sizeof(value), reinterpret_cast<const char*>(&value),
+                  sizeof(value));
+    return std::stringstream(bytes);
+  };
+
+  std::stringstream pages = corrupt(16, -1);
+  EXPECT_THROW(reader.read(pages), std::runtime_error);
+
+  std::stringstream last = corrupt(8, 1 << 30);
+  EXPECT_THROW(reader.read(last), std::runtime_error);
+
+  std::stringstream first = corrupt(4, 5);
+  EXPECT_THROW(reader.read(first), std::runtime_error);
+}
+
+}  // namespace turing
@@ -0,0 +1,153 @@
+#include <sstream>
+
+#include "data/tracktape.hpp"
+#include "gtest/gtest.h"
+
+namespace turing {
+
+class TrackTapeTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    alphabet_.setSymbols({"0", "1"});
+
+    tapes_ = std::vector<Tape>(2, Tape(alphabet_));
+    tapes_[0].setInputString("0110", alphabet_);
+  }
+
+  // Print the Tapes after copying the tracks to them
+  std::string print(const TrackTape& tracks) {
+    std::vector<Tape> tapes(tapes_);
+    tracks.writeTo(tapes);
+
+    std::ostringstream os;
+    os << tapes;
+    return os.str();
+  }
+
+  std::vector<SymbolId> ids(const std::vector<Symbol>& symbols) {
+    std::vector<SymbolId> result;
+    for (const auto& symbol : symbols) {
+      result.push_back(alphabet_.id(symbol));
+    }
+    return result;
+  }
+
+  Alphabet alphabet_;
+  std::vector<Tape> tapes_;
+};
+
+TEST_F(TrackTapeTest, Keys) {
+  TrackTape tracks(tapes_, alphabet_.numIds());
+
+  ASSERT_EQ(tracks.numTracks(), 2);
+  ASSERT_EQ(tracks.peekId(0), alphabet_.id("0"));
+  ASSERT_EQ(tracks.peekId(1), Alphabet::blank_id);
+
+  // Numbered as the configurations of the compiled machine
+  ASSERT_EQ(tracks.peekKey(), alphabet_.id("0") * alphabet_.numIds());
+  ASSERT_EQ(tracks.peekKey(), tracks.key(ids({"0", "."}).data()));
+}
+
+TEST_F(TrackTapeTest, Write) {
+  TrackTape tracks(tapes_, alphabet_.numIds());
+
+  for (int i = 0; i < 4; ++i) {
+    SymbolId symbol = tracks.peekId(0);
+    std::vector<SymbolId> written{symbol, symbol};
+
+    tracks.write(tracks.key(written.data()), written.data());
+    tracks.move(Move::Right);
+  }
+
+  ASSERT_EQ(tracks.head(), 4);
+  ASSERT_EQ(tracks.peekKey(), 0);
+
+  std::vector<Tape> expected(tapes_);
+  expected[1].setInputString("0110", alphabet_);
+  expected[0].move(Move::Right);
+  expected[0].move(Move::Right);
+  expected[0].move(Move::Right);
+  expected[0].move(Move::Right);
+  expected[1].move(Move::Right);
+  expected[1].move(Move::Right);
+  expected[1].move(Move::Right);
+  expected[1].move(Move::Right);
+
+  std::ostringstream os;
+  os << expected;
+  ASSERT_EQ(print(tracks), os.str());
+}
+
+TEST_F(TrackTapeTest, Grow) {
+  TrackTape tracks(tapes_, alphabet_.numIds());
+  std::vector<SymbolId> ones = ids({"1", "1"});
+
+  // Far away at both sides of the input
+  for (int i = 0; i < 1000; ++i) {
+    tracks.move(Move::Left);
+  }
+  tracks.write(tracks.key(ones.data()), ones.data());
+
+  for (int i = 0; i < 3000; ++i) {
+    tracks.move(Move::Right);
+  }
+  tracks.write(tracks.key(ones.data()), ones.data());
+
+  ASSERT_EQ(tracks.head(), 2000);
+
+  for (int i = 0; i < 2000; ++i) {
+    tracks.move(Move::Left);
+  }
+  ASSERT_EQ(tracks.peekId(0), alphabet_.id("0"));
+  ASSERT_EQ(tracks.peekId(1), Alphabet::blank_id);
+
+  std::vector<Tape> tapes(tapes_);
+  tracks.writeTo(tapes);
+  ASSERT_EQ(tapes[0].firstWritten(), -1000);
+  ASSERT_EQ(tapes[0].lastWritten(), 2000);
+  ASSERT_EQ(tapes[1].peekId(-1000), alphabet_.id("1"));
+  ASSERT_EQ(tapes[1].peekId(2000), alphabet_.id("1"));
+  ASSERT_EQ(tapes[0].peekId(1), alphabet_.id("1"));
+}
+
+TEST_F(TrackTapeTest, Span) {
+  // A single track: "0110"
+  std::vector<Tape> tape(tapes_.begin(), tapes_.begin() + 1);
+  TrackTape cells(tape, alphabet_.numIds());
+  SymbolScanner zeros(ids({"0"}));
+  SymbolScanner bits(ids({"0", "1"}));
+
+  ASSERT_EQ(cells.span(Move::Right, zeros), 1);
+  ASSERT_EQ(cells.span(Move::Right, bits), 4);
+  ASSERT_EQ(cells.span(Move::Left, bits), 1);
+
+  cells.cross(Move::Right, 4);
+  ASSERT_EQ(cells.head(), 4);
+  ASSERT_EQ(cells.peekId(0), Alphabet::blank_id);
+
+  // Back to the first cell
+  cells.move(Move::Left);
+  ASSERT_EQ(cells.span(Move::Left, bits), 4);
+  cells.cross(Move::Left, 4);
+  ASSERT_EQ(cells.head(), -1);
+
+  // Blanks up to the end of the stored cells
+  SymbolScanner blanks(ids({"."}));
+  ASSERT_EQ(cells.span(Move::Left, blanks), cells.available(Move::Left));
+
+  // The crossed cells aren't changed
+  std::vector<Tape> result(tape);
+  cells.writeTo(result);
+  ASSERT_EQ(result[0].head(), -1);
+  ASSERT_EQ(result[0].firstWritten(), 0);
+  ASSERT_EQ(result[0].lastWritten(), 3);
+  ASSERT_EQ(result[0].peekId(1), alphabet_.id("1"));
+}
+
+TEST_F(TrackTapeTest, DifferentHeads) {
+  tapes_[1].move(Move::Right);
+
+  ASSERT_THROW(TrackTape(tapes_, alphabet_.numIds()), std::runtime_error);
+}
+
+}  // namespace turing
@@ -6,55 +6,40 @@ namespace turing {
 
 class StateTest : public ::testing::Test {
 protected:
-  void SetUp() override {
-    s1_ = new State("s1");
-    s2_ = new State("s2");
-  }
-
-  void TearDown() override {
-    delete s1_;
-    delete s2_;
-  }
-
-  State* s1_;
-  State* s2_;
-};
+  void SetUp() override { alphabet_.setSymbols({"a", "c"}); }
 
-TEST_F(StateTest, Name) {
-  ASSERT_EQ(s1_->name(), "s1");
-}
+  Alphabet alphabet_;
 
-TEST_F(StateTest, EmptyNameInit) {
-  ASSERT_THROW({ State s(""); }, std::runtime_error);
-}
+  State s1_;
+};
 
 TEST_F(StateTest, isFinal) {
-  ASSERT_FALSE(s1_->isFinal());
+  ASSERT_FALSE(s1_.isFinal());
 
-  s1_->setFinal(true);
+  s1_.setFinal(true);
 
-  ASSERT_TRUE(s1_->isFinal());
+  ASSERT_TRUE(s1_.isFinal());
 }
 
 TEST_F(StateTest, getTransitions) {
-  auto transitions = s1_->transitions({"a"});
+  auto transitions = s1_.transitions({alphabet_.id("a")});
 
   ASSERT_TRUE(transitions.empty());
 }
 
 TEST_F(StateTest, addTransition) {
-  s1_->addTransition(Transition({"a"}, s2_, {"c"}, {Move::Left}));
-  s1_->addTransition(Transition({"a"}, s1_, {"c"}, {Move::Right}));
+  s1_.addTransition(Transition(alphabet_, {"a"}, 1, {"c"}, {Move::Left}));
+  s1_.addTransition(Transition(alphabet_, {"a"}, 0, {"c"}, {Move::Right}));
 
-  auto transitions = s1_->transitions({"a"});
+  auto transitions = s1_.transitions({alphabet_.id("a")});
   ASSERT_EQ(transitions.size(), 2);
 }
 
 TEST_F(StateTest, addDuplicatedTransition) {
-  s1_->addTransition(Transition({"a"}, s2_, {"c"}, {Move::Left}));
-  s1_->addTransition(Transition({"a"}, s2_, {"c"}, {Move::Left}));
+  s1_.addTransition(Transition(alphabet_, {"a"}, 1, {"c"}, {Move::Left}));
+  s1_.addTransition(Transition(alphabet_, {"a"}, 1, {"c"}, {Move::Left}));
 
-  auto transitions = s1_->transitions({"a"});
+  auto transitions = s1_.transitions({alphabet_.id("a")});
 
   // The transition won't be repeated twice
   ASSERT_EQ(transitions.size(), 1);
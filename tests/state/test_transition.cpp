@@ -8,53 +8,65 @@ namespace turing {
 class TransitionTest : public ::testing::Test {
 protected:
   void SetUp() override {
-    s1_ = new State("s1");
-    s2_ = new State("s2");
+    tape_alphabet_.setSymbols({"0", "1"});
 
-    transition_ = Transition({"0"}, s2_, {"1"}, {Move::Left});
+    transition_ = Transition(tape_alphabet_, {"0"}, s2_, {"1"}, {Move::Left});
 
-    s1_->addTransition(transition_);
-  }
-
-  void TearDown() override {
-    delete s1_;
-    delete s2_;
+    s1_.addTransition(transition_);
   }
 
+  Alphabet tape_alphabet_;
   Transition transition_;
 
-  State* s1_;
-  State* s2_;
+  State s1_;
+  const StateId s2_ = 1;
 };
 
 TEST_F(TransitionTest, InputSymbols) {
-  ASSERT_EQ(transition_.inputSymbols()[0], "0");
+  ASSERT_EQ(transition_.inputSymbols()[0], tape_alphabet_.id("0"));
 }
 
 TEST_F(TransitionTest, OutputSymbols) {
-  ASSERT_EQ(transition_.outputSymbols()[0], "1");
+  ASSERT_EQ(transition_.outputSymbols()[0], tape_alphabet_.id("1"));
 }
 
 TEST_F(TransitionTest, Moves) {
   ASSERT_EQ(transition_.moves()[0], Move::Left);
 }
 
-TEST_F(TransitionTest, NextStateName) {
-  ASSERT_EQ(transition_.nextStateName(), "s2");
+TEST_F(TransitionTest, Target) {
+  ASSERT_EQ(transition_.target(), s2_);
 }
 
 TEST_F(TransitionTest, NextState) {
   std::vector<Tape> tapes;
-  Alphabet tape_alphabet;
-  tape_alphabet.setSymbols({"0", "1"});
 
-  tapes.push_back(Tape(tape_alphabet));
-  tapes[0].setInputString("01", tape_alphabet);
+  tapes.push_back(Tape(tape_alphabet_));
+  tapes[0].setInputString("01", tape_alphabet_);
 
-  auto transition = s1_->transitions({"0"});
+  auto transition = s1_.transitions({tape_alphabet_.id("0")});
   auto next_state = transition.begin()->nextState(tapes);
 
-  ASSERT_EQ(next_state->name(), "s2");
+  ASSERT_EQ(next_state, s2_);
+
+  tapes[0].move(Move::Right);
+  ASSERT_EQ(tapes[0].peek(), "1");
+
+  // The head is on a 1 now
+  ASSERT_EQ(transition.begin()->nextState(tapes), State::no_state);
+}
+
+TEST_F(TransitionTest, NextStateName) {
+  // The next state is printed by name, or by id without the names
+  EXPECT_NE(to_string(transition_, {"s1", "s2"}).find("=> { s2,"), std::string::npos);
+  EXPECT_NE(to_string(transition_).find("=> { 1,"), std::string::npos);
+
+  EXPECT_THROW(to_string(transition_, {"s1"}), std::out_of_range);
+}
+
+TEST_F(TransitionTest, UnknownSymbol) {
+  ASSERT_THROW({ Transition(tape_alphabet_, {"2"}, s2_, {"1"}, {Move::Left}); },
+               std::runtime_error);
 }
 
 
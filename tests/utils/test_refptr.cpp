@@ -0,0 +1,58 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/refptr.hpp"
+
+namespace turing {
+
+TEST(RefPtrTest, Empty) {
+  RefPtr<int> ptr;
+
+  ASSERT_FALSE(ptr);
+  ASSERT_FALSE(ptr.unique());
+  ASSERT_EQ(ptr.get(), nullptr);
+}
+
+TEST(RefPtrTest, Unique) {
+  auto ptr = RefPtr<std::string>::make("abc");
+  ASSERT_TRUE(ptr.unique());
+  ASSERT_EQ(*ptr, "abc");
+
+  RefPtr<std::string> copy = ptr;
+  ASSERT_FALSE(ptr.unique());
+  ASSERT_EQ(copy.get(), ptr.get());
+
+  copy.reset();
+  ASSERT_TRUE(ptr.unique());
+
+  RefPtr<std::string> moved = std::move(ptr);
+  ASSERT_FALSE(ptr);
+  ASSERT_TRUE(moved.unique());
+}
+
+TEST(RefPtrTest, DroppedByOtherThreads) {
+  auto ptr = RefPtr<std::vector<int>>::make(1000, 1);
+
+  // Each thread reads its copy and drops it
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([copy = ptr]() mutable {
+      int sum = 0;
+      for (int value : *copy) {
+        sum += value;
+      }
+      EXPECT_EQ(sum, 1000);
+      copy.reset();
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_TRUE(ptr.unique());
+}
+
+}  // namespace turing
@@ -0,0 +1,50 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/threadpool.hpp"
+
+namespace turing {
+
+TEST(ThreadPoolTest, Size) {
+  ThreadPool pool(3);
+
+  ASSERT_EQ(pool.size(), 3);
+}
+
+TEST(ThreadPoolTest, Results) {
+  ThreadPool pool(4);
+
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; ++i) {
+    results.push_back(pool.submit([i] { return i * i; }));
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(results[i].get(), i * i);
+  }
+}
+
+TEST(ThreadPoolTest, Exception) {
+  ThreadPool pool(2);
+
+  auto result = pool.submit([]() -> int { throw std::runtime_error("Error"); });
+
+  ASSERT_THROW({ result.get(); }, std::runtime_error);
+}
+
+TEST(ThreadPoolTest, FinishOnDestruction) {
+  std::atomic<int> counter{0};
+
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 50; ++i) {
+      pool.submit([&counter] { ++counter; });
+    }
+  }
+
+  ASSERT_EQ(counter, 50);
+}
+
+}  // namespace turing